@@ -3,42 +3,80 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
-layout(location = 5) in ivec4 boneIds;
+// Skin stream, zero weights for static meshes
+layout(location = 5) in uvec4 boneIds;
 layout(location = 6) in vec4 weights;
 
+// Per instance, constant identity / -1 when the draw is not instanced
+layout(location = 7) in mat4 instanceModel;
+layout(location = 11) in int instanceEntityID;
+layout(location = 12) in int instancePaletteOffset;
+
 out vec2 TexCoords;
 out vec3 normalWS;
 out vec4 shadowCoord;
 out vec3 fragPos;
+flat out int vEntityID;
+
+layout(std140) uniform FrameData
+{
+    mat4  view;
+    mat4  proj;
+    mat4  mvpLS;
+    vec3  viewPos;
+    float lightIntensity;
+    vec3  lightPosition;
+    float bloomThreshold;
+    vec3  lightDirection;
+    int   useEnvMap;
+    vec3  lightColor;
+    vec3  lightPositions[4];
+    vec3  lightColors[4];
+};
+
+layout(std140) uniform ObjectData
+{
+    mat4 model;
+    int  entityID;
+    int  paletteOffset;
+};
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+const int MAX_BONE_INFLUENCE = 4;
 
-uniform mat4 mvpLS;
+// Final bone matrices of every skinned instance, four texels per matrix, see BonePaletteBuffer
+uniform samplerBuffer BonePalette;
+
+mat4 GetBoneMatrix(int index)
+{
+    int texel = index * 4;
+    return mat4(texelFetch(BonePalette, texel), texelFetch(BonePalette, texel + 1), texelFetch(BonePalette, texel + 2),
+                texelFetch(BonePalette, texel + 3));
+}
+
+// Weighted blend of the bones of this vertex, identity for static meshes and instances without a palette
+mat4 GetSkinMatrix(int palette)
+{
+    float total = weights.x + weights.y + weights.z + weights.w;
+    if (palette < 0 || total <= 0.0)
+        return mat4(1.0);
 
-const int    MAX_BONES          = 100;
-const int    MAX_BONE_INFLUENCE = 4;
-uniform mat4 boneTransform[MAX_BONES];
+    mat4 skin = mat4(0.0);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+        if (weights[i] > 0.0)
+            skin += GetBoneMatrix(palette + int(boneIds[i])) * weights[i];
+    }
+    return skin / total;
+}
 
 void main()
 {
-    vec4 bonePosition = vec4(0.0);
-    // for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
-    //     if (boneIds[i] < 0 || boneIds[i] >= MAX_BONES) {
-    //         bonePosition = vec4(aPos, 1.0);
-    //         break;
-    //     }
-
-    //     vec4 localPosition = boneTransform[boneIds[i]] * vec4(aPos, 1.0);
-    //     bonePosition += localPosition * weights[i];
-    //     vec3 localNormal = mat3(boneTransform[boneIds[i]]) * aNormal;
-    // }
-    gl_Position = proj * view * model * vec4(aPos, 1.0);
+    mat4 world  = model * instanceModel * GetSkinMatrix(instancePaletteOffset >= 0 ? instancePaletteOffset : paletteOffset);
+    gl_Position = proj * view * world * vec4(aPos, 1.0);
 
     TexCoords = aTexCoord;
-    normalWS  = transpose(inverse(mat3(model))) * aNormal;
+    normalWS  = transpose(inverse(mat3(world))) * aNormal;
 
-    fragPos     = (model * vec4(aPos, 1.0)).xyz;
-    shadowCoord = mvpLS * model * vec4(aPos, 1.0);
+    fragPos     = (world * vec4(aPos, 1.0)).xyz;
+    shadowCoord = mvpLS * world * vec4(aPos, 1.0);
+    vEntityID   = instanceEntityID >= 0 ? instanceEntityID : entityID;
 }
\ No newline at end of file
@@ -3,7 +3,48 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
-uniform mat4 model;
+// Skin stream, zero weights for static meshes
+layout(location = 5) in uvec4 boneIds;
+layout(location = 6) in vec4 weights;
+
+// Per instance, constant identity / -1 when the draw is not instanced
+layout(location = 7) in mat4 instanceModel;
+layout(location = 12) in int instancePaletteOffset;
+
+layout(std140) uniform ObjectData
+{
+    mat4 model;
+    int  entityID;
+    int  paletteOffset;
+};
+
+const int MAX_BONE_INFLUENCE = 4;
+
+// Final bone matrices of every skinned instance, four texels per matrix, see BonePaletteBuffer
+uniform samplerBuffer BonePalette;
+
+mat4 GetBoneMatrix(int index)
+{
+    int texel = index * 4;
+    return mat4(texelFetch(BonePalette, texel), texelFetch(BonePalette, texel + 1), texelFetch(BonePalette, texel + 2),
+                texelFetch(BonePalette, texel + 3));
+}
+
+// Weighted blend of the bones of this vertex, identity for static meshes and instances without a palette
+mat4 GetSkinMatrix(int palette)
+{
+    float total = weights.x + weights.y + weights.z + weights.w;
+    if (palette < 0 || total <= 0.0)
+        return mat4(1.0);
+
+    mat4 skin = mat4(0.0);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+        if (weights[i] > 0.0)
+            skin += GetBoneMatrix(palette + int(boneIds[i])) * weights[i];
+    }
+    return skin / total;
+}
+
 uniform mat4 viewLS;
 uniform mat4 projLS;
 
@@ -12,8 +53,9 @@ out vec3 normalWS;
 
 void main()
 {
-    gl_Position = projLS * viewLS * model * vec4(aPos, 1.0);
+    mat4 world  = model * instanceModel * GetSkinMatrix(instancePaletteOffset >= 0 ? instancePaletteOffset : paletteOffset);
+    gl_Position = projLS * viewLS * world * vec4(aPos, 1.0);
 
-    fragPos  = (viewLS * model * vec4(aPos, 1.0)).xyz;
-    normalWS = transpose(inverse(mat3(viewLS * model))) * aNormal;
+    fragPos  = (viewLS * world * vec4(aPos, 1.0)).xyz;
+    normalWS = transpose(inverse(mat3(viewLS * world))) * aNormal;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ in vec2 TexCoords;
 in vec3 normalWS;
 in vec4 shadowCoord;
 in vec3 fragPos;
+flat in int vEntityID;
 
 uniform sampler2D   DiffuseMap;
 uniform sampler2D   DepthMap;
@@ -15,28 +16,32 @@ uniform samplerCube IrradianceMap;
 uniform samplerCube PrefilterMap;
 uniform sampler2D   BRDF_LUT;
 
-uniform int useEnvMap = 1;
-uniform int kullaConty;
-uniform int entityID;
-
-uniform vec3  lightPosition;
-uniform vec3  lightDirection;
-uniform vec3  lightColor;
-uniform float lightIntensity;
-
-uniform float bloomThreshold;
-
-uniform vec3 lightPositions[4];
-uniform vec3 lightColors[4];
-
-uniform vec3 viewPos;
+layout(std140) uniform FrameData
+{
+    mat4  view;
+    mat4  proj;
+    mat4  mvpLS;
+    vec3  viewPos;
+    float lightIntensity;
+    vec3  lightPosition;
+    float bloomThreshold;
+    vec3  lightDirection;
+    int   useEnvMap;
+    vec3  lightColor;
+    vec3  lightPositions[4];
+    vec3  lightColors[4];
+};
 
 // material parameters
-uniform float baseF;
-uniform vec3  baseColor;
-uniform float metallic;
-uniform float roughness;
-uniform float ao;
+layout(std140) uniform MaterialData
+{
+    vec3  baseColor;
+    float baseF;
+    float metallic;
+    float roughness;
+    float ao;
+    int   kullaConty;
+};
 
 #define EPS 1e-3
 #define PI 3.141592653589793
@@ -363,6 +368,6 @@ void main()
         if (brightness > bloomThreshold)
             BrightColor = vec4(FragColor.rgb, 1.0);
 
-        EntityID = entityID;
+        EntityID = vEntityID;
     }
 }
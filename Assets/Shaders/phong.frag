@@ -11,13 +11,21 @@ in vec4 shadowCoord;
 uniform sampler2D DiffuseMap;
 uniform sampler2D DepthMap;
 
-uniform vec3  lightDirection;
-uniform vec3  lightColor;
-uniform float lightIntensity;
-
-uniform vec3 viewPos;
-
-uniform float bloomThreshold;
+layout(std140) uniform FrameData
+{
+    mat4  view;
+    mat4  proj;
+    mat4  mvpLS;
+    vec3  viewPos;
+    float lightIntensity;
+    vec3  lightPosition;
+    float bloomThreshold;
+    vec3  lightDirection;
+    int   useEnvMap;
+    vec3  lightColor;
+    vec3  lightPositions[4];
+    vec3  lightColors[4];
+};
 
 #define EPS 1e-3
 #define PI 3.141592653589793
@@ -11,14 +11,21 @@ in vec3 fragPos;
 uniform sampler2D DiffuseMap1;
 uniform sampler2D DepthMap;
 
-uniform vec3 lightDirection;
-uniform vec3 lightColor;
-uniform float lightIntensity;
-
-uniform float bloomThreshold; 
-
-
-uniform vec3 viewPos;
+layout(std140) uniform FrameData
+{
+    mat4  view;
+    mat4  proj;
+    mat4  mvpLS;
+    vec3  viewPos;
+    float lightIntensity;
+    vec3  lightPosition;
+    float bloomThreshold;
+    vec3  lightDirection;
+    int   useEnvMap;
+    vec3  lightColor;
+    vec3  lightPositions[4];
+    vec3  lightColors[4];
+};
 
 void main()
 {   
@@ -3,25 +3,48 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
+// Per instance, constant identity / -1 when the draw is not instanced
+layout(location = 7) in mat4 instanceModel;
+layout(location = 11) in int instanceEntityID;
+
 out vec2 TexCoord;
 out vec3 normalWS;
 out vec4 shadowCoord;
 out vec3 fragPos;
+flat out int vEntityID;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+layout(std140) uniform FrameData
+{
+    mat4  view;
+    mat4  proj;
+    mat4  mvpLS;
+    vec3  viewPos;
+    float lightIntensity;
+    vec3  lightPosition;
+    float bloomThreshold;
+    vec3  lightDirection;
+    int   useEnvMap;
+    vec3  lightColor;
+    vec3  lightPositions[4];
+    vec3  lightColors[4];
+};
 
-uniform mat4 mvpLS;
+layout(std140) uniform ObjectData
+{
+    mat4 model;
+    int  entityID;
+};
 
 void main()
 {
-    gl_Position = proj * view * model * vec4(aPos, 1.0);
+    mat4 world  = model * instanceModel;
+    gl_Position = proj * view * world * vec4(aPos, 1.0);
     TexCoord    = aTexCoord;
-    normalWS    = transpose(inverse(mat3(model))) * aNormal;
+    normalWS    = transpose(inverse(mat3(world))) * aNormal;
 
-    fragPos = (model * vec4(aPos, 1.0)).xyz;
+    fragPos = (world * vec4(aPos, 1.0)).xyz;
 
     // normalWS    = aNormal;
-    shadowCoord = mvpLS * model * vec4(aPos, 1.0);
+    shadowCoord = mvpLS * world * vec4(aPos, 1.0);
+    vEntityID   = instanceEntityID >= 0 ? instanceEntityID : entityID;
 }
\ No newline at end of file
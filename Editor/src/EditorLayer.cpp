@@ -1,4 +1,5 @@
 #include "EditorLayer.hpp"
+#include "Asset/AssetManager.hpp"
 #include "Scene/Scene.hpp"
 #include <filesystem>
 #include <memory>
@@ -16,5 +17,8 @@ namespace suplex {
         m_Renderer->GetScene() = std::make_shared<Scene>();
         m_SceneSerilizer->SetContext(m_Renderer->GetScene());
         m_SceneSerilizer->Deserialize(path.string());
+
+        // Assets only the previous scene used
+        AssetManager::CollectGarbage();
     }
 }  // namespace suplex
\ No newline at end of file
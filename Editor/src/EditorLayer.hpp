@@ -4,6 +4,7 @@
 #include "Panel/Panel.hpp"
 #include "Panel/SceneHirarchyPanel.hpp"
 #include "Platform/Windows/FileDialogs.hpp"
+#include "Asset/AssetManager.hpp"
 #include "Render/Config/Config.hpp"
 #include "Render/Postprocess/PostProcess.hpp"
 #include "Render/Renderer.hpp"
@@ -14,6 +15,8 @@
 #include "Render/RenderPass/RenderPass.hpp"
 #include "Render/Renderer.hpp"
 #include "Render/Texture/Texture.hpp"
+#include "Render/Texture/TextureCache.hpp"
+#include "Render/Texture/TextureStreamer.hpp"
 #include "Scene/Component/Component.hpp"
 #include "Scene/Scene.hpp"
 #include "Scene/SceneSerilizer.hpp"
@@ -203,10 +206,11 @@ namespace suplex {
                         auto wstring    = (std::wstring(path));
                         auto pathString = std::string(begin(wstring), end(wstring));
 
-                        auto model    = Model(pathString);
                         auto filename = pathString.substr(max(pathString.find_last_of('\\'), pathString.find_last_of('/')) + 1);
                         auto e        = m_Renderer->GetScene()->CreateEntity(filename);
-                        e.AddComponent<MeshRendererComponent>(model);
+                        // Imported in the background with a placeholder drawn meanwhile, then expanded into one child entity per node
+                        e.AddComponent<MeshRendererComponent>(AssetManager::GetPlaceholderModel());
+                        e.AddComponent<PendingModelComponent>(AssetManager::LoadModelAsync(pathString), pathString);
                     }
                     ImGui::EndDragDropTarget();
                 }
@@ -220,13 +224,17 @@ namespace suplex {
                     ImGuizmo::SetRect(ImGui::GetWindowPos().x, ImGui::GetWindowPos().y, w, h);
 
                     auto& transformComponent = entity.GetComponent<TransformComponent>();
-                    auto  transform          = transformComponent.GetTransform();
+                    auto  transform          = entity.GetComponent<WorldTransformComponent>().m_Matrix;
 
                     ImGuizmo::Manipulate(glm::value_ptr(camera->GetView()), glm::value_ptr(camera->GetProjection()), m_ActiveOperation,
                                          m_ActiveMode, glm::value_ptr(transform));
 
                     if (ImGuizmo::IsUsing()) {
+                        // The gizmo works in world space, the component is relative to the parent
+                        if (auto parent = entity.GetParent())
+                            transform = glm::inverse(parent.GetComponent<WorldTransformComponent>().m_Matrix) * transform;
                         transformComponent.SetTransform(transform);
+                        entity.MarkTransformDirty();
                     }
                 }
 
@@ -256,9 +264,55 @@ namespace suplex {
 
                 ImGui::Text("Frame time = %.3f ms", m_Renderer->LastFrameRenderTime());
                 ImGui::Text("Frame rate = %.3f fps", 1000.0 / m_Renderer->LastFrameRenderTime());
+                {
+                    auto& stats = m_Renderer->GetRenderStats();
+                    ImGui::Text("Draw calls = %u, instances = %u", stats.drawCalls, stats.instances);
+                    ImGui::Text("Program / Texture / VAO binds = %u / %u / %u", stats.programBinds, stats.textureSetBinds,
+                                stats.vertexArrayBinds);
+                    ImGui::Text("Skipped binds = %u", stats.skippedBinds);
+                    ImGui::Text("Culled objects = %u", stats.culledObjects);
+                    ImGui::Text("Triangles = %llu", static_cast<unsigned long long>(stats.triangles));
+                    ImGui::Text("Bone matrices = %u", stats.boneMatrices);
+
+                    auto& stateStats = m_Renderer->GetStateCacheStats();
+                    ImGui::Text("GL state calls issued / filtered = %u / %u", stateStats.issued, stateStats.filtered);
+                }
+                if (ImGui::CollapsingHeader("Assets")) {
+                    constexpr double MB = 1024.0 * 1024.0;
+
+                    size_t cpuBytes = 0, gpuBytes = 0;
+                    for (auto& asset : AssetManager::GetMemoryReport()) {
+                        ImGui::Text("%s: CPU %.2f MB, GPU %.2f MB, %ld users", asset.path.c_str(), asset.cpuBytes / MB, asset.gpuBytes / MB,
+                                    asset.handles);
+                        cpuBytes += asset.cpuBytes;
+                        gpuBytes += asset.gpuBytes;
+                    }
+                    ImGui::Text("Total: CPU %.2f MB, GPU %.2f MB", cpuBytes / MB, gpuBytes / MB);
+                    ImGui::Text("Models loading = %zu", AssetManager::GetPendingCount());
+
+                    auto& textureStats = TextureCache::GetStats();
+                    ImGui::Text("Texture cache hits / misses = %u / %u", textureStats.hits, textureStats.misses);
+                    ImGui::Text("Resident textures = %u, %.2f MB", textureStats.residentTextures, textureStats.residentBytes / MB);
+
+                    auto& streamingStats = TextureStreamer::GetStats();
+                    ImGui::Text("Streamed textures = %u, %u kept coarser by the budget", streamingStats.streamedTextures,
+                                streamingStats.trimmedTextures);
+                    ImGui::Text("Streamed mips resident / wanted = %.2f / %.2f MB", streamingStats.residentBytes / MB,
+                                streamingStats.wantedBytes / MB);
+                    ImGui::Text("Mip levels loaded / evicted = %u / %u", streamingStats.levelsLoaded, streamingStats.levelsEvicted);
+                    ImGui::SliderInt("Texture Budget (MB)", &config->textureBudgetMB, 16, 4096);
+                    if (ImGui::Button("Release Unused"))
+                        AssetManager::CollectGarbage();
+                }
                 ImGui::Checkbox("Play", &m_Play);
                 ImGui::Checkbox("Show Demo Window", &m_ShowDemoWindow);
                 ImGui::Checkbox("Vsync", &config->vsync);
+                ImGui::Checkbox("Multi-draw Indirect", &config->multiDrawIndirect);
+                ImGui::Checkbox("Level of Detail", &config->enableLod);
+                if (config->enableLod) {
+                    ImGui::SliderFloat("LOD Screen Size", &config->lodScreenSize, 16.0f, 1024.0f);
+                    ImGui::SliderInt("Shadow LOD Bias", &config->shadowLodBias, 0, MaxMeshLods - 1);
+                }
 
                 // Set Polygon Mode
                 {
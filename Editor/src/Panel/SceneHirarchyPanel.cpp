@@ -22,15 +22,11 @@ namespace suplex {
         {
             // ImGui::Begin(ICON_FA_PROJECT_DIAGRAM "  Hierarchy");
             ImGui::Begin("Hierarchy");
-            auto entities = registry.view<MeshRendererComponent, TagComponent>();
+            auto entities = registry.view<MeshRendererComponent, TagComponent, RelationshipComponent>();
             for (auto entity : entities) {
-                auto& model         = registry.get<MeshRendererComponent>(entity).m_Model;
-                auto  tag           = registry.get<TagComponent>(entity).m_Tag;
-                int   materialIndex = model->GetMaterialIndex();
-                if (ImGui::TreeNode(tag.c_str())) {
-                    m_ActiveEntity = Entity(entity, scene.get());
-                    ImGui::TreePop();
-                }
+                // Children are drawn under their parent
+                if (entities.get<RelationshipComponent>(entity).m_Parent == entt::null)
+                    DrawEntityNode(Entity(entity, scene.get()));
             }
             ImGui::End();
         }
@@ -58,15 +54,19 @@ namespace suplex {
                         auto& translate = transform.m_Translation;
                         auto& rotation  = transform.m_Rotation;
                         auto& scale     = transform.m_Scale;
+                        auto  previous  = transform;
                         widget::Vec3Control("Position", translate, 0.0f);
                         widget::Vec3Control("Rotation", rotation, 0.0f);
                         widget::Vec3Control("Scale", scale, 1.0f);
+
+                        if (translate != previous.m_Translation || rotation != previous.m_Rotation || scale != previous.m_Scale)
+                            m_ActiveEntity.MarkTransformDirty();
                     }
 
                     if (m_ActiveEntity.HasComponent<MeshRendererComponent>()) {
                         auto& model = m_ActiveEntity.GetComponent<MeshRendererComponent>();
                         if (ImGui::CollapsingHeader("Material", ImGuiTreeNodeFlags_DefaultOpen)) {
-                            int materialIndex = model.m_Model->GetMaterialIndex();
+                            int materialIndex = model.m_MaterialIndex;
 
                             auto&       shaders     = renderer->GetShadersList();
                             std::string previewName = shaders[materialIndex]->GetShaderName();
@@ -78,7 +78,7 @@ namespace suplex {
                                 for (int i = 0; i < shaders.size(); i++) {
                                     const bool is_selected = (materialIndex == i);
                                     if (ImGui::Selectable(shaders[i]->GetShaderName().data(), is_selected))
-                                        model.m_Model->SetMaterialIndex(i);
+                                        model.m_MaterialIndex = i;
                                     // Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
                                     if (is_selected) ImGui::SetItemDefaultFocus();
                                 }
@@ -92,6 +92,24 @@ namespace suplex {
         }
     }
 
+    void SceneHirarchyPanel::DrawEntityNode(Entity entity)
+    {
+        auto& tag          = entity.GetComponent<TagComponent>().m_Tag;
+        auto& relationship = entity.GetComponent<RelationshipComponent>();
+
+        ImGui::PushID(static_cast<int>(entity.GetID()));
+        if (ImGui::TreeNode(tag.c_str())) {
+            m_ActiveEntity = entity;
+            for (auto child = relationship.m_FirstChild; child != entt::null;) {
+                Entity childEntity(child, m_Context->renderer->GetScene().get());
+                child = childEntity.GetComponent<RelationshipComponent>().m_NextSibling;
+                DrawEntityNode(childEntity);
+            }
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
+    }
+
     void SceneHirarchyPanel::OnEvent() {}
 
 }  // namespace suplex
\ No newline at end of file
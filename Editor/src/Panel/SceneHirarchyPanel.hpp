@@ -21,5 +21,8 @@ namespace suplex {
         Entity GetSelectedEntity() { return m_ActiveEntity; }
 
         Entity m_ActiveEntity{};
+
+    private:
+        void DrawEntityNode(Entity entity);
     };
 }  // namespace suplex
\ No newline at end of file
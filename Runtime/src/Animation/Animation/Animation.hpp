@@ -1,51 +1,82 @@
 #pragma once
 #include <Animation/Bone/Bone.hpp>
+#include <Animation/Compression/ClipCompression.hpp>
+#include <Animation/Skeleton/Skeleton.hpp>
+#include <unordered_map>
+#include <utility>
 
 namespace suplex {
-    struct AssimpNodeData
-    {
-        glm::mat4                   transformation;
-        std::string                 name;
-        int                         childrenCount;
-        std::vector<AssimpNodeData> children;
-    };
-
     class Animation {
     public:
         Animation() = default;
 
-        Animation(const std::string& animationPath, Model* model)
+        Animation(const std::string& animationPath, Model* model, const ClipCompressionSettings& compression = {})
         {
             Assimp::Importer importer;
             const aiScene*   scene = importer.ReadFile(animationPath, aiProcess_Triangulate);
             assert(scene && scene->mRootNode);
-            auto animation   = scene->mAnimations[0];
-            m_Duration       = animation->mDuration;
-            m_TicksPerSecond = animation->mTicksPerSecond;
-            ReadHeirarchyData(m_RootNode, scene->mRootNode);
-            ReadMissingBones(animation, *model);
+            Load(scene->mAnimations[0], scene->mRootNode, *model, compression);
+        }
+
+        // From an animation and node hierarchy already in memory, e.g. built procedurally.
+        Animation(const aiAnimation* animation, const aiNode* rootNode, Model& model, const ClipCompressionSettings& compression = {})
+        {
+            Load(animation, rootNode, model, compression);
         }
 
         ~Animation() {}
 
         Bone* FindBone(const std::string& name)
         {
-            auto iter = std::find_if(m_Bones.begin(), m_Bones.end(), [&](const Bone& Bone) { return Bone.GetBoneName() == name; });
-            if (iter == m_Bones.end())
-                return nullptr;
-            else
-                return &(*iter);
+            auto iter = m_ChannelLookup.find(name);
+            return iter != m_ChannelLookup.end() ? &m_Bones[iter->second] : nullptr;
         }
 
-        inline float GetTicksPerSecond() { return m_TicksPerSecond; }
+        inline float GetTicksPerSecond() const { return m_TicksPerSecond; }
+
+        inline float GetDuration() const { return m_Duration; }
+
+        inline const Skeleton& GetSkeleton() const { return m_Skeleton; }
+
+        inline const std::vector<Bone>& GetBones() const { return m_Bones; }
+
+        // Local transform of a channel at time. The cursor is only used while the clip is kept uncompressed.
+        glm::mat4 SampleChannel(int32_t channel, float time, BoneCursor& cursor) const
+        {
+            if (!m_Clip.IsEmpty())
+                return m_Clip.Sample(channel, time);
+            return m_Bones[channel].Sample(time, cursor);
+        }
 
-        inline float GetDuration() { return m_Duration; }
+        // Zero unless the clip was compressed on load.
+        inline const ClipCompressionStats& GetCompressionStats() const { return m_CompressionStats; }
 
-        inline const AssimpNodeData& GetRootNode() { return m_RootNode; }
+        // One past the largest bone id of the skeleton, the size the final bone matrices need.
+        inline int GetBoneCount() const { return m_BoneCount; }
 
         inline const std::map<std::string, BoneInfo>& GetBoneIDMap() { return m_BoneInfoMap; }
 
     private:
+        void Load(const aiAnimation* animation, const aiNode* rootNode, Model& model, const ClipCompressionSettings& compression)
+        {
+            m_Duration       = animation->mDuration;
+            m_TicksPerSecond = animation->mTicksPerSecond;
+            ReadMissingBones(animation, model);
+            ReadHierarchyData(rootNode);
+
+            if (compression.enabled) {
+                auto& stats = m_CompressionStats;
+                m_Clip      = CompressedClip::Compress(m_Bones, m_Duration, compression, stats);
+                for (auto& bone : m_Bones)
+                    bone.ReleaseKeys();
+
+                spdlog::info("Compressed animation {}: {} -> {} bytes ({:.1f}x), max error position {:.5f}, rotation {:.4f} deg, "
+                             "scale {:.5f}",
+                             animation->mName.C_Str(), stats.rawBytes, stats.compressedBytes, stats.GetRatio(), stats.maxPositionError,
+                             glm::degrees(stats.maxRotationError), stats.maxScaleError);
+            }
+        }
+
         void ReadMissingBones(const aiAnimation* animation, Model& model)
         {
             int size = animation->mNumChannels;
@@ -62,30 +93,50 @@ namespace suplex {
                     boneInfoMap[boneName].id = boneCount;
                     boneCount++;
                 }
+                m_ChannelLookup.try_emplace(boneName, static_cast<int32_t>(m_Bones.size()));
                 m_Bones.push_back(Bone(channel->mNodeName.data, boneInfoMap[channel->mNodeName.data].id, channel));
             }
 
             m_BoneInfoMap = boneInfoMap;
         }
 
-        void ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src)
+        // Flattens the node tree depth first and resolves every name to its channel and bone slot once
+        void ReadHierarchyData(const aiNode* root)
         {
-            assert(src);
-
-            dest.name           = src->mName.data;
-            dest.transformation = utils::ConvertMatrixToGLMFormat(src->mTransformation);
-            dest.childrenCount  = src->mNumChildren;
+            assert(root);
+
+            m_Skeleton  = Skeleton();
+            m_BoneCount = 0;
+            for (auto& [name, info] : m_BoneInfoMap)
+                m_BoneCount = std::max(m_BoneCount, info.id + 1);
+
+            std::vector<std::pair<const aiNode*, int32_t>> stack = {{root, -1}};
+            while (!stack.empty()) {
+                auto [node, parent] = stack.back();
+                stack.pop_back();
+
+                auto index = m_Skeleton.AddNode(node->mName.data, parent, utils::ConvertMatrixToGLMFormat(node->mTransformation));
+                if (auto channel = m_ChannelLookup.find(node->mName.data); channel != m_ChannelLookup.end())
+                    m_Skeleton.channels[index] = channel->second;
+                if (auto bone = m_BoneInfoMap.find(node->mName.data); bone != m_BoneInfoMap.end()) {
+                    m_Skeleton.boneIDs[index] = bone->second.id;
+                    m_Skeleton.offsets[index] = bone->second.offset;
+                }
 
-            for (int i = 0; i < src->mNumChildren; i++) {
-                AssimpNodeData newData;
-                ReadHeirarchyData(newData, src->mChildren[i]);
-                dest.children.push_back(newData);
+                // Reversed, so children come out of the stack in file order
+                for (int i = static_cast<int>(node->mNumChildren) - 1; i >= 0; --i)
+                    stack.emplace_back(node->mChildren[i], index);
             }
         }
-        float                           m_Duration;
-        int                             m_TicksPerSecond;
-        std::vector<Bone>               m_Bones;
-        AssimpNodeData                  m_RootNode;
-        std::map<std::string, BoneInfo> m_BoneInfoMap;
+
+        float                                    m_Duration;
+        int                                      m_TicksPerSecond;
+        int                                      m_BoneCount = 0;
+        std::vector<Bone>                        m_Bones;
+        std::unordered_map<std::string, int32_t> m_ChannelLookup;  // node name to index in m_Bones
+        Skeleton                                 m_Skeleton;
+        CompressedClip                           m_Clip;  // empty if compression was disabled, the Bones keep their keys then
+        ClipCompressionStats                     m_CompressionStats;
+        std::map<std::string, BoneInfo>          m_BoneInfoMap;
     };
-}  // namespace suplex
\ No newline at end of file
+}  // namespace suplex
@@ -0,0 +1,97 @@
+#include "Animation/AnimationSystem/AnimationSystem.hpp"
+#include "Animation/Animator/Animator.hpp"
+#include "Scene/Component/Component.hpp"
+#include "Thread/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <entt/entt.hpp>
+
+namespace suplex {
+
+    void AnimationSystem::Update(entt::registry& registry, float dt)
+    {
+        auto view = registry.view<AnimatorComponent>();
+
+        // Switching animation changes the storage of that entity, cheap to check and rare. Animators without a layout slot
+        // were added empty and got their animation afterwards, those are not in m_Instances yet
+        if (!m_LayoutChanged) {
+            for (auto& instance : m_Instances) {
+                if (view.get<AnimatorComponent>(instance.entity).m_Animation.get() != instance.animation) {
+                    m_LayoutChanged = true;
+                    break;
+                }
+            }
+        }
+        if (!m_LayoutChanged) {
+            for (auto entity : view) {
+                auto& animator = view.get<AnimatorComponent>(entity);
+                if (animator.m_Animation && animator.m_PaletteOffset < 0) {
+                    m_LayoutChanged = true;
+                    break;
+                }
+            }
+        }
+        if (m_LayoutChanged)
+            RebuildLayout(registry);
+
+        // Every entity writes its own ranges of the arrays, the back palette becomes the front one afterwards
+        constexpr size_t EntitiesPerTask = 8;
+
+        auto& palette = m_Palettes[m_Front ^ 1];
+        ThreadPool::ParallelFor(m_Instances.size(), EntitiesPerTask, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto& instance  = m_Instances[i];
+                auto& animator  = view.get<AnimatorComponent>(instance.entity);
+                auto& animation = *instance.animation;
+
+                float duration = animation.GetDuration();
+                if (animator.m_Playing && duration > 0.0f) {
+                    animator.m_Time = std::fmod(animator.m_Time + animation.GetTicksPerSecond() * animator.m_Speed * dt, duration);
+                    if (animator.m_Time < 0.0f)
+                        animator.m_Time += duration;
+                }
+
+                auto& skeleton = animation.GetSkeleton();
+                Animator::Evaluate(animation,
+                                   animator.m_Time,
+                                   std::span(m_Cursors).subspan(instance.cursorOffset, animation.GetBones().size()),
+                                   std::span(m_Globals).subspan(instance.nodeOffset, skeleton.GetSize()),
+                                   std::span(palette).subspan(instance.paletteOffset, animation.GetBoneCount()));
+            }
+        });
+        m_Front ^= 1;
+    }
+
+    void AnimationSystem::RebuildLayout(entt::registry& registry)
+    {
+        m_Instances.clear();
+        auto view = registry.view<AnimatorComponent>();
+        for (auto entity : view) {
+            auto& animator           = view.get<AnimatorComponent>(entity);
+            animator.m_PaletteOffset = -1;
+            if (animator.m_Animation)
+                m_Instances.push_back({entity, animator.m_Animation.get(), 0, 0, 0});
+        }
+        std::sort(m_Instances.begin(), m_Instances.end(), [](const Instance& a, const Instance& b) { return a.animation < b.animation; });
+
+        uint32_t paletteSize = 0, cursorCount = 0, nodeCount = 0;
+        for (auto& instance : m_Instances) {
+            instance.paletteOffset = paletteSize;
+            instance.cursorOffset  = cursorCount;
+            instance.nodeOffset    = nodeCount;
+            paletteSize += instance.animation->GetBoneCount();
+            cursorCount += static_cast<uint32_t>(instance.animation->GetBones().size());
+            nodeCount += static_cast<uint32_t>(instance.animation->GetSkeleton().GetSize());
+
+            view.get<AnimatorComponent>(instance.entity).m_PaletteOffset = static_cast<int32_t>(instance.paletteOffset);
+        }
+
+        // Bones the skeleton never reaches keep the identity
+        m_Cursors.assign(cursorCount, BoneCursor());
+        m_Globals.assign(nodeCount, glm::mat4(1.0f));
+        for (auto& palette : m_Palettes)
+            palette.assign(paletteSize, glm::mat4(1.0f));
+        m_LayoutChanged = false;
+    }
+
+}  // namespace suplex
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Animation/Animation/Animation.hpp"
+#include <entt/entity/fwd.hpp>
+#include <glm/glm.hpp>
+#include <span>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Advances every AnimatorComponent and evaluates its skeleton, spread over the ThreadPool. The final bone matrices of
+    // all entities live in one contiguous palette that is double buffered: Update writes one copy while the other, from
+    // the previous frame, stays untouched for the renderer. Storage is only rebuilt when animators are added, removed or
+    // switch animation, so steady frames allocate nothing, ThreadPool::ParallelFor included.
+    class AnimationSystem {
+    public:
+        void Update(entt::registry& registry, float dt);
+
+        // Call when an AnimatorComponent is added or removed, see Scene. Assigning or switching m_Animation afterwards is
+        // picked up by Update on its own.
+        void Invalidate() { m_LayoutChanged = true; }
+
+        // Written by the last Update, AnimatorComponent::m_PaletteOffset + bone ID for each entity.
+        std::span<const glm::mat4> GetPalette() const { return m_Palettes[m_Front]; }
+        uint32_t                   GetInstanceCount() const { return static_cast<uint32_t>(m_Instances.size()); }
+
+    private:
+        void RebuildLayout(entt::registry& registry);
+
+    private:
+        // Offsets into the shared arrays, instances that play the same animation are kept next to each other
+        struct Instance
+        {
+            entt::entity     entity;
+            const Animation* animation;
+            uint32_t         paletteOffset;
+            uint32_t         cursorOffset;  // one BoneCursor per Bone of the animation
+            uint32_t         nodeOffset;    // one global transform per skeleton node
+        };
+
+        bool                    m_LayoutChanged = true;
+        std::vector<Instance>   m_Instances;
+        std::vector<BoneCursor> m_Cursors;
+        std::vector<glm::mat4>  m_Globals;
+        std::vector<glm::mat4>  m_Palettes[2];
+        uint32_t                m_Front = 0;
+    };
+
+}  // namespace suplex
@@ -1,20 +1,17 @@
 #pragma once
 
 #include <Animation/Animation/Animation.hpp>
+#include <algorithm>
 #include <memory>
+#include <span>
 
 namespace suplex {
     class Animator {
     public:
-        Animator(const std::shared_ptr<Animation> animation)
-        {
-            m_CurrentTime      = 0.0f;
-            m_CurrentAnimation = animation;
+        // Least number of final bone matrices, bigger skeletons grow them
+        static constexpr int MaxBones = 100;
 
-            m_FinalBoneMatrices.reserve(100);
-
-            for (int i = 0; i < 100; i++) m_FinalBoneMatrices.push_back(glm::mat4(1.0f));
-        }
+        Animator(const std::shared_ptr<Animation> animation) { PlayAnimation(animation); }
 
         void UpdateAnimation(float dt)
         {
@@ -22,47 +19,58 @@ namespace suplex {
             if (m_CurrentAnimation) {
                 m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
                 m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
-                CalculateBoneTransform(std::make_shared<AssimpNodeData>(&m_CurrentAnimation->GetRootNode()), glm::mat4(1.0f));
+                CalculateBoneTransforms();
             }
         }
 
+        // All per-skeleton storage is sized here, updates do not allocate
         void PlayAnimation(std::shared_ptr<Animation> animation)
         {
             m_CurrentAnimation = animation;
             m_CurrentTime      = 0.0f;
+
+            int boneCount = animation ? std::max(MaxBones, animation->GetBoneCount()) : MaxBones;
+            m_FinalBoneMatrices.assign(boneCount, glm::mat4(1.0f));
+            m_GlobalTransforms.assign(animation ? animation->GetSkeleton().GetSize() : 0, glm::mat4(1.0f));
+            m_Cursors.assign(animation ? animation->GetBones().size() : 0, BoneCursor());
         }
 
-        void CalculateBoneTransform(const std::shared_ptr<AssimpNodeData> node, glm::mat4 parentTransform)
+        void CalculateBoneTransforms()
         {
-            std::string nodeName      = node->name;
-            glm::mat4   nodeTransform = node->transformation;
-
-            Bone* Bone = m_CurrentAnimation->FindBone(nodeName);
+            Evaluate(*m_CurrentAnimation, m_CurrentTime, m_Cursors, m_GlobalTransforms, m_FinalBoneMatrices);
+        }
 
-            if (Bone) {
-                Bone->Update(m_CurrentTime);
-                nodeTransform = Bone->GetLocalTransform();
-            }
+        // Final bone matrices of animation at time, shared with AnimationSystem. One pass in hierarchy order, each parent's
+        // global transform is ready before its children need it. cursors and globals hold one entry per Bone and per
+        // skeleton node, palette at least GetBoneCount() matrices.
+        static void Evaluate(const Animation&      animation,
+                             float                 time,
+                             std::span<BoneCursor> cursors,
+                             std::span<glm::mat4>  globals,
+                             std::span<glm::mat4>  palette)
+        {
+            auto& skeleton = animation.GetSkeleton();
+            for (size_t i = 0; i < skeleton.GetSize(); ++i) {
+                glm::mat4 nodeTransform = skeleton.transforms[i];
+                if (auto channel = skeleton.channels[i]; channel >= 0)
+                    nodeTransform = animation.SampleChannel(channel, time, cursors[channel]);
 
-            glm::mat4 globalTransformation = parentTransform * nodeTransform;
+                auto parent = skeleton.parents[i];
+                globals[i]  = parent >= 0 ? globals[parent] * nodeTransform : nodeTransform;
 
-            auto boneInfoMap = m_CurrentAnimation->GetBoneIDMap();
-            if (boneInfoMap.find(nodeName) != boneInfoMap.end()) {
-                int       index            = boneInfoMap[nodeName].id;
-                glm::mat4 offset           = boneInfoMap[nodeName].offset;
-                m_FinalBoneMatrices[index] = globalTransformation * offset;
+                if (auto boneID = skeleton.boneIDs[i]; boneID >= 0)
+                    palette[boneID] = globals[i] * skeleton.offsets[i];
             }
-
-            for (int i = 0; i < node->childrenCount; i++)
-                CalculateBoneTransform(std::make_shared<AssimpNodeData>(&node->children[i]), globalTransformation);
         }
 
-        std::vector<glm::mat4> GetFinalBoneMatrices() { return m_FinalBoneMatrices; }
+        const std::vector<glm::mat4>& GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
 
     private:
         std::vector<glm::mat4>     m_FinalBoneMatrices;
+        std::vector<glm::mat4>     m_GlobalTransforms;  // per skeleton node, scratch of CalculateBoneTransforms
+        std::vector<BoneCursor>    m_Cursors;           // per Bone of the animation, where this instance last sampled it
         std::shared_ptr<Animation> m_CurrentAnimation;
-        float                      m_CurrentTime;
-        float                      m_DeltaTime;
+        float                      m_CurrentTime = 0.0f;
+        float                      m_DeltaTime   = 0.0f;
     };
-}  // namespace suplex
\ No newline at end of file
+}  // namespace suplex
@@ -1,8 +1,11 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <stdint.h>
+#include <type_traits>
 #include <Render/Geometry/Model.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -10,173 +13,136 @@
 
 namespace suplex {
 
-    struct KeyPosition
+    // Keys of one channel component, times and values in separate contiguous arrays.
+    template <class T>
+    struct KeyTrack
     {
-        glm::vec3 position;
-        float     timeStamp;
-    };
+        std::vector<float> times;
+        std::vector<T>     values;
 
-    struct KeyRotation
-    {
-        glm::quat orientation;
-        float     timeStamp;
+        // Key to interpolate from at time, stored in cursor for the next call. Playback moving forward steps the cursor
+        // a few keys at most, anything else (a seek, the wrap of a loop) falls back to a binary search. Times outside
+        // the track clamp to its first or last key.
+        uint32_t Seek(float time, uint32_t& cursor) const
+        {
+            constexpr uint32_t MaxSteps = 4;
+
+            uint32_t last = static_cast<uint32_t>(times.size()) - 2;
+            uint32_t key  = std::min(cursor, last);
+            if (time >= times[key]) {
+                for (uint32_t step = 0; step < MaxSteps && key < last && time >= times[key + 1]; ++step)
+                    ++key;
+                if (key < last && time >= times[key + 1])
+                    key = Search(time);
+            }
+            else {
+                key = Search(time);
+            }
+            return cursor = key;
+        }
+
+        T Sample(float time, uint32_t& cursor) const
+        {
+            if (values.size() == 1)
+                return values[0];
+
+            auto  key    = Seek(time, cursor);
+            float length = times[key + 1] - times[key];
+            float factor = length > 0.0f ? std::clamp((time - times[key]) / length, 0.0f, 1.0f) : 0.0f;
+            if constexpr (std::is_same_v<T, glm::quat>)
+                return glm::normalize(glm::slerp(values[key], values[key + 1], factor));
+            else
+                return glm::mix(values[key], values[key + 1], factor);
+        }
+
+    private:
+        uint32_t Search(float time) const
+        {
+            auto next = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+            return static_cast<uint32_t>(std::clamp<ptrdiff_t>(next - 1, 0, static_cast<ptrdiff_t>(times.size()) - 2));
+        }
     };
 
-    struct KeyScale
+    // translation * rotation * scale, without the matrix products.
+    inline glm::mat4 ComposeBoneTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        glm::mat4 transform = glm::toMat4(rotation);
+        transform[0] *= scale.x;
+        transform[1] *= scale.y;
+        transform[2] *= scale.z;
+        transform[3] = glm::vec4(position, 1.0f);
+        return transform;
+    }
+
+    // Playback position of one instance in the tracks of a Bone, see Animator.
+    struct BoneCursor
     {
-        glm::vec3 scale;
-        float     timeStamp;
+        uint32_t position = 0;
+        uint32_t rotation = 0;
+        uint32_t scale    = 0;
     };
 
+    // Keyframes of one animated node. Immutable after loading, so every Animator playing the clip can sample it.
     class Bone {
     private:
-        std::vector<KeyPosition> m_Positions;
-        std::vector<KeyRotation> m_Rotations;
-        std::vector<KeyScale>    m_Scales;
-        int                      m_NumPositions;
-        int                      m_NumRotations;
-        int                      m_NumScalings;
-
-        glm::mat4   m_LocalTransform;
+        KeyTrack<glm::vec3> m_Positions;
+        KeyTrack<glm::quat> m_Rotations;
+        KeyTrack<glm::vec3> m_Scales;
+
         std::string m_Name;
         int         m_ID;
 
     public:
         /*reads keyframes from aiNodeAnim*/
-        Bone(const std::string& name, int ID, const aiNodeAnim* channel) : m_Name(name), m_ID(ID), m_LocalTransform(1.0f)
+        Bone(const std::string& name, int ID, const aiNodeAnim* channel) : m_Name(name), m_ID(ID)
         {
-            m_NumPositions = channel->mNumPositionKeys;
-
-            for (int positionIndex = 0; positionIndex < m_NumPositions; ++positionIndex) {
-                aiVector3D  aiPosition = channel->mPositionKeys[positionIndex].mValue;
-                float       timeStamp  = channel->mPositionKeys[positionIndex].mTime;
-                KeyPosition data;
-                data.position  = utils::GetGLMVec(aiPosition);
-                data.timeStamp = timeStamp;
-                m_Positions.push_back(data);
+            for (unsigned int i = 0; i < channel->mNumPositionKeys; ++i) {
+                m_Positions.times.push_back(static_cast<float>(channel->mPositionKeys[i].mTime));
+                m_Positions.values.push_back(utils::GetGLMVec(channel->mPositionKeys[i].mValue));
             }
 
-            m_NumRotations = channel->mNumRotationKeys;
-            for (int rotationIndex = 0; rotationIndex < m_NumRotations; ++rotationIndex) {
-                aiQuaternion aiOrientation = channel->mRotationKeys[rotationIndex].mValue;
-                float        timeStamp     = channel->mRotationKeys[rotationIndex].mTime;
-                KeyRotation  data;
-                data.orientation = utils::GetGLMQuat(aiOrientation);
-                data.timeStamp   = timeStamp;
-                m_Rotations.push_back(data);
+            for (unsigned int i = 0; i < channel->mNumRotationKeys; ++i) {
+                m_Rotations.times.push_back(static_cast<float>(channel->mRotationKeys[i].mTime));
+                m_Rotations.values.push_back(utils::GetGLMQuat(channel->mRotationKeys[i].mValue));
             }
 
-            m_NumScalings = channel->mNumScalingKeys;
-            for (int keyIndex = 0; keyIndex < m_NumScalings; ++keyIndex) {
-                aiVector3D scale     = channel->mScalingKeys[keyIndex].mValue;
-                float      timeStamp = channel->mScalingKeys[keyIndex].mTime;
-                KeyScale   data;
-                data.scale     = utils::GetGLMVec(scale);
-                data.timeStamp = timeStamp;
-                m_Scales.push_back(data);
+            for (unsigned int i = 0; i < channel->mNumScalingKeys; ++i) {
+                m_Scales.times.push_back(static_cast<float>(channel->mScalingKeys[i].mTime));
+                m_Scales.values.push_back(utils::GetGLMVec(channel->mScalingKeys[i].mValue));
             }
-        }
 
-        /*interpolates  b/w positions,rotations & scaling keys based on the curren time of 
-    the animation and prepares the local transformation matrix by combining all keys 
-    tranformations*/
-        void Update(float animationTime)
-        {
-            glm::mat4 translation = InterpolatePosition(animationTime);
-            glm::mat4 rotation    = InterpolateRotation(animationTime);
-            glm::mat4 scale       = InterpolateScaling(animationTime);
-            m_LocalTransform      = translation * rotation * scale;
+            // Channels without keys for a component keep it at identity
+            if (m_Positions.values.empty())
+                m_Positions = {{0.0f}, {glm::vec3(0.0f)}};
+            if (m_Rotations.values.empty())
+                m_Rotations = {{0.0f}, {glm::quat(1.0f, 0.0f, 0.0f, 0.0f)}};
+            if (m_Scales.values.empty())
+                m_Scales = {{0.0f}, {glm::vec3(1.0f)}};
         }
 
-        glm::mat4   GetLocalTransform() { return m_LocalTransform; }
-        std::string GetBoneName() const { return m_Name; }
-        int         GetBoneID() { return m_ID; }
-
-        /* Gets the current index on mKeyPositions to interpolate to based on 
-    the current animation time*/
-        int GetPositionIndex(float animationTime)
+        /*interpolates b/w positions, rotations & scaling keys at the given animation time and returns the local
+    transformation, translation * rotation * scale*/
+        glm::mat4 Sample(float animationTime, BoneCursor& cursor) const
         {
-            for (int index = 0; index < m_NumPositions - 1; ++index) {
-                if (animationTime < m_Positions[index + 1].timeStamp) return index;
-            }
-            assert(0);
-            return -1;
+            auto position = m_Positions.Sample(animationTime, cursor.position);
+            auto rotation = m_Rotations.Sample(animationTime, cursor.rotation);
+            auto scale    = m_Scales.Sample(animationTime, cursor.scale);
+            return ComposeBoneTransform(position, rotation, scale);
         }
 
-        /* Gets the current index on mKeyRotations to interpolate to based on the 
-    current animation time*/
-        int GetRotationIndex(float animationTime)
+        // Drops the keys once a CompressedClip samples the channel instead.
+        void ReleaseKeys()
         {
-            for (int index = 0; index < m_NumRotations - 1; ++index) {
-                if (animationTime < m_Rotations[index + 1].timeStamp) return index;
-            }
-            assert(0);
-            return -1;
+            m_Positions = {};
+            m_Rotations = {};
+            m_Scales    = {};
         }
 
-        /* Gets the current index on mKeyScalings to interpolate to based on the 
-    current animation time */
-        int GetScaleIndex(float animationTime)
-        {
-            for (int index = 0; index < m_NumScalings - 1; ++index) {
-                if (animationTime < m_Scales[index + 1].timeStamp) return index;
-            }
-            assert(0);
-            return -1;
-        }
-
-    private:
-        /* Gets normalized value for Lerp & Slerp*/
-        float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
-        {
-            float scaleFactor  = 0.0f;
-            float midWayLength = animationTime - lastTimeStamp;
-            float framesDiff   = nextTimeStamp - lastTimeStamp;
-            scaleFactor        = midWayLength / framesDiff;
-            return scaleFactor;
-        }
-
-        /*figures out which position keys to interpolate b/w and performs the interpolation 
-    and returns the translation matrix*/
-        glm::mat4 InterpolatePosition(float animationTime)
-        {
-            if (1 == m_NumPositions) return glm::translate(glm::mat4(1.0f), m_Positions[0].position);
-
-            int       p0Index       = GetPositionIndex(animationTime);
-            int       p1Index       = p0Index + 1;
-            float     scaleFactor   = GetScaleFactor(m_Positions[p0Index].timeStamp, m_Positions[p1Index].timeStamp, animationTime);
-            glm::vec3 finalPosition = glm::mix(m_Positions[p0Index].position, m_Positions[p1Index].position, scaleFactor);
-            return glm::translate(glm::mat4(1.0f), finalPosition);
-        }
+        const auto& GetPositionKeys() const { return m_Positions; }
+        const auto& GetRotationKeys() const { return m_Rotations; }
+        const auto& GetScaleKeys() const { return m_Scales; }
 
-        /*figures out which rotations keys to interpolate b/w and performs the interpolation 
-    and returns the rotation matrix*/
-        glm::mat4 InterpolateRotation(float animationTime)
-        {
-            if (1 == m_NumRotations) {
-                auto rotation = glm::normalize(m_Rotations[0].orientation);
-                return glm::toMat4(rotation);
-            }
-
-            int       p0Index       = GetRotationIndex(animationTime);
-            int       p1Index       = p0Index + 1;
-            float     scaleFactor   = GetScaleFactor(m_Rotations[p0Index].timeStamp, m_Rotations[p1Index].timeStamp, animationTime);
-            glm::quat finalRotation = glm::slerp(m_Rotations[p0Index].orientation, m_Rotations[p1Index].orientation, scaleFactor);
-            finalRotation           = glm::normalize(finalRotation);
-            return glm::toMat4(finalRotation);
-        }
-
-        /*figures out which scaling keys to interpolate b/w and performs the interpolation 
-    and returns the scale matrix*/
-        glm::mat4 InterpolateScaling(float animationTime)
-        {
-            if (1 == m_NumScalings) return glm::scale(glm::mat4(1.0f), m_Scales[0].scale);
-
-            int       p0Index     = GetScaleIndex(animationTime);
-            int       p1Index     = p0Index + 1;
-            float     scaleFactor = GetScaleFactor(m_Scales[p0Index].timeStamp, m_Scales[p1Index].timeStamp, animationTime);
-            glm::vec3 finalScale  = glm::mix(m_Scales[p0Index].scale, m_Scales[p1Index].scale, scaleFactor);
-            return glm::scale(glm::mat4(1.0f), finalScale);
-        }
+        std::string GetBoneName() const { return m_Name; }
+        int         GetBoneID() { return m_ID; }
     };
-}  // namespace suplex
\ No newline at end of file
+}  // namespace suplex
@@ -0,0 +1,269 @@
+#include "Animation/Compression/ClipCompression.hpp"
+#include "Animation/Bone/Bone.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace suplex {
+
+    namespace {
+        constexpr float Sqrt2 = 1.41421356f;
+
+        // 15 bits per smallest-three component, 16 per range quantized vector component
+        constexpr float RotationSteps = 32767.0f;
+        constexpr float VectorSteps   = 65535.0f;
+
+        // Words per sample, for every kind of track
+        constexpr uint32_t SampleWords = 3;
+
+        // The largest component is dropped and rebuilt from the unit length, so it is made positive first. The other
+        // three lie in [-1/sqrt2, 1/sqrt2]. Layout, most significant first: | index (2) | 3 x 15 bits | unused (1) |
+        void PackRotation(const glm::quat& rotation, uint16_t* words)
+        {
+            float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+            int   largest       = 0;
+            for (int i = 1; i < 4; ++i) {
+                if (std::abs(components[i]) > std::abs(components[largest]))
+                    largest = i;
+            }
+
+            float    sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+            uint64_t bits = static_cast<uint64_t>(largest);
+            for (int i = 0; i < 4; ++i) {
+                if (i == largest)
+                    continue;
+                float value = std::clamp(components[i] * sign * Sqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+                bits        = bits << 15 | static_cast<uint64_t>(std::lround(value * RotationSteps));
+            }
+            bits <<= 1;
+
+            words[0] = static_cast<uint16_t>(bits >> 32);
+            words[1] = static_cast<uint16_t>(bits >> 16);
+            words[2] = static_cast<uint16_t>(bits);
+        }
+
+        glm::quat UnpackRotation(const uint16_t* words)
+        {
+            uint64_t bits    = (uint64_t(words[0]) << 32 | uint64_t(words[1]) << 16 | words[2]) >> 1;
+            int      largest = static_cast<int>(bits >> 45);
+
+            float components[4];
+            float sum = 0.0f;
+            for (int i = 0, shift = 30; i < 4; ++i) {
+                if (i == largest)
+                    continue;
+                float value   = static_cast<float>((bits >> shift) & 0x7FFF) / RotationSteps;
+                components[i] = (value * 2.0f - 1.0f) / Sqrt2;
+                sum += components[i] * components[i];
+                shift -= 15;
+            }
+            components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+            return glm::quat(components[3], components[0], components[1], components[2]);
+        }
+
+        void PackVector(const glm::vec3& vector, const CompressedTrack& track, uint16_t* words)
+        {
+            for (int c = 0; c < 3; ++c) {
+                float value = track.extent[c] > 0.0f ? std::clamp((vector[c] - track.min[c]) / track.extent[c], 0.0f, 1.0f) : 0.0f;
+                words[c]    = static_cast<uint16_t>(std::lround(value * VectorSteps));
+            }
+        }
+
+        glm::vec3 UnpackVector(const uint16_t* words, const CompressedTrack& track)
+        {
+            glm::vec3 vector;
+            for (int c = 0; c < 3; ++c)
+                vector[c] = track.min[c] + track.extent[c] * (static_cast<float>(words[c]) / VectorSteps);
+            return vector;
+        }
+
+        // Sample to interpolate from and the factor towards the next one
+        float GetSegment(const CompressedTrack& track, float duration, float time, uint32_t& sample)
+        {
+            sample = 0;
+            if (track.count < 2 || duration <= 0.0f)
+                return 0.0f;
+
+            float frame = std::clamp(time / duration, 0.0f, 1.0f) * static_cast<float>(track.count - 1);
+            sample      = std::min(static_cast<uint32_t>(frame), track.count - 2);
+            return frame - static_cast<float>(sample);
+        }
+
+        glm::vec3 SampleVectorTrack(const uint16_t* words, const CompressedTrack& track, float duration, float time)
+        {
+            uint32_t sample;
+            float    factor = GetSegment(track, duration, time, sample);
+            auto     from   = UnpackVector(words + sample * SampleWords, track);
+            if (track.count < 2)
+                return from;
+            return glm::mix(from, UnpackVector(words + (sample + 1) * SampleWords, track), factor);
+        }
+
+        // Normalized lerp on the shorter arc, close enough to slerp between neighbouring samples
+        glm::quat SampleRotationTrack(const uint16_t* words, const CompressedTrack& track, float duration, float time)
+        {
+            uint32_t sample;
+            float    factor = GetSegment(track, duration, time, sample);
+            auto     from   = UnpackRotation(words + sample * SampleWords);
+            if (track.count < 2)
+                return from;
+
+            auto  to  = UnpackRotation(words + (sample + 1) * SampleWords);
+            float dot = from.x * to.x + from.y * to.y + from.z * to.z + from.w * to.w;
+            if (dot < 0.0f)
+                to = -to;
+            return glm::normalize(from * (1.0f - factor) + to * factor);
+        }
+
+        float GetError(const glm::vec3& a, const glm::vec3& b) { return glm::length(a - b); }
+
+        float GetScaleError(const glm::vec3& a, const glm::vec3& b)
+        {
+            auto difference = glm::abs(a - b);
+            return std::max({difference.x, difference.y, difference.z});
+        }
+
+        float GetError(const glm::quat& a, const glm::quat& b)
+        {
+            float dot = std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+            return 2.0f * std::acos(std::min(dot, 1.0f));
+        }
+
+        // Tries 1, 2, 3, 5, 9, ... samples and finally the base count, keeps the first that meets the tolerance
+        template <class T, class Pack, class Unpack, class Measure>
+        CompressedTrack CompressTrack(const KeyTrack<T>& keys,
+                                      const std::vector<float>& baseTimes,
+                                      float                     duration,
+                                      float                     tolerance,
+                                      std::vector<uint16_t>&    data,
+                                      float&                    maxError,
+                                      Pack&&                    pack,
+                                      Unpack&&                  unpack,
+                                      Measure&&                 measure)
+        {
+            uint32_t       cursor = 0;
+            std::vector<T> reference(baseTimes.size());
+            for (size_t i = 0; i < baseTimes.size(); ++i)
+                reference[i] = keys.Sample(baseTimes[i], cursor);
+
+            auto baseCount = static_cast<uint32_t>(baseTimes.size());
+            auto words     = std::vector<uint16_t>();
+
+            CompressedTrack track;
+            float           error = 0.0f;
+            for (uint32_t count = 1;; count = count < 2 ? 2 : std::min((count - 1) * 2 + 1, baseCount)) {
+                count = std::min(count, baseCount);
+
+                std::vector<T> samples(count);
+                cursor = 0;
+                for (uint32_t i = 0; i < count; ++i)
+                    samples[i] = keys.Sample(count > 1 ? duration * i / (count - 1) : 0.0f, cursor);
+
+                track       = CompressedTrack();
+                track.count = count;
+                words.resize(count * SampleWords);
+                pack(samples, track, words.data());
+
+                error = 0.0f;
+                for (uint32_t i = 0; i < baseCount; ++i)
+                    error = std::max(error, measure(unpack(words.data(), track, duration, baseTimes[i]), reference[i]));
+                if (error <= tolerance || count == baseCount)
+                    break;
+            }
+
+            track.offset = static_cast<uint32_t>(data.size());
+            data.insert(data.end(), words.begin(), words.end());
+            maxError = std::max(maxError, error);
+            return track;
+        }
+
+        void PackVectors(const std::vector<glm::vec3>& samples, CompressedTrack& track, uint16_t* words)
+        {
+            glm::vec3 max = samples[0];
+            track.min     = samples[0];
+            for (auto& sample : samples) {
+                track.min = glm::min(track.min, sample);
+                max       = glm::max(max, sample);
+            }
+            track.extent = max - track.min;
+
+            for (size_t i = 0; i < samples.size(); ++i)
+                PackVector(samples[i], track, words + i * SampleWords);
+        }
+
+        void PackRotations(const std::vector<glm::quat>& samples, CompressedTrack& track, uint16_t* words)
+        {
+            for (size_t i = 0; i < samples.size(); ++i)
+                PackRotation(samples[i], words + i * SampleWords);
+        }
+
+        template <class T>
+        size_t GetKeyBytes(const KeyTrack<T>& track)
+        {
+            return track.times.size() * sizeof(float) + track.values.size() * sizeof(T);
+        }
+    }  // namespace
+
+    CompressedClip CompressedClip::Compress(std::span<const Bone> bones, float duration, const ClipCompressionSettings& settings,
+                                            ClipCompressionStats& stats)
+    {
+        stats = ClipCompressionStats();
+
+        CompressedClip clip;
+        clip.m_Duration = std::max(duration, 0.0f);
+
+        // The densest track sets the base rate
+        size_t baseCount = 1;
+        for (auto& bone : bones) {
+            baseCount = std::max({baseCount, bone.GetPositionKeys().times.size(), bone.GetRotationKeys().times.size(),
+                                  bone.GetScaleKeys().times.size()});
+            stats.rawBytes += GetKeyBytes(bone.GetPositionKeys()) + GetKeyBytes(bone.GetRotationKeys()) + GetKeyBytes(bone.GetScaleKeys());
+        }
+        if (clip.m_Duration <= 0.0f)
+            baseCount = 1;
+
+        std::vector<float> baseTimes(baseCount, 0.0f);
+        for (size_t i = 1; i < baseCount; ++i)
+            baseTimes[i] = clip.m_Duration * i / (baseCount - 1);
+
+        auto packVectors   = [](auto& samples, auto& track, auto words) { PackVectors(samples, track, words); };
+        auto packRotations = [](auto& samples, auto& track, auto words) { PackRotations(samples, track, words); };
+        auto scaleError    = [](const glm::vec3& a, const glm::vec3& b) { return GetScaleError(a, b); };
+        auto vectorError   = [](const glm::vec3& a, const glm::vec3& b) { return GetError(a, b); };
+        auto rotationError = [](const glm::quat& a, const glm::quat& b) { return GetError(a, b); };
+
+        for (auto& bone : bones) {
+            CompressedChannel channel;
+            channel.position = CompressTrack(bone.GetPositionKeys(), baseTimes, clip.m_Duration, settings.positionTolerance, clip.m_Data,
+                                             stats.maxPositionError, packVectors, SampleVectorTrack, vectorError);
+            channel.rotation = CompressTrack(bone.GetRotationKeys(), baseTimes, clip.m_Duration, settings.rotationTolerance, clip.m_Data,
+                                             stats.maxRotationError, packRotations, SampleRotationTrack, rotationError);
+            channel.scale    = CompressTrack(bone.GetScaleKeys(), baseTimes, clip.m_Duration, settings.scaleTolerance, clip.m_Data,
+                                             stats.maxScaleError, packVectors, SampleVectorTrack, scaleError);
+            clip.m_Channels.push_back(channel);
+        }
+
+        clip.m_Data.shrink_to_fit();
+        stats.compressedBytes = clip.GetBytes();
+        return clip;
+    }
+
+    glm::mat4 CompressedClip::Sample(uint32_t channel, float time) const
+    {
+        auto& tracks   = m_Channels[channel];
+        auto  position = SampleVector(tracks.position, time);
+        auto  rotation = SampleRotation(tracks.rotation, time);
+        auto  scale    = SampleVector(tracks.scale, time);
+        return ComposeBoneTransform(position, rotation, scale);
+    }
+
+    glm::vec3 CompressedClip::SampleVector(const CompressedTrack& track, float time) const
+    {
+        return SampleVectorTrack(m_Data.data() + track.offset, track, m_Duration, time);
+    }
+
+    glm::quat CompressedClip::SampleRotation(const CompressedTrack& track, float time) const
+    {
+        return SampleRotationTrack(m_Data.data() + track.offset, track, m_Duration, time);
+    }
+
+}  // namespace suplex
@@ -0,0 +1,74 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    class Bone;
+
+    struct ClipCompressionSettings
+    {
+        bool  enabled           = true;
+        float positionTolerance = 1e-3f;  // model units
+        float rotationTolerance = 1e-3f;  // radians
+        float scaleTolerance    = 1e-3f;
+    };
+
+    // Errors are measured against the source keys at every base frame of the clip, see CompressedClip::Compress.
+    struct ClipCompressionStats
+    {
+        size_t rawBytes         = 0;
+        size_t compressedBytes  = 0;
+        float  maxPositionError = 0.0f;
+        float  maxRotationError = 0.0f;  // radians
+        float  maxScaleError    = 0.0f;
+
+        float GetRatio() const { return compressedBytes ? static_cast<float>(rawBytes) / compressedBytes : 0.0f; }
+    };
+
+    // Uniformly spaced samples of one component of a channel, three 16 bit words each in CompressedClip's data.
+    // Vectors are quantized to [min, min + extent] per track, rotations are smallest-three packed (48 bit).
+    struct CompressedTrack
+    {
+        uint32_t  offset = 0;  // first word
+        uint32_t  count  = 0;  // samples spread evenly over the clip, 1 for a constant track
+        glm::vec3 min    = glm::vec3(0.0f);
+        glm::vec3 extent = glm::vec3(0.0f);
+    };
+
+    struct CompressedChannel
+    {
+        CompressedTrack position, rotation, scale;
+    };
+
+    // An animation clip in a compact form that is sampled without decompressing it first. No time arrays are kept:
+    // sample i of a track with count samples lies at duration * i / (count - 1).
+    class CompressedClip {
+    public:
+        // Every track is resampled from the source keys with the fewest of 1, 2, 3, 5, 9, ... samples that stay within
+        // tolerance after quantization, at most the base count (the key count of the densest track). Errors are checked
+        // at the base frames. Times are in ticks, like the source keys.
+        static CompressedClip Compress(std::span<const Bone> bones, float duration, const ClipCompressionSettings& settings,
+                                       ClipCompressionStats& stats);
+
+        // Local transform of a channel, translation * rotation * scale.
+        glm::mat4 Sample(uint32_t channel, float time) const;
+
+        size_t GetBytes() const { return m_Data.size() * sizeof(uint16_t) + m_Channels.size() * sizeof(CompressedChannel); }
+        bool   IsEmpty() const { return m_Channels.empty(); }
+
+    private:
+        glm::vec3 SampleVector(const CompressedTrack& track, float time) const;
+        glm::quat SampleRotation(const CompressedTrack& track, float time) const;
+
+    private:
+        float                          m_Duration = 0.0f;
+        std::vector<uint16_t>          m_Data;
+        std::vector<CompressedChannel> m_Channels;
+    };
+
+}  // namespace suplex
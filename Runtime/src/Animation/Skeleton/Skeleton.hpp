@@ -0,0 +1,35 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace suplex {
+
+    // Node hierarchy of an animation file flattened depth first, so every parent comes before its children and the
+    // global transforms are one pass over the arrays. Names are only kept for lookups at load time and debugging.
+    struct Skeleton
+    {
+        std::vector<int32_t>     parents;     // -1 for roots
+        std::vector<glm::mat4>   transforms;  // local transform of the file, used where the node has no channel
+        std::vector<int32_t>     channels;    // index of the animated Bone, -1 if none
+        std::vector<int32_t>     boneIDs;     // slot in the final bone matrices, -1 if no mesh is skinned to it
+        std::vector<glm::mat4>   offsets;     // mesh to bone space, valid where boneIDs >= 0
+        std::vector<std::string> names;
+
+        size_t GetSize() const { return parents.size(); }
+
+        int32_t AddNode(const std::string& name, int32_t parent, const glm::mat4& transform)
+        {
+            parents.push_back(parent);
+            transforms.push_back(transform);
+            channels.push_back(-1);
+            boneIDs.push_back(-1);
+            offsets.push_back(glm::mat4(1.0f));
+            names.push_back(name);
+            return static_cast<int32_t>(parents.size() - 1);
+        }
+    };
+
+}  // namespace suplex
@@ -2,6 +2,8 @@
 #include "GLFW/glfw3.h"
 #include "IconsFontAwesome6.h"
 
+#include "Render/RHI.hpp"
+#include <algorithm>
 #include <Render/Shader/Shader.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/fwd.hpp>
@@ -38,7 +40,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     // make sure the viewport matches the new window dimensions; note that width and
     // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
+    RHI::Viewport(0, 0, width, height);
 }
 
 void SetDarkTheme()
@@ -336,6 +338,7 @@ namespace suplex {
     {
         // render loop
         // -----------
+        m_lastTime = static_cast<float>(glfwGetTime());
         while (!glfwWindowShouldClose(g_WindowHandle) && m_Running) {
             // input
             // -----
@@ -347,8 +350,11 @@ namespace suplex {
             ImGui::NewFrame();
             ImGuizmo::BeginFrame();
 
-            // Update
-            for (auto& layer : m_LayerStack) layer->OnUpdate(0.03f);
+            // Update with the real frame time, clamped so a stall (loading, a breakpoint) does not jump animations ahead
+            float time     = static_cast<float>(glfwGetTime());
+            float timestep = std::min(time - m_lastTime, 0.1f);
+            m_lastTime     = time;
+            for (auto& layer : m_LayerStack) layer->OnUpdate(timestep);
 
             // Draw UI
             DockingSpace();
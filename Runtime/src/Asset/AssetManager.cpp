@@ -0,0 +1,227 @@
+#include "Asset/AssetManager.hpp"
+#include "Render/Texture/TextureCache.hpp"
+#include "Thread/ThreadPool.hpp"
+#include <chrono>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <unordered_set>
+
+namespace suplex {
+
+    std::unordered_map<std::string, std::shared_ptr<Model>>     AssetManager::s_Models;
+    std::unordered_map<std::string, std::shared_ptr<Texture2D>> AssetManager::s_Textures;
+    std::list<AssetManager::PendingModel>                       AssetManager::s_PendingModels;
+    std::shared_ptr<Model>                                      AssetManager::s_Placeholder;
+
+    std::string AssetManager::GetKey(const std::string& path)
+    {
+        // "Assets/a/../b.fbx" and "Assets/b.fbx" name the same file
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    std::shared_ptr<Model> AssetManager::LoadModel(const std::string& path)
+    {
+        auto key = GetKey(path);
+        if (auto iter = s_Models.find(key); iter != s_Models.end())
+            return iter->second;
+
+        // An async load of the same file is finished right away
+        for (auto iter = s_PendingModels.begin(); iter != s_PendingModels.end(); ++iter) {
+            if (iter->key == key) {
+                size_t budget = SIZE_MAX;
+                Advance(*iter, budget);
+                auto model = iter->model;
+                s_PendingModels.erase(iter);
+                return model;
+            }
+        }
+
+        auto model        = std::make_shared<Model>();
+        model->m_FilePath = path;
+        if (!model->LoadModel()) {
+            spdlog::error("Failed to load model {}", path);
+            return model;
+        }
+
+        spdlog::debug("Load model {} complete", path);
+        s_Models.emplace(key, model);
+        return model;
+    }
+
+    ModelFuture AssetManager::LoadModelAsync(const std::string& path)
+    {
+        auto key = GetKey(path);
+        if (auto iter = s_Models.find(key); iter != s_Models.end()) {
+            std::promise<std::shared_ptr<Model>> loaded;
+            loaded.set_value(iter->second);
+            return loaded.get_future().share();
+        }
+
+        for (auto& pending : s_PendingModels) {
+            if (pending.key == key)
+                return pending.future;
+        }
+
+        auto& pending             = s_PendingModels.emplace_back();
+        pending.key               = key;
+        pending.model             = std::make_shared<Model>();
+        pending.model->m_FilePath = path;
+        pending.future            = pending.promise.get_future().share();
+        pending.imported          = ThreadPool::Submit([model = pending.model] { return model->Import(); });
+        return pending.future;
+    }
+
+    bool AssetManager::Advance(PendingModel& pending, size_t& budget)
+    {
+        if (!pending.uploading) {
+            pending.uploading = true;
+            if (!pending.imported.get()) {
+                spdlog::error("Failed to load model {}", pending.model->m_FilePath);
+                pending.promise.set_value(pending.model);
+                return true;
+            }
+        }
+
+        if (!pending.model->Upload(budget))
+            return false;
+
+        spdlog::debug("Load model {} complete", pending.model->m_FilePath);
+        s_Models.emplace(pending.key, pending.model);
+        pending.promise.set_value(pending.model);
+        return true;
+    }
+
+    void AssetManager::Update(size_t uploadBudget)
+    {
+        for (auto iter = s_PendingModels.begin(); iter != s_PendingModels.end() && uploadBudget > 0;) {
+            bool imported = iter->uploading || iter->imported.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            if (imported && Advance(*iter, uploadBudget))
+                iter = s_PendingModels.erase(iter);
+            else
+                ++iter;
+        }
+    }
+
+    std::shared_ptr<Model> AssetManager::GetPlaceholderModel()
+    {
+        if (s_Placeholder)
+            return s_Placeholder;
+
+        // Four vertices per face so every face has its own normal, u x v points outwards
+        constexpr float corners[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        for (int axis = 0; axis < 3; ++axis) {
+            for (float sign : {-1.0f, 1.0f}) {
+                glm::vec3 normal(0.0f), u(0.0f), v(0.0f);
+                normal[axis]      = sign;
+                u[(axis + 1) % 3] = 1.0f;
+                v[(axis + 2) % 3] = 1.0f;
+                if (sign < 0.0f)
+                    std::swap(u, v);
+
+                auto first = static_cast<uint32_t>(vertices.size());
+                for (auto& [s, t] : corners) {
+                    Vertex vertex;
+                    vertex.position  = (normal + s * u + t * v) * 0.5f;
+                    vertex.normal    = normal;
+                    vertex.texCoord  = glm::vec2((s + 1.0f) * 0.5f, (t + 1.0f) * 0.5f);
+                    vertex.tangent   = u;
+                    vertex.bitangent = v;
+                    vertices.push_back(vertex);
+                }
+                indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+            }
+        }
+
+        std::vector<Mesh> meshes;
+        meshes.emplace_back(std::move(vertices), std::move(indices), std::vector<Texture2D>());
+        s_Placeholder = std::make_shared<Model>(std::move(meshes));
+        return s_Placeholder;
+    }
+
+    std::shared_ptr<Texture2D> AssetManager::LoadTexture(const std::string& path, TextureFormat format)
+    {
+        // The same file uploaded in another format is a different texture
+        auto key = GetKey(path) + "|" + std::to_string(static_cast<int>(format));
+        if (auto iter = s_Textures.find(key); iter != s_Textures.end())
+            return iter->second;
+
+        auto texture = std::make_shared<Texture2D>(TextureCache::Acquire(path, format));
+        if (texture->GetGPUBytes() == 0) {
+            TextureCache::Release(*texture);
+            return std::make_shared<Texture2D>();
+        }
+
+        s_Textures.emplace(key, texture);
+        return texture;
+    }
+
+    size_t AssetManager::CollectGarbage()
+    {
+        size_t evicted = 0;
+        for (auto iter = s_Models.begin(); iter != s_Models.end();) {
+            if (iter->second.use_count() == 1) {
+                spdlog::debug("Evict model {}", iter->first);
+                iter->second->Release();
+                iter = s_Models.erase(iter);
+                ++evicted;
+            }
+            else {
+                ++iter;
+            }
+        }
+
+        for (auto iter = s_Textures.begin(); iter != s_Textures.end();) {
+            if (iter->second.use_count() == 1) {
+                spdlog::debug("Evict texture {}", iter->first);
+                TextureCache::Release(*iter->second);
+                iter = s_Textures.erase(iter);
+                ++evicted;
+            }
+            else {
+                ++iter;
+            }
+        }
+
+        if (evicted)
+            spdlog::info("Evicted {} unused assets", evicted);
+        return evicted;
+    }
+
+    std::vector<AssetMemoryInfo> AssetManager::GetMemoryReport()
+    {
+        std::vector<AssetMemoryInfo> report;
+        report.reserve(s_Models.size() + s_Textures.size());
+
+        for (auto& [key, model] : s_Models) {
+            AssetMemoryInfo info{key, AssetType::Model};
+            info.handles = model.use_count() - 1;
+
+            // Slots sharing a texture through the TextureCache count once, textures shared with other models are
+            // counted for each of them
+            std::unordered_set<uint32_t> textures;
+            for (auto& mesh : model->m_Meshes) {
+                info.cpuBytes += mesh.GetCPUBytes();
+                info.gpuBytes += mesh.GetGPUBytes();
+                for (auto& texture : mesh.GetTextures()) {
+                    if (textures.insert(texture.GetID()).second)
+                        info.gpuBytes += texture.GetGPUBytes();
+                }
+            }
+            report.push_back(std::move(info));
+        }
+
+        for (auto& [key, texture] : s_Textures) {
+            AssetMemoryInfo info{texture->GetPath(), AssetType::Texture};
+            info.gpuBytes = texture->GetGPUBytes();
+            info.handles  = texture.use_count() - 1;
+            report.push_back(std::move(info));
+        }
+
+        return report;
+    }
+
+}  // namespace suplex
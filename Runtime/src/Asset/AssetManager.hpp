@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Render/Geometry/Model.hpp"
+#include "Render/Texture/Texture2D.hpp"
+#include <future>
+#include <list>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace suplex {
+
+    enum class AssetType { Model, Texture };
+
+    struct AssetMemoryInfo
+    {
+        std::string path;
+        AssetType   type;
+        size_t      cpuBytes = 0;
+        size_t      gpuBytes = 0;  // buffers and textures, estimated from their sizes and formats
+        long        handles  = 0;  // references held outside the manager
+    };
+
+    using ModelFuture = std::shared_future<std::shared_ptr<Model>>;
+
+    // Shares models and textures between everyone loading the same file. Handles are plain shared_ptrs, the manager
+    // holds one reference of its own, so an asset stays resident until CollectGarbage() finds nobody else uses it.
+    class AssetManager {
+    public:
+        // Failed loads return an empty asset and are not registered, a later call tries again.
+        static std::shared_ptr<Model>     LoadModel(const std::string& path);
+        static std::shared_ptr<Texture2D> LoadTexture(const std::string& path, TextureFormat format = TextureFormat::RGB);
+
+        static constexpr size_t DefaultUploadBudget = 8 * 1024 * 1024;
+
+        // Imports on the ThreadPool and spreads the GL upload over frames, see Update(). The future becomes ready on the
+        // render thread once the model can be drawn, it holds an empty model if the import failed.
+        static ModelFuture LoadModelAsync(const std::string& path);
+
+        // Render thread, once per frame: uploads the models whose import finished, about uploadBudget bytes per call.
+        static void Update(size_t uploadBudget = DefaultUploadBudget);
+
+        static size_t GetPendingCount() { return s_PendingModels.size(); }
+
+        // Unit cube drawn in place of models that are still loading, see PendingModelComponent.
+        static std::shared_ptr<Model> GetPlaceholderModel();
+
+        // Frees the GL objects of every asset without outside handles, returns how many were evicted.
+        static size_t CollectGarbage();
+
+        static std::vector<AssetMemoryInfo> GetMemoryReport();
+
+    private:
+        struct PendingModel
+        {
+            std::string                          key;
+            std::shared_ptr<Model>               model;
+            std::future<bool>                    imported;
+            std::promise<std::shared_ptr<Model>> promise;
+            ModelFuture                          future;
+            bool                                 uploading = false;
+        };
+
+        static std::string GetKey(const std::string& path);
+
+        // Uploads as much of the model as budget allows, registers it and resolves the future once it is complete.
+        // Waits for the import if it is still running.
+        static bool Advance(PendingModel& pending, size_t& budget);
+
+    private:
+        static std::unordered_map<std::string, std::shared_ptr<Model>>     s_Models;
+        static std::unordered_map<std::string, std::shared_ptr<Texture2D>> s_Textures;
+        static std::list<PendingModel>                                     s_PendingModels;  // in request order
+        static std::shared_ptr<Model>                                      s_Placeholder;
+    };
+
+}  // namespace suplex
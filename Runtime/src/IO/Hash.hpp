@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace suplex {
+
+    // MurmurHash64A, fast enough to fingerprint whole asset files. Not for anything security related.
+    inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+    {
+        constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+        constexpr int      r = 47;
+
+        auto     bytes = static_cast<const uint8_t*>(data);
+        uint64_t h     = seed ^ (size * m);
+
+        size_t blocks = size / 8;
+        for (size_t i = 0; i < blocks; ++i) {
+            uint64_t k;
+            memcpy(&k, bytes + i * 8, 8);
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+
+        auto   tail      = bytes + blocks * 8;
+        size_t remaining = size & 7;
+        if (remaining) {
+            uint64_t k = 0;
+            for (size_t i = 0; i < remaining; ++i)
+                k |= uint64_t(tail[i]) << (8 * i);
+            h ^= k;
+            h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
+}  // namespace suplex
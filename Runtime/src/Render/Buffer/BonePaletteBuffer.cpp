@@ -0,0 +1,11 @@
+#include "BonePaletteBuffer.hpp"
+
+namespace suplex {
+
+    uint32_t BonePaletteBuffer::s_BufferID  = 0;
+    uint32_t BonePaletteBuffer::s_TextureID = 0;
+    size_t   BonePaletteBuffer::s_Capacity  = 0;
+    size_t   BonePaletteBuffer::s_MaxTexels = 0;
+    bool     BonePaletteBuffer::s_Warned    = false;
+
+}  // namespace suplex
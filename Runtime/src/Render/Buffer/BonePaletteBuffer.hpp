@@ -0,0 +1,83 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "Render/RHI.hpp"
+#include <glm/glm.hpp>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+
+namespace suplex {
+
+    // Final bone matrices of every skinned instance in one texture buffer, four RGBA32F texels per matrix, filled from
+    // AnimationSystem::GetPalette. One upload per frame however many characters there are; the vertex shaders fetch an
+    // instance's bones from its palette offset (InstanceData, ObjectUniforms), so skinned entities batch like static ones.
+    class BonePaletteBuffer {
+    public:
+        // "BonePalette" sampler of common.vert and depth.vert, above the units the passes use for their own textures
+        static constexpr uint32_t TextureUnit = 16;
+
+        // Called once per frame by the renderer before any pass.
+        static void Upload(std::span<const glm::mat4> palette)
+        {
+            if (s_BufferID == 0)
+                Init();
+            if (palette.empty())
+                return;
+
+            if (palette.size() * 4 > s_MaxTexels && !s_Warned) {
+                spdlog::warn("Bone palette of {} matrices exceeds GL_MAX_TEXTURE_BUFFER_SIZE ({} texels)", palette.size(), s_MaxTexels);
+                s_Warned = true;
+            }
+
+            // Orphaned every frame, draws of the previous frame may still read the old storage
+            glBindBuffer(GL_TEXTURE_BUFFER, s_BufferID);
+            if (palette.size_bytes() > s_Capacity) {
+                s_Capacity = palette.size_bytes();
+                spdlog::debug("Bone palette buffer resized to {} matrices", palette.size());
+            }
+            glBufferData(GL_TEXTURE_BUFFER, s_Capacity, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, palette.size_bytes(), palette.data());
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
+        // Leaves TextureUnit active.
+        static void Bind()
+        {
+            if (s_BufferID == 0)
+                Init();
+            RHI::BindTexture(TextureUnit, GL_TEXTURE_BUFFER, s_TextureID);
+        }
+
+    private:
+        static void Init()
+        {
+            glm::mat4 identity(1.0f);
+            s_Capacity = sizeof(identity);
+
+            glGenBuffers(1, &s_BufferID);
+            glBindBuffer(GL_TEXTURE_BUFFER, s_BufferID);
+            glBufferData(GL_TEXTURE_BUFFER, s_Capacity, &identity, GL_STREAM_DRAW);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+            glGenTextures(1, &s_TextureID);
+            RHI::BindTexture(GL_TEXTURE_BUFFER, s_TextureID);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, s_BufferID);
+            RHI::BindTexture(GL_TEXTURE_BUFFER, 0);
+
+            int maxTexels = 65536;
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+            s_MaxTexels = static_cast<size_t>(maxTexels);
+
+            // Vertex arrays without a skin stream (static meshes, shapes) read zero weights at locations 5/6 and stay unskinned
+            glVertexAttribI4ui(5, 0, 0, 0, 0);
+            glVertexAttrib4f(6, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+    private:
+        static uint32_t s_BufferID, s_TextureID;
+        static size_t   s_Capacity, s_MaxTexels;
+        static bool     s_Warned;
+    };
+
+}  // namespace suplex
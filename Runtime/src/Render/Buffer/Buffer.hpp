@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 #include <stdint.h>
 #include "Render/Buffer/Buffer.hpp"
+#include "Render/RHI.hpp"
 #include "glad/glad.h"
 
 namespace suplex {
@@ -11,7 +12,7 @@ namespace suplex {
         Buffer()
         {
             glGenFramebuffers(1, &m_BufferID);
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+            RHI::BindFramebuffer(m_BufferID);
         }
 
         Buffer(uint32_t w, uint32_t h) : Buffer() { OnResize(w, h); };
@@ -21,11 +22,11 @@ namespace suplex {
 
         virtual void Bind()
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
-            glViewport(0, 0, m_Width, m_Height);
+            RHI::BindFramebuffer(m_BufferID);
+            RHI::Viewport(0, 0, m_Width, m_Height);
         }
 
-        virtual void Unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+        virtual void Unbind() { RHI::BindFramebuffer(0); }
 
         uint32_t         GetID() const { return m_BufferID; }
         virtual uint32_t GetTextureID() const { return m_BufferTextureID; }
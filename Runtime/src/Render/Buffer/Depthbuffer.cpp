@@ -1,5 +1,6 @@
 #include "Render/Buffer/Depthbuffer.hpp"
 #include "Render/Buffer/Buffer.hpp"
+#include "Render/RHI.hpp"
 #include <spdlog/common.h>
 #include <spdlog/spdlog.h>
 #include <stdint.h>
@@ -13,13 +14,13 @@ namespace suplex {
         if (w == m_Width && h == m_Height)
             return;
         m_Width = w, m_Height = h;
-        glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+        RHI::BindFramebuffer(m_BufferID);
 
         // Bind texture to depthbuffer
-        glDeleteTextures(1, &m_BufferTextureID);
+        RHI::DeleteTextures(1, &m_BufferTextureID);
         glGenTextures(1, &m_BufferTextureID);
 
-        glBindTexture(GL_TEXTURE_2D, m_BufferTextureID);
+        RHI::BindTexture(GL_TEXTURE_2D, m_BufferTextureID);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_Width, m_Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -31,9 +32,9 @@ namespace suplex {
         // Clamp outof screen depth to 1.0
         GLfloat borderColor[] = {1.0, 1.0, 1.0, 1.0};
         glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        RHI::BindTexture(GL_TEXTURE_2D, 0);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+        RHI::BindFramebuffer(m_BufferID);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_BufferTextureID, 0);
 
         // {
@@ -51,7 +52,7 @@ namespace suplex {
             spdlog::error("ERROR::FRAMEBUFFER:: Framebuffer is not complete!");
             return;
         }
-        glViewport(0, 0, m_Width, m_Height);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RHI::Viewport(0, 0, m_Width, m_Height);
+        RHI::BindFramebuffer(0);
     }
 }  // namespace suplex
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <stdint.h>
 #include <vector>
+#include "Render/RHI.hpp"
 #include "Render/Texture/Texture.hpp"
 #include "glad/glad.h"
 #include "spdlog/spdlog.h"
@@ -36,14 +37,14 @@ namespace suplex {
         spdlog::info("Framebuffer {} Resize to ({}, {})", m_BufferID, w, h);
 
         // Bind to self
-        glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+        RHI::BindFramebuffer(m_BufferID);
 
         // Color Attachments
         for (int i = 0; i < m_ColorAttachmentSpecifications.size(); ++i) {
-            glDeleteTextures(1, &m_ColorAttachments[i]);
+            RHI::DeleteTextures(1, &m_ColorAttachments[i]);
             glGenTextures(1, &m_ColorAttachments[i]);
 
-            glBindTexture(GL_TEXTURE_2D, m_ColorAttachments[i]);
+            RHI::BindTexture(GL_TEXTURE_2D, m_ColorAttachments[i]);
             auto& spec = m_ColorAttachmentSpecifications[i];
             switch (spec.TextureFilter) {
                 case TextureFilter::Linear:
@@ -90,7 +91,7 @@ namespace suplex {
 
             // Bind texture to framebuffer
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, m_ColorAttachments[i], 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            RHI::BindTexture(GL_TEXTURE_2D, 0);
         }
 
         if (m_ColorAttachments.size()) {
@@ -102,10 +103,10 @@ namespace suplex {
         // Depth Attachment
         if (m_DepthAttachmentSpecification.TextureFormat != TextureFormat::None) {
             // Bind texture to depthbuffer
-            glDeleteTextures(1, &m_DepthAttachMentID);
+            RHI::DeleteTextures(1, &m_DepthAttachMentID);
             glGenTextures(1, &m_DepthAttachMentID);
 
-            glBindTexture(GL_TEXTURE_2D, m_DepthAttachMentID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_DepthAttachMentID);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_Width, m_Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -115,9 +116,9 @@ namespace suplex {
             // Clamp outof screen depth to 1.0
             GLfloat borderColor[] = {1.0, 1.0, 1.0, 1.0};
             glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            RHI::BindTexture(GL_TEXTURE_2D, 0);
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+            RHI::BindFramebuffer(m_BufferID);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachMentID, 0);
         }
 
@@ -126,12 +127,12 @@ namespace suplex {
             glGenRenderbuffers(1, &m_DepthRenderbufferID);
 
             if (m_IsSwapChainTarget) {
-                glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+                RHI::BindFramebuffer(m_BufferID);
                 glBindRenderbuffer(GL_RENDERBUFFER, m_DepthRenderbufferID);
                 glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
                 glBindRenderbuffer(GL_RENDERBUFFER, 0);
                 glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthRenderbufferID);
-                glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+                RHI::BindFramebuffer(m_BufferID);
             }
         }
 
@@ -140,8 +141,8 @@ namespace suplex {
             return;
         }
 
-        glViewport(0, 0, m_Width, m_Height);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RHI::Viewport(0, 0, m_Width, m_Height);
+        RHI::BindFramebuffer(0);
     }
 
     // Return Entity ID in the scene
@@ -0,0 +1,20 @@
+#include "GeometryPool.hpp"
+
+namespace suplex {
+
+    uint32_t GeometryPool::s_VAO            = 0;
+    uint32_t GeometryPool::s_VBO            = 0;
+    uint32_t GeometryPool::s_SkinVBO        = 0;
+    uint32_t GeometryPool::s_EBO            = 0;
+    uint32_t GeometryPool::s_IndirectBuffer = 0;
+    uint32_t GeometryPool::s_VertexCount    = 0;
+    uint32_t GeometryPool::s_VertexCapacity = 1 << 16;
+    uint32_t GeometryPool::s_IndexCount     = 0;
+    uint32_t GeometryPool::s_IndexCapacity  = 1 << 18;
+
+    std::vector<DrawElementsIndirectCommand> GeometryPool::s_Commands;
+    size_t                                   GeometryPool::s_CommandCapacity      = 0;
+    uint32_t                                 GeometryPool::s_CommandCount         = 0;
+    uint32_t                                 GeometryPool::s_UploadedCommandCount = 0;
+
+}  // namespace suplex
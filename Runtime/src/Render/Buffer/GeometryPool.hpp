@@ -0,0 +1,182 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "Render/Buffer/InstanceBuffer.hpp"
+#include "Render/Geometry/Vertex.hpp"
+#include "Render/RHI.hpp"
+#include <algorithm>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Where a mesh lives inside the pool.
+    struct GeometryAllocation
+    {
+        int32_t  baseVertex = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // Layout fixed by GL for glMultiDrawElementsIndirect.
+    struct DrawElementsIndirectCommand
+    {
+        uint32_t count         = 0;
+        uint32_t instanceCount = 0;
+        uint32_t firstIndex    = 0;
+        int32_t  baseVertex    = 0;
+        uint32_t baseInstance  = 0;
+    };
+
+    // Shared vertex/index buffers behind a single VAO, used when GraphicsConfig::multiDrawIndirect is on.
+    // Meshes are suballocated linearly and never freed; draws are written as indirect commands and issued
+    // with one glMultiDrawElementsIndirect per run of equal state instead of one VAO bind + draw per mesh.
+    // Vertices are stored as PackedVertex plus a parallel SkinVertex stream, zero (unskinned) for static meshes.
+    class GeometryPool {
+    public:
+        static GeometryAllocation Allocate(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+        {
+            if (s_VAO == 0)
+                Init();
+
+            if (s_VertexCount + vertices.size() > s_VertexCapacity || s_IndexCount + indices.size() > s_IndexCapacity) {
+                while (s_VertexCount + vertices.size() > s_VertexCapacity)
+                    s_VertexCapacity *= 2;
+                while (s_IndexCount + indices.size() > s_IndexCapacity)
+                    s_IndexCapacity *= 2;
+                Grow();
+            }
+
+            GeometryAllocation allocation;
+            allocation.baseVertex = static_cast<int32_t>(s_VertexCount);
+            allocation.firstIndex = s_IndexCount;
+            allocation.indexCount = static_cast<uint32_t>(indices.size());
+
+            auto packed = PackVertices(vertices);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, s_VBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, s_VertexCount * sizeof(PackedVertex), packed.size() * sizeof(PackedVertex),
+                            packed.data());
+
+            // Both streams share baseVertex, so static meshes fill their range with zero weights
+            auto skins = PackSkins(vertices);
+            if (skins.empty())
+                skins.resize(vertices.size());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, s_SkinVBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, s_VertexCount * sizeof(SkinVertex), skins.size() * sizeof(SkinVertex), skins.data());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, s_EBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, s_IndexCount * sizeof(uint32_t), indices.size() * sizeof(uint32_t), indices.data());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            s_VertexCount += static_cast<uint32_t>(vertices.size());
+            s_IndexCount += static_cast<uint32_t>(indices.size());
+            return allocation;
+        }
+
+        static void Bind()
+        {
+            if (s_VAO == 0)
+                Init();
+            RHI::BindVertexArray(s_VAO);
+        }
+
+        // Called once per frame by the renderer, rewinds the indirect command stream.
+        static void NewFrame() { s_CommandCount = s_UploadedCommandCount = 0; }
+
+        // Appends and uploads commands, returns the index of the first one for MultiDraw.
+        static uint32_t PushCommands(const std::vector<DrawElementsIndirectCommand>& commands)
+        {
+            if (s_VAO == 0)
+                Init();
+
+            auto first = s_CommandCount;
+            if (s_CommandCount + commands.size() > s_Commands.size())
+                s_Commands.resize(std::max(s_Commands.size() * 2, s_CommandCount + commands.size()));
+            std::copy(commands.begin(), commands.end(), s_Commands.begin() + s_CommandCount);
+            s_CommandCount += static_cast<uint32_t>(commands.size());
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectBuffer);
+            if (s_Commands.size() > s_CommandCapacity) {
+                // Orphan and re-upload, draws already issued this frame keep the old storage
+                s_CommandCapacity = s_Commands.size();
+                glBufferData(GL_DRAW_INDIRECT_BUFFER, s_CommandCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, s_CommandCount * sizeof(DrawElementsIndirectCommand), s_Commands.data());
+            }
+            else {
+                glBufferSubData(GL_DRAW_INDIRECT_BUFFER, s_UploadedCommandCount * sizeof(DrawElementsIndirectCommand),
+                                (s_CommandCount - s_UploadedCommandCount) * sizeof(DrawElementsIndirectCommand),
+                                s_Commands.data() + s_UploadedCommandCount);
+            }
+            s_UploadedCommandCount = s_CommandCount;
+            return first;
+        }
+
+        // Expects the pool to be bound.
+        static void MultiDraw(uint32_t firstCommand, uint32_t commandCount)
+        {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectBuffer);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                        commandCount, 0);
+        }
+
+    private:
+        static void Init()
+        {
+            glGenVertexArrays(1, &s_VAO);
+            glGenBuffers(1, &s_IndirectBuffer);
+            s_Commands.resize(1024);
+            s_CommandCapacity = s_Commands.size();
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, s_CommandCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            Grow();
+        }
+
+        // Reallocates the buffers at the current capacities, copies the used ranges over and re-points the VAO.
+        static void Grow()
+        {
+            Reallocate(s_VBO, s_VertexCount * sizeof(PackedVertex), s_VertexCapacity * sizeof(PackedVertex));
+            Reallocate(s_SkinVBO, s_VertexCount * sizeof(SkinVertex), s_VertexCapacity * sizeof(SkinVertex));
+            Reallocate(s_EBO, s_IndexCount * sizeof(uint32_t), s_IndexCapacity * sizeof(uint32_t));
+
+            RHI::BindVertexArray(s_VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, s_VBO);
+            SetPackedVertexAttributes();
+            glBindBuffer(GL_ARRAY_BUFFER, s_SkinVBO);
+            SetSkinAttributes();
+            InstanceBuffer::EnableAttributes();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_EBO);
+            RHI::BindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            spdlog::debug("Geometry pool resized to {} vertices, {} indices", s_VertexCapacity, s_IndexCapacity);
+        }
+
+        static void Reallocate(uint32_t& buffer, size_t usedBytes, size_t newBytes)
+        {
+            uint32_t newBuffer = 0;
+            glGenBuffers(1, &newBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+            if (buffer != 0) {
+                glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &buffer);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            buffer = newBuffer;
+        }
+
+    private:
+        static uint32_t s_VAO, s_VBO, s_SkinVBO, s_EBO, s_IndirectBuffer;
+        static uint32_t s_VertexCount, s_VertexCapacity;
+        static uint32_t s_IndexCount, s_IndexCapacity;
+
+        static std::vector<DrawElementsIndirectCommand> s_Commands;
+        static size_t                                   s_CommandCapacity;
+        static uint32_t                                 s_CommandCount, s_UploadedCommandCount;
+    };
+
+}  // namespace suplex
@@ -1,6 +1,7 @@
 #include "HdrFramebuffer.hpp"
 #include "Render/Buffer/Buffer.hpp"
 #include "Render/Buffer/HdrFramebuffer.hpp"
+#include "Render/RHI.hpp"
 #include <stdint.h>
 #include "glad/glad.h"
 #include "spdlog/spdlog.h"
@@ -18,16 +19,16 @@ namespace suplex {
         m_Width = w, m_Height = h;
 
         // Bind to self
-        glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+        RHI::BindFramebuffer(m_BufferID);
 
-        glDeleteTextures(2, m_Colorbuffer);
+        RHI::DeleteTextures(2, m_Colorbuffer);
         glGenTextures(2, m_Colorbuffer);
 
         for (unsigned int i = 0; i < 2; i++) {
             // glDeleteBuffers(1, &m_Colorbuffer[i]);
             // glGenBuffers(1, &m_Colorbuffer[i]);
 
-            glBindTexture(GL_TEXTURE_2D, m_Colorbuffer[i]);
+            RHI::BindTexture(GL_TEXTURE_2D, m_Colorbuffer[i]);
             // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -42,13 +43,13 @@ namespace suplex {
             // attach texture to framebuffer
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, m_Colorbuffer[i], 0);
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+            RHI::BindTexture(GL_TEXTURE_2D, 0);
         }
 
         {
-            glDeleteTextures(1, &m_RedIntegerBuffer);
+            RHI::DeleteTextures(1, &m_RedIntegerBuffer);
             glGenTextures(1, &m_RedIntegerBuffer);
-            glBindTexture(GL_TEXTURE_2D, m_RedIntegerBuffer);
+            RHI::BindTexture(GL_TEXTURE_2D, m_RedIntegerBuffer);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_R32I, m_Width, m_Height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -58,15 +59,15 @@ namespace suplex {
             // attach texture to framebuffer
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + 2, GL_TEXTURE_2D, m_RedIntegerBuffer, 0);
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+            RHI::BindTexture(GL_TEXTURE_2D, 0);
         }
 
         {
             // Bind texture to depthbuffer
-            glDeleteTextures(1, &m_DepthMap);
+            RHI::DeleteTextures(1, &m_DepthMap);
             glGenTextures(1, &m_DepthMap);
 
-            glBindTexture(GL_TEXTURE_2D, m_DepthMap);
+            RHI::BindTexture(GL_TEXTURE_2D, m_DepthMap);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_Width, m_Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -76,9 +77,9 @@ namespace suplex {
             // Clamp outof screen depth to 1.0
             GLfloat borderColor[] = {1.0, 1.0, 1.0, 1.0};
             glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            RHI::BindTexture(GL_TEXTURE_2D, 0);
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+            RHI::BindFramebuffer(m_BufferID);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_DepthMap, 0);
         }
 
@@ -87,7 +88,7 @@ namespace suplex {
             glDeleteRenderbuffers(1, &m_DepthAttachMentID);
             glGenRenderbuffers(1, &m_DepthAttachMentID);
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+            RHI::BindFramebuffer(m_BufferID);
             glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachMentID);
             glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
             glBindRenderbuffer(GL_RENDERBUFFER, 0);
@@ -103,14 +104,14 @@ namespace suplex {
         unsigned int attachments[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
         glDrawBuffers(3, attachments);
 
-        glViewport(0, 0, m_Width, m_Height);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RHI::Viewport(0, 0, m_Width, m_Height);
+        RHI::BindFramebuffer(0);
     }
 
     int HdrFramebuffer::ReadPixel(int x, int y)
     {
         // this->Bind();
-        glBindFramebuffer(GL_FRAMEBUFFER, m_BufferID);
+        RHI::BindFramebuffer(m_BufferID);
         glReadBuffer(GL_COLOR_ATTACHMENT0 + 2);
 
         int pixelData = -1;
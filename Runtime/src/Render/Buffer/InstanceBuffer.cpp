@@ -0,0 +1,11 @@
+#include "InstanceBuffer.hpp"
+
+namespace suplex {
+
+    uint32_t                  InstanceBuffer::s_BufferID      = 0;
+    size_t                    InstanceBuffer::s_Capacity      = 0;
+    uint32_t                  InstanceBuffer::s_Count         = 1;
+    uint32_t                  InstanceBuffer::s_UploadedCount = 1;
+    std::vector<InstanceData> InstanceBuffer::s_Staging;
+
+}  // namespace suplex
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Per-instance vertex data, read by the vertex shaders at locations 7..10 (model), 11 (entity id) and 12 (first
+    // matrix in the BonePaletteBuffer, -1 for unskinned instances).
+    struct InstanceData
+    {
+        glm::mat4 model{1.0f};
+        int32_t   entityID      = -1;
+        int32_t   paletteOffset = -1;
+    };
+
+    // One vertex buffer holding the instances of every pass in the frame, attached to each mesh VAO with divisor 1.
+    // Instance 0 is an identity transform, so plain glDrawElements calls keep using the ObjectData block alone.
+    // Passes Push() their instances, Upload() once and draw with the returned index as base instance.
+    class InstanceBuffer {
+    public:
+        static constexpr uint32_t ModelAttribute         = 7;
+        static constexpr uint32_t EntityIDAttribute      = 11;
+        static constexpr uint32_t PaletteOffsetAttribute = 12;
+
+        // Called once per frame by the renderer before any pass, rewinds to the identity instance.
+        static void NewFrame()
+        {
+            if (s_BufferID == 0)
+                Init();
+            s_Count         = 1;
+            s_UploadedCount = 1;
+        }
+
+        static uint32_t Push(const InstanceData& instance)
+        {
+            if (s_Count == s_Staging.size())
+                s_Staging.resize(s_Staging.size() * 2);
+
+            s_Staging[s_Count] = instance;
+            return s_Count++;
+        }
+
+        // Uploads everything pushed since the last call. Earlier ranges are never overwritten within a frame.
+        static void Upload()
+        {
+            if (s_Count == s_UploadedCount)
+                return;
+
+            glBindBuffer(GL_ARRAY_BUFFER, s_BufferID);
+            if (s_Staging.size() > s_Capacity) {
+                s_Capacity = s_Staging.size();
+                glBufferData(GL_ARRAY_BUFFER, s_Capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, s_Count * sizeof(InstanceData), s_Staging.data());
+                spdlog::debug("Instance buffer resized to {} instances", s_Capacity);
+            }
+            else {
+                glBufferSubData(GL_ARRAY_BUFFER, s_UploadedCount * sizeof(InstanceData), (s_Count - s_UploadedCount) * sizeof(InstanceData),
+                                s_Staging.data() + s_UploadedCount);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            s_UploadedCount = s_Count;
+        }
+
+        // Adds the instance attributes to the currently bound vertex array.
+        static void EnableAttributes()
+        {
+            if (s_BufferID == 0)
+                Init();
+
+            glBindBuffer(GL_ARRAY_BUFFER, s_BufferID);
+            for (uint32_t column = 0; column < 4; ++column) {
+                glEnableVertexAttribArray(ModelAttribute + column);
+                glVertexAttribPointer(ModelAttribute + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                      (void*)(offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+                glVertexAttribDivisor(ModelAttribute + column, 1);
+            }
+            glEnableVertexAttribArray(EntityIDAttribute);
+            glVertexAttribIPointer(EntityIDAttribute, 1, GL_INT, sizeof(InstanceData), (void*)offsetof(InstanceData, entityID));
+            glVertexAttribDivisor(EntityIDAttribute, 1);
+            glEnableVertexAttribArray(PaletteOffsetAttribute);
+            glVertexAttribIPointer(PaletteOffsetAttribute, 1, GL_INT, sizeof(InstanceData), (void*)offsetof(InstanceData, paletteOffset));
+            glVertexAttribDivisor(PaletteOffsetAttribute, 1);
+        }
+
+        static auto GetCount() { return s_Count; }
+
+    private:
+        static void Init()
+        {
+            s_Staging.resize(256);
+            s_Staging[0] = InstanceData();
+            s_Capacity   = s_Staging.size();
+
+            glGenBuffers(1, &s_BufferID);
+            glBindBuffer(GL_ARRAY_BUFFER, s_BufferID);
+            glBufferData(GL_ARRAY_BUFFER, s_Capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(InstanceData), s_Staging.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            // Vertex arrays without the instance attributes (shapes, quads) read these constants instead
+            glVertexAttrib4f(ModelAttribute + 0, 1.0f, 0.0f, 0.0f, 0.0f);
+            glVertexAttrib4f(ModelAttribute + 1, 0.0f, 1.0f, 0.0f, 0.0f);
+            glVertexAttrib4f(ModelAttribute + 2, 0.0f, 0.0f, 1.0f, 0.0f);
+            glVertexAttrib4f(ModelAttribute + 3, 0.0f, 0.0f, 0.0f, 1.0f);
+            glVertexAttribI1i(EntityIDAttribute, -1);
+            glVertexAttribI1i(PaletteOffsetAttribute, -1);
+        }
+
+    private:
+        static uint32_t                  s_BufferID;
+        static size_t                    s_Capacity;
+        static uint32_t                  s_Count, s_UploadedCount;
+        static std::vector<InstanceData> s_Staging;
+    };
+
+}  // namespace suplex
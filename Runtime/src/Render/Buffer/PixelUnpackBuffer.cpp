@@ -0,0 +1,40 @@
+#include "PixelUnpackBuffer.hpp"
+#include <string.h>
+
+namespace suplex {
+
+    uint32_t PixelUnpackBuffer::s_BufferID = 0;
+    size_t   PixelUnpackBuffer::s_Capacity = 0;
+
+    uint8_t* PixelUnpackBuffer::Map(size_t size)
+    {
+        if (s_BufferID == 0)
+            glGenBuffers(1, &s_BufferID);
+
+        // Grows to the largest texture seen, orphaning a same sized store is cheap for the driver
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_BufferID);
+        if (size > s_Capacity)
+            s_Capacity = size;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, s_Capacity, nullptr, GL_STREAM_DRAW);
+
+        auto data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!data)
+            Unbind();
+        return static_cast<uint8_t*>(data);
+    }
+
+    bool PixelUnpackBuffer::Stage(const void* data, size_t size)
+    {
+        // Falls back to client memory if the staging buffer cannot be mapped
+        auto staging = Map(size);
+        if (!staging)
+            return false;
+
+        memcpy(staging, data, size);
+        if (Unmap())
+            return true;
+        Unbind();
+        return false;
+    }
+
+}  // namespace suplex
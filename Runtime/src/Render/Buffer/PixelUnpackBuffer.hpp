@@ -0,0 +1,29 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace suplex {
+
+    // Staging buffer for texture uploads. Map() orphans the previous storage, so a texture still reading from it on the
+    // GPU never stalls the next upload. While bound, glTexSubImage2D takes offsets into the buffer instead of pointers.
+    class PixelUnpackBuffer {
+    public:
+        // Binds the buffer and maps size writable bytes, nullptr if mapping failed (the buffer is unbound again).
+        static uint8_t* Map(size_t size);
+
+        // Ends the writes, the buffer stays bound for the glTexSubImage2D calls.
+        static bool Unmap() { return glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE; }
+        static void Unbind() { glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); }
+
+        // Map, copy and Unmap in one: true with the buffer bound, the texture calls then take byte offsets into data and
+        // Unbind() follows them. False if the buffer could not be mapped, nothing is bound and they take client memory.
+        static bool Stage(const void* data, size_t size);
+
+    private:
+        static uint32_t s_BufferID;
+        static size_t   s_Capacity;
+    };
+
+}  // namespace suplex
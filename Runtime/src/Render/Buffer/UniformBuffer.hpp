@@ -0,0 +1,188 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <cstring>
+#include <glm/glm.hpp>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+namespace suplex {
+
+    // Fixed binding points, every linked shader gets its blocks assigned by name (see Shader::BindUniformBlocks).
+    enum UniformBlockBinding : uint32_t { FrameBlockBinding = 0, MaterialBlockBinding = 1, ObjectBlockBinding = 2 };
+
+    inline int GetUniformBlockBinding(std::string_view blockName)
+    {
+        if (blockName == "FrameData")
+            return FrameBlockBinding;
+        if (blockName == "MaterialData")
+            return MaterialBlockBinding;
+        if (blockName == "ObjectData")
+            return ObjectBlockBinding;
+        return -1;
+    }
+
+    // std140 mirrors of the blocks declared in the shaders, member order must match the GLSL side.
+    // vec3 is followed by a scalar so that both share one 16 byte slot, arrays of vec3 have a 16 byte stride.
+    struct FrameUniforms
+    {
+        glm::mat4 view{1.0f};
+        glm::mat4 proj{1.0f};
+        glm::mat4 mvpLS{1.0f};
+        glm::vec3 viewPos{0.0f};
+        float     lightIntensity = 0.0f;
+        glm::vec3 lightPosition{0.0f};
+        float     bloomThreshold = 0.0f;
+        glm::vec3 lightDirection{0.0f};
+        int32_t   useEnvMap = 0;
+        glm::vec3 lightColor{0.0f};
+        float     padding0 = 0.0f;
+        glm::vec4 lightPositions[4]{};
+        glm::vec4 lightColors[4]{};
+    };
+
+    struct MaterialUniforms
+    {
+        glm::vec3 baseColor{1.0f};
+        float     baseF      = 0.04f;
+        float     metallic   = 0.0f;
+        float     roughness  = 0.0f;
+        float     ao         = 1.0f;
+        int32_t   kullaConty = 0;
+    };
+
+    struct ObjectUniforms
+    {
+        glm::mat4 model{1.0f};
+        int32_t   entityID      = -1;
+        int32_t   paletteOffset = -1;  // see InstanceData
+        int32_t   padding[2]{};
+    };
+
+    static_assert(sizeof(FrameUniforms) == 384, "FrameUniforms does not match the std140 FrameData block");
+    static_assert(sizeof(MaterialUniforms) == 32, "MaterialUniforms does not match the std140 MaterialData block");
+    static_assert(sizeof(ObjectUniforms) == 80, "ObjectUniforms does not match the std140 ObjectData block");
+
+    // A single std140 block bound at a fixed binding point.
+    // Keeps a CPU copy of the last upload so that unchanged data never reaches the driver.
+    template <class T>
+    class UniformBlock {
+    public:
+        UniformBlock(uint32_t binding) : m_Binding(binding)
+        {
+            glGenBuffers(1, &m_BufferID);
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            Bind();
+        }
+
+        ~UniformBlock() { glDeleteBuffers(1, &m_BufferID); }
+
+        UniformBlock(const UniformBlock&)            = delete;
+        UniformBlock& operator=(const UniformBlock&) = delete;
+
+        // Returns true if the block was re-uploaded.
+        bool Update(const T& data)
+        {
+            if (m_Uploaded && std::memcmp(&m_Shadow, &data, sizeof(T)) == 0)
+                return false;
+
+            m_Shadow   = data;
+            m_Uploaded = true;
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &m_Shadow);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            return true;
+        }
+
+        void Bind() const { glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_BufferID); }
+
+        const T& GetData() const { return m_Shadow; }
+        auto     GetID() const { return m_BufferID; }
+
+    private:
+        uint32_t m_BufferID = 0;
+        uint32_t m_Binding  = 0;
+        T        m_Shadow{};
+        bool     m_Uploaded = false;
+    };
+
+    // Per-object blocks of one pass packed into a single buffer at GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT strides.
+    // Usage per frame: Begin(), Push() every draw, Upload() once, then Bind(slot) before each draw.
+    class ObjectUniformBuffer {
+    public:
+        ObjectUniformBuffer(uint32_t capacity = 256)
+        {
+            int alignment = 256;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            m_Stride = (sizeof(ObjectUniforms) + alignment - 1) / alignment * alignment;
+
+            glGenBuffers(1, &m_BufferID);
+            m_Staging.resize(capacity * m_Stride);
+            Allocate();
+        }
+
+        ~ObjectUniformBuffer() { glDeleteBuffers(1, &m_BufferID); }
+
+        ObjectUniformBuffer(const ObjectUniformBuffer&)            = delete;
+        ObjectUniformBuffer& operator=(const ObjectUniformBuffer&) = delete;
+
+        void Begin() { m_Count = 0; }
+
+        uint32_t Push(const ObjectUniforms& data)
+        {
+            if ((m_Count + 1) * m_Stride > m_Staging.size())
+                m_Staging.resize(m_Staging.size() * 2);
+
+            std::memcpy(m_Staging.data() + m_Count * m_Stride, &data, sizeof(ObjectUniforms));
+            return m_Count++;
+        }
+
+        // Skips the upload when the slots are identical to the previous frame (static scene, same camera order).
+        void Upload()
+        {
+            auto usedBytes = m_Count * m_Stride;
+            if (m_Staging.size() > m_AllocatedBytes)
+                Allocate();
+            else if (usedBytes == m_UploadedBytes && std::memcmp(m_Staging.data(), m_Uploaded.data(), usedBytes) == 0)
+                return;
+
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, usedBytes, m_Staging.data());
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+            m_Uploaded.assign(m_Staging.begin(), m_Staging.begin() + usedBytes);
+            m_UploadedBytes = usedBytes;
+        }
+
+        void Bind(uint32_t slot) const
+        {
+            glBindBufferRange(GL_UNIFORM_BUFFER, ObjectBlockBinding, m_BufferID, slot * m_Stride, sizeof(ObjectUniforms));
+        }
+
+        auto GetCount() const { return m_Count; }
+
+    private:
+        void Allocate()
+        {
+            m_AllocatedBytes = m_Staging.size();
+            m_UploadedBytes  = 0;
+            glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+            glBufferData(GL_UNIFORM_BUFFER, m_AllocatedBytes, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            spdlog::debug("Object uniform buffer resized to {} bytes", m_AllocatedBytes);
+        }
+
+    private:
+        uint32_t             m_BufferID       = 0;
+        uint32_t             m_Stride         = 0;
+        uint32_t             m_Count          = 0;
+        size_t               m_AllocatedBytes = 0;
+        size_t               m_UploadedBytes  = 0;
+        std::vector<uint8_t> m_Staging, m_Uploaded;
+    };
+
+}  // namespace suplex
@@ -31,6 +31,7 @@ namespace suplex {
         auto& GetFarClip() { return m_FarClip; }
         auto& GetViewRange() { return m_ViewRange; }
         auto& GetForward() { return m_Forward; }
+        auto  GetViewportHeight() const { return m_ViewportHeight; }
         void  LookAtWorldCenter() { m_View = glm::lookAt(m_Position - m_Forward, glm::vec3(0.0f), glm::vec3(0, 1, 0)); }
 
     public:
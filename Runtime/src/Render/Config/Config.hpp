@@ -6,9 +6,11 @@
 #include <stdint.h>
 
 #include "Render/Buffer/Framebuffer.hpp"
+#include "Render/Buffer/UniformBuffer.hpp"
 #include "Render/Camera/Camera.hpp"
 #include "Render/Config/Config.hpp"
 #include "Render/Postprocess/PostProcess.hpp"
+#include "Render/RenderQueue/RenderStats.hpp"
 #include "Render/Texture/CubeMap.hpp"
 #include "Scene/Entity/Entity.hpp"
 
@@ -70,12 +72,29 @@ namespace suplex {
         float ao        = 1.0;
 
         bool enableKullaConty = false;
+
+        MaterialUniforms GetUniforms() const
+        {
+            MaterialUniforms uniforms;
+            uniforms.baseColor  = baseColor;
+            uniforms.baseF      = baseF;
+            uniforms.metallic   = metallic;
+            uniforms.roughness  = roughness;
+            uniforms.ao         = ao;
+            uniforms.kullaConty = enableKullaConty;
+            return uniforms;
+        }
     };
 
     struct GraphicsConfig
     {
-        bool               vsync       = true;
-        PolygonMode        polygonMode = PolygonMode::Shaded;
+        bool               vsync             = true;
+        PolygonMode        polygonMode       = PolygonMode::Shaded;
+        bool               multiDrawIndirect = false;   // draw from the shared GeometryPool with glMultiDrawElementsIndirect
+        int                textureBudgetMB   = 512;     // video memory for streamed texture mips, see TextureStreamer
+        bool               enableLod         = true;    // pick a simplified level per entity, see LodSelection
+        float              lodScreenSize     = 256.0f;  // on-screen diameter in pixels below which level 0 is left
+        int                shadowLodBias     = 1;       // levels coarser in the light space pass
         LightSetting       lightSetting;
         PBRSetting         pbrSetting;
         PostprocessSetting postprocessSetting;
@@ -93,6 +112,18 @@ namespace suplex {
         uint32_t                        gNormal    = 0;
         uint32_t                        mainImage  = 0;
         uint32_t                        SSAOMap    = 0;
+        RenderStats                     renderStats;
+
+        // Shared uniform blocks, re-uploaded only when their contents change
+        std::shared_ptr<UniformBlock<FrameUniforms>>    frameBlock = std::make_shared<UniformBlock<FrameUniforms>>(FrameBlockBinding);
+        std::shared_ptr<UniformBlock<MaterialUniforms>> materialBlock =
+            std::make_shared<UniformBlock<MaterialUniforms>>(MaterialBlockBinding);
+
+        void UploadUniforms(const FrameUniforms& frame)
+        {
+            frameBlock->Update(frame);
+            materialBlock->Update(config->pbrSetting.GetUniforms());
+        }
     };
 
 }  // namespace suplex
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Render/Culling/Frustum.hpp"
+#include "Render/RenderQueue/RenderStats.hpp"
+#include "Scene/Component/Component.hpp"
+#include "Scene/Scene.hpp"
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Visibility for one view-projection, each pass owns its own stage. Relies on Scene::UpdateTransforms earlier in the frame.
+    // The spatial index rejects and accepts whole subtrees; leaves on the frustum border are then re-tested with their
+    // tight world bounds in one SIMD batch, since the index only stores fattened boxes.
+    class CullingStage {
+    public:
+        // Returns the visible entities, in no particular order.
+        const std::vector<entt::entity>& Run(Scene& scene, const glm::mat4& viewProj, RenderStats& stats)
+        {
+            m_Visible.clear();
+            m_Border.clear();
+            m_BorderBounds.clear();
+
+            Frustum frustum(viewProj);
+            auto&   index = scene.GetSpatialIndex();
+            index.QueryFrustum(frustum, [&](uint32_t userData, bool inside) {
+                auto entity = static_cast<entt::entity>(userData);
+                if (inside) {
+                    m_Visible.push_back(entity);
+                    return;
+                }
+                m_Border.push_back(entity);
+                m_BorderBounds.push_back(scene.m_Registry.get<BoundsComponent>(entity).m_WorldBounds);
+            });
+
+            m_Flags.resize(m_Border.size());
+            frustum.Cull(m_BorderBounds.data(), m_BorderBounds.size(), m_Flags.data());
+            for (size_t i = 0; i < m_Border.size(); ++i) {
+                if (m_Flags[i])
+                    m_Visible.push_back(m_Border[i]);
+            }
+
+            stats.culledObjects += static_cast<uint32_t>(index.GetProxyCount() - m_Visible.size());
+            return m_Visible;
+        }
+
+    private:
+        std::vector<entt::entity> m_Visible, m_Border;
+        std::vector<AABB>         m_BorderBounds;
+        std::vector<uint8_t>      m_Flags;
+    };
+
+}  // namespace suplex
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Render/Geometry/Bounds.hpp"
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SUPLEX_FRUSTUM_SSE 1
+    #include <emmintrin.h>
+#endif
+
+namespace suplex {
+
+    // The six clip planes of a view-projection matrix (Gribb/Hartmann), normals pointing inwards.
+    // Planes are kept as structure of arrays padded to 8, so the SSE path tests 4 planes per instruction.
+    class Frustum {
+    public:
+        Frustum() = default;
+
+        explicit Frustum(const glm::mat4& viewProj)
+        {
+            auto row = [&](int i) { return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]); };
+
+            glm::vec4 planes[6] = {
+                row(3) + row(0),  // left
+                row(3) - row(0),  // right
+                row(3) + row(1),  // bottom
+                row(3) - row(1),  // top
+                row(3) + row(2),  // near
+                row(3) - row(2),  // far
+            };
+
+            // Padding planes accept everything
+            for (int i = 0; i < 8; ++i) {
+                auto plane = i < 6 ? planes[i] / glm::length(glm::vec3(planes[i])) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+                m_X[i]     = plane.x;
+                m_Y[i]     = plane.y;
+                m_Z[i]     = plane.z;
+                m_W[i]     = plane.w;
+            }
+        }
+
+        enum Classification { Outside, Intersect, Inside };
+
+        // Inside means the box is fully contained, used by hierarchical queries to stop testing a subtree.
+        Classification Classify(const AABB& box) const
+        {
+            auto center  = box.GetCenter();
+            auto extents = box.GetExtents();
+            auto result  = Inside;
+            for (int i = 0; i < 6; ++i) {
+                float distance = m_X[i] * center.x + m_Y[i] * center.y + m_Z[i] * center.z + m_W[i];
+                float radius   = std::abs(m_X[i]) * extents.x + std::abs(m_Y[i]) * extents.y + std::abs(m_Z[i]) * extents.z;
+                if (distance + radius < 0.0f)
+                    return Outside;
+                if (distance - radius < 0.0f)
+                    result = Intersect;
+            }
+            return result;
+        }
+
+        bool Intersects(const AABB& box) const
+        {
+            auto center  = box.GetCenter();
+            auto extents = box.GetExtents();
+            for (int i = 0; i < 6; ++i) {
+                float distance = m_X[i] * center.x + m_Y[i] * center.y + m_Z[i] * center.z + m_W[i];
+                float radius   = std::abs(m_X[i]) * extents.x + std::abs(m_Y[i]) * extents.y + std::abs(m_Z[i]) * extents.z;
+                if (distance + radius < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        bool Intersects(const BoundingSphere& sphere) const
+        {
+            for (int i = 0; i < 6; ++i) {
+                float distance = m_X[i] * sphere.center.x + m_Y[i] * sphere.center.y + m_Z[i] * sphere.center.z + m_W[i];
+                if (distance + sphere.radius < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        // Writes 1 to visible[i] if boxes[i] is at least partially inside, 0 otherwise. Returns the visible count.
+        size_t Cull(const AABB* boxes, size_t count, uint8_t* visible) const
+        {
+            size_t visibleCount = 0;
+#ifdef SUPLEX_FRUSTUM_SSE
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 zero     = _mm_setzero_ps();
+
+            __m128 x[2], y[2], z[2], w[2], absX[2], absY[2], absZ[2];
+            for (int i = 0; i < 2; ++i) {
+                x[i]    = _mm_load_ps(m_X + i * 4);
+                y[i]    = _mm_load_ps(m_Y + i * 4);
+                z[i]    = _mm_load_ps(m_Z + i * 4);
+                w[i]    = _mm_load_ps(m_W + i * 4);
+                absX[i] = _mm_andnot_ps(signMask, x[i]);
+                absY[i] = _mm_andnot_ps(signMask, y[i]);
+                absZ[i] = _mm_andnot_ps(signMask, z[i]);
+            }
+
+            for (size_t b = 0; b < count; ++b) {
+                auto center  = boxes[b].GetCenter();
+                auto extents = boxes[b].GetExtents();
+
+                __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+                __m128 ex = _mm_set1_ps(extents.x), ey = _mm_set1_ps(extents.y), ez = _mm_set1_ps(extents.z);
+
+                int outside = 0;
+                for (int i = 0; i < 2; ++i) {
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x[i], cx), _mm_mul_ps(y[i], cy)), _mm_add_ps(_mm_mul_ps(z[i], cz), w[i]));
+                    __m128 radius   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[i], ex), _mm_mul_ps(absY[i], ey)), _mm_mul_ps(absZ[i], ez));
+                    outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+                }
+
+                visible[b] = outside == 0;
+                visibleCount += visible[b];
+            }
+#else
+            for (size_t b = 0; b < count; ++b) {
+                visible[b] = Intersects(boxes[b]);
+                visibleCount += visible[b];
+            }
+#endif
+            return visibleCount;
+        }
+
+    private:
+        alignas(16) float m_X[8]{};
+        alignas(16) float m_Y[8]{};
+        alignas(16) float m_Z[8]{};
+        alignas(16) float m_W[8]{};
+    };
+
+}  // namespace suplex
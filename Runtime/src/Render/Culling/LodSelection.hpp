@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Render/Geometry/Bounds.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+namespace suplex {
+
+    // Projected diameter of a bounding sphere in pixels. Orthographic projections (proj[3][3] == 1) ignore the distance.
+    inline float GetScreenSize(const BoundingSphere& sphere, const glm::vec3& viewPosition, const glm::mat4& proj, float height)
+    {
+        float size = sphere.radius * proj[1][1] * height;
+        if (proj[3][3] != 0.0f)
+            return size;
+
+        float distance = glm::length(sphere.center - viewPosition) - sphere.radius;
+        return distance > 0.0f ? size / distance : INFINITY;
+    }
+
+    // Continuous level for a screen size: 0 at lodScreenSize pixels and above, one more every time the size halves,
+    // matching GenerateLods halving the triangle count per level.
+    inline float GetLodLevel(float screenSize, float lodScreenSize)
+    {
+        return std::log2(std::max(lodScreenSize, 1.0f) / std::max(screenSize, 1e-3f));
+    }
+
+    // Keeps the current level until the continuous level leaves it by more than the hysteresis, so an object resting
+    // on a switching distance does not pop every frame. Selecting again with the result returns the same level.
+    inline uint32_t SelectLod(float level, uint32_t current, uint32_t lodCount, float hysteresis = 0.25f)
+    {
+        if (lodCount <= 1)
+            return 0;
+
+        uint32_t last = lodCount - 1;
+        current       = std::min(current, last);
+        if (level >= current - hysteresis && level < current + 1.0f + hysteresis)
+            return current;
+        return static_cast<uint32_t>(std::clamp(std::floor(level), 0.0f, static_cast<float>(last)));
+    }
+
+}  // namespace suplex
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <glm/glm.hpp>
+
+namespace suplex {
+
+    struct AABB
+    {
+        glm::vec3 min{FLT_MAX};
+        glm::vec3 max{-FLT_MAX};
+
+        bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+        glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+        glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+        void Expand(const glm::vec3& point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        void Merge(const AABB& other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+
+        // Box enclosing this box after the affine transform, without touching the 8 corners (Arvo).
+        AABB Transform(const glm::mat4& transform) const
+        {
+            if (!IsValid())
+                return *this;
+
+            auto center  = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+            auto extents = GetExtents();
+            auto world   = glm::abs(glm::vec3(transform[0])) * extents.x + glm::abs(glm::vec3(transform[1])) * extents.y +
+                         glm::abs(glm::vec3(transform[2])) * extents.z;
+            return {center - world, center + world};
+        }
+
+        bool operator==(const AABB& other) const { return min == other.min && max == other.max; }
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center{0.0f};
+        float     radius = 0.0f;
+
+        BoundingSphere Transform(const glm::mat4& transform) const
+        {
+            auto scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                                   glm::length(glm::vec3(transform[2]))});
+            return {glm::vec3(transform * glm::vec4(center, 1.0f)), radius * scale};
+        }
+    };
+
+}  // namespace suplex
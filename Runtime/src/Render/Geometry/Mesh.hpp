@@ -1,5 +1,11 @@
 #pragma once
 
+#include "Render/Buffer/GeometryPool.hpp"
+#include "Render/Buffer/InstanceBuffer.hpp"
+#include "Render/Geometry/Bounds.hpp"
+#include "Render/Geometry/MeshOptimizer.hpp"
+#include "Render/Geometry/Vertex.hpp"
+#include "Render/RHI.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "Render/Texture/Texture2D.hpp"
 #include "glm/fwd.hpp"
@@ -10,71 +16,53 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
 #include <memory>
+#include <span>
 #include <spdlog/spdlog.h>
 #include <stdint.h>
 #include <tiny_obj_loader.h>
+#include <utility>
 #include <vector>
 
 namespace suplex {
 
-    constexpr int MAX_BONE_INFLUENCE = 4;
-
-    struct Vertex
-    {
-        glm::vec3 position  = {0, 0, 0};
-        glm::vec3 normal    = {0, 0, 0};
-        glm::vec2 texCoord  = {0, 0};
-        glm::vec3 tangent   = {0, 0, 0};
-        glm::vec3 bitangent = {0, 0, 0};
-
-        int   boneIDs[MAX_BONE_INFLUENCE]{-1};
-        float weights[MAX_BONE_INFLUENCE]{0.0f};
-
-        Vertex()
-        {
-            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
-                boneIDs[i] = -1;
-                weights[i] = 0.0f;
-            }
-        }
-
-        void Reset()
-        {
-            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
-                boneIDs[i] = -1;
-                weights[i] = 0.0f;
-            }
-        }
-
-        void SetBoneData(int boneID, float weight)
-        {
-            for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
-                boneIDs[i] = boneID;
-                weights[i] = weight;
-            }
-        }
-    };
-
     class Mesh {
     public:
         Mesh() = default;
 
-        Mesh(std::vector<Vertex>&& vs, std::vector<uint32_t>&& ids, std::vector<Texture2D>&& texs)
+        // lods are ranges of ids, see GenerateLods; empty means a single level over all of them.
+        Mesh(std::vector<Vertex>&& vs, std::vector<uint32_t>&& ids, std::vector<Texture2D>&& texs, std::vector<MeshLod>&& lods = {})
         {
-            m_Vertices = vs;
-            m_Indices  = ids;
-            m_Textures = texs;
+            auto storage = std::make_shared<std::pair<std::vector<Vertex>, std::vector<uint32_t>>>(std::move(vs), std::move(ids));
+            m_Vertices   = storage->first;
+            m_Indices    = storage->second;
+            m_Storage    = storage;
+            m_Textures   = texs;
+            m_Lods       = std::move(lods);
 
-            BindBuffer();
+            ComputeBounds();
+            ValidateLods();
+        }
+
+        // Borrows the geometry from storage (e.g. a memory mapped MeshCache file), the upload reads straight from it.
+        // Neither constructor touches GL, buffers are created by BindBuffer() or on first use.
+        Mesh(std::shared_ptr<const void> storage, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+             std::vector<Texture2D>&& textures, const AABB& bounds, const BoundingSphere& boundingSphere,
+             std::vector<MeshLod>&& lods = {})
+            : m_Vertices(vertices), m_Indices(indices), m_Storage(std::move(storage)), m_Textures(std::move(textures)), m_Bounds(bounds),
+              m_BoundingSphere(boundingSphere), m_Lods(std::move(lods))
+        {
+            ValidateLods();
         }
 
         virtual ~Mesh() {}
 
         virtual void Unbind()
         {
-            glDeleteVertexArrays(1, &m_VAO);
+            RHI::DeleteVertexArrays(1, &m_VAO);
             glDeleteBuffers(1, &m_VBO);
+            glDeleteBuffers(1, &m_SkinVBO);
             glDeleteBuffers(1, &m_EBO);
+            m_VAO = m_VBO = m_SkinVBO = m_EBO = 0;
         }
 
         virtual void BindBuffer()
@@ -84,41 +72,46 @@ namespace suplex {
             glGenBuffers(1, &m_VBO);
             glGenBuffers(1, &m_EBO);
 
-            glBindVertexArray(m_VAO);
+            RHI::BindVertexArray(m_VAO);
             // load data into vertex buffers
             glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-            // A great thing about structs is that their memory layout is sequential for all its items.
-            // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-            // again translates to 3/2 floats which translates to a byte array.
-            glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), &m_Vertices[0], GL_STATIC_DRAW);
+            if (m_VertexFormat == VertexFormat::Full) {
+                m_VertexBytes = m_Vertices.size_bytes();
+                glBufferData(GL_ARRAY_BUFFER, m_VertexBytes, m_Vertices.data(), GL_STATIC_DRAW);
+                SetVertexAttributes();
+            }
+            else {
+                // Bone ids and weights get a stream of their own, static meshes leave locations 5/6 disabled
+                auto packed   = PackVertices(m_Vertices);
+                m_VertexBytes = packed.size() * sizeof(PackedVertex);
+                glBufferData(GL_ARRAY_BUFFER, m_VertexBytes, packed.data(), GL_STATIC_DRAW);
+                SetPackedVertexAttributes();
 
+                if (auto skins = PackSkins(m_Vertices); !skins.empty()) {
+                    glGenBuffers(1, &m_SkinVBO);
+                    glBindBuffer(GL_ARRAY_BUFFER, m_SkinVBO);
+                    glBufferData(GL_ARRAY_BUFFER, skins.size() * sizeof(SkinVertex), skins.data(), GL_STATIC_DRAW);
+                    SetSkinAttributes();
+                    m_VertexBytes += skins.size() * sizeof(SkinVertex);
+                }
+            }
+
+            // 16 bit indices whenever they fit, the CPU side and the GeometryPool stay 32 bit
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int), &m_Indices[0], GL_STATIC_DRAW);
-
-            // set the vertex attribute pointers
-            // vertex Positions
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-            // vertex normals
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-            // vertex texture coords
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-            // vertex tangent
-            glEnableVertexAttribArray(3);
-            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-            // vertex bitangent
-            glEnableVertexAttribArray(4);
-            glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
-
-            // Bone Id & weights
-            glEnableVertexAttribArray(5);
-            glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-            glEnableVertexAttribArray(6);
-            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
-
-            glBindVertexArray(0);
+            if (m_Vertices.size() <= 65536) {
+                std::vector<uint16_t> indices(m_Indices.begin(), m_Indices.end());
+                m_IndexType = GL_UNSIGNED_SHORT;
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+            }
+            else {
+                m_IndexType = GL_UNSIGNED_INT;
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size_bytes(), m_Indices.data(), GL_STATIC_DRAW);
+            }
+
+            // Instance transform & entity id
+            InstanceBuffer::EnableAttributes();
+
+            RHI::BindVertexArray(0);
         }
 
         void Log()
@@ -131,46 +124,134 @@ namespace suplex {
 
         virtual void Render(const std::shared_ptr<Shader> shader)
         {
-            if (m_VAO == 0) { BindBuffer(); }
+            shader->Bind();
+            BindTextures(shader);
+
+            RHI::BindVertexArray(GetVAO());
+            Draw();
+            RHI::BindVertexArray(0);
 
+            RHI::ActiveTexture(0);
+        }
+
+        // Expects the shader to be bound already.
+        void BindTextures(const std::shared_ptr<Shader>& shader) const
+        {
             // bind appropriate textures
-            unsigned int diffuseNr  = 1;
-            unsigned int specularNr = 1;
-            unsigned int normalNr   = 1;
-            unsigned int heightNr   = 1;
             for (unsigned int i = 0; i < m_Textures.size(); i++) {
-                // retrieve texture number (the N in diffuse_textureN)
-                std::string number;
-                std::string name = m_Textures[i].GetType();
-                if (name == "DiffuseMap")
-                    number = std::to_string(diffuseNr++);
-                else if (name == "SpecularMap")
-                    number = std::to_string(specularNr++);  // transfer unsigned int to string
-                else if (name == "NormalMap")
-                    number = std::to_string(normalNr++);  // transfer unsigned int to string
-                else if (name == "HeightMap")
-                    number = std::to_string(heightNr++);  // transfer unsigned int to string
-
                 // glActiveTexture(GL_TEXTURE0 + i);  // active proper texture unit before binding
                 // glUniform1i(glGetUniformLocation(shader->GetID(), (name + number).c_str()), i);
                 // glBindTexture(GL_TEXTURE_2D, m_Textures[i].GetID());
-                debug("Bind Texture, Type is {}, Slot = {}", name, i);
-                shader->Bind();
-                shader->BindTexture(name, m_Textures[i].GetID(), i, SamplerType::Texture2D);
+                shader->BindTexture(m_Textures[i].GetType(), m_Textures[i].GetID(), i, SamplerType::Texture2D);
+            }
+        }
+
+        // Expects the VAO to be bound already, see RenderQueue::Submit. Always the full resolution level.
+        void Draw() const { glDrawElements(GL_TRIANGLES, m_Lods[0].indexCount, m_IndexType, 0); }
+
+        // Draws instanceCount copies of a level reading InstanceBuffer entries from baseInstance on.
+        void Draw(uint32_t instanceCount, uint32_t baseInstance, uint32_t lod = 0) const
+        {
+            auto& range  = GetLod(lod);
+            auto  offset = range.firstIndex * (m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
+            glDrawElementsInstancedBaseInstance(GL_TRIANGLES, range.indexCount, m_IndexType, reinterpret_cast<const void*>(offset),
+                                                instanceCount, baseInstance);
+        }
+
+        // Levels share the vertices and the index buffer, level 0 is the full mesh. Levels past the last clamp to it.
+        uint32_t       GetLodCount() const { return static_cast<uint32_t>(m_Lods.size()); }
+        const MeshLod& GetLod(uint32_t level) const { return m_Lods[std::min<size_t>(level, m_Lods.size() - 1)]; }
+
+        uint32_t GetVAO()
+        {
+            if (m_VAO == 0) { BindBuffer(); }
+            return m_VAO;
+        }
+
+        // Copies the mesh into the shared GeometryPool on first use.
+        const GeometryAllocation& GetPoolAllocation()
+        {
+            if (!m_PoolAllocated) {
+                m_PoolAllocation = GeometryPool::Allocate(m_Vertices, m_Indices);
+                m_PoolAllocated  = true;
             }
+            return m_PoolAllocation;
+        }
 
-            glBindVertexArray(m_VAO);
-            glDrawElements(GL_TRIANGLES, static_cast<uint32_t>(m_Indices.size()), GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+        // Geometry kept on the CPU side, either the import arrays or the mapped cache file.
+        size_t GetCPUBytes() const { return m_Vertices.size_bytes() + m_Indices.size_bytes(); }
 
-            glActiveTexture(GL_TEXTURE0);
+        // Own vertex/index buffers plus the GeometryPool copy, textures not included.
+        size_t GetGPUBytes() const
+        {
+            size_t indexSize = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+            size_t bytes     = m_VAO ? m_VertexBytes + m_Indices.size() * indexSize : 0;
+            if (m_PoolAllocated)
+                bytes += m_Vertices.size() * (sizeof(PackedVertex) + sizeof(SkinVertex)) + m_Indices.size_bytes();
+            return bytes;
+        }
+
+        // Layout of the own vertex buffers, Packed unless set otherwise. Rebuilds them on next use if they exist.
+        // The GeometryPool always holds PackedVertex.
+        void SetVertexFormat(VertexFormat format)
+        {
+            if (format == m_VertexFormat)
+                return;
+            m_VertexFormat = format;
+            if (m_VAO != 0)
+                Unbind();
+        }
+
+        void SetTextures(std::vector<Texture2D>&& textures) { m_Textures = std::move(textures); }
+
+        auto        GetVertices() const { return m_Vertices; }
+        auto        GetIndices() const { return m_Indices; }
+        const auto& GetLods() const { return m_Lods; }
+        const auto& GetTextures() const { return m_Textures; }
+        const auto& GetBounds() const { return m_Bounds; }
+        const auto& GetBoundingSphere() const { return m_BoundingSphere; }
+
+        // Local space bounds, the sphere is centered on the box and encloses every vertex.
+        void ComputeBounds()
+        {
+            m_Bounds = AABB();
+            for (auto& vertex : m_Vertices)
+                m_Bounds.Expand(vertex.position);
+
+            m_BoundingSphere.center = m_Bounds.GetCenter();
+            m_BoundingSphere.radius = 0.0f;
+            for (auto& vertex : m_Vertices)
+                m_BoundingSphere.radius = std::max(m_BoundingSphere.radius, glm::length(vertex.position - m_BoundingSphere.center));
         }
 
     protected:
-        std::vector<Vertex>    m_Vertices;
-        std::vector<uint32_t>  m_Indices;
+        // A single level over the whole index buffer unless the given chain is usable
+        void ValidateLods()
+        {
+            bool valid = !m_Lods.empty() && m_Lods.size() <= MaxMeshLods;
+            for (auto& lod : m_Lods)
+                valid = valid && lod.indexCount % 3 == 0 && size_t(lod.firstIndex) + lod.indexCount <= m_Indices.size();
+            if (!valid)
+                m_Lods = {{0, static_cast<uint32_t>(m_Indices.size())}};
+        }
+
+    protected:
+        // Immutable after construction, so copies of a mesh share the storage the views point into
+        std::span<const Vertex>     m_Vertices;
+        std::span<const uint32_t>   m_Indices;
+        std::shared_ptr<const void> m_Storage;
+
         std::vector<Texture2D> m_Textures;
-        uint32_t               m_VAO = 0, m_VBO = 0, m_EBO = 0;
+        uint32_t               m_VAO = 0, m_VBO = 0, m_SkinVBO = 0, m_EBO = 0;
+        GeometryAllocation     m_PoolAllocation;
+        bool                   m_PoolAllocated = false;  // empty meshes have an allocation of zero indices
+        AABB                   m_Bounds;
+        BoundingSphere         m_BoundingSphere;
+        std::vector<MeshLod>   m_Lods;
+
+        VertexFormat m_VertexFormat = VertexFormat::Packed;
+        size_t       m_VertexBytes  = 0;  // own vertex buffers, valid while m_VAO != 0
+        uint32_t     m_IndexType    = GL_UNSIGNED_INT;
     };
 
 }  // namespace suplex
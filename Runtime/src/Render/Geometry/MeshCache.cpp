@@ -0,0 +1,345 @@
+#include "Render/Geometry/MeshCache.hpp"
+#include "IO/Hash.hpp"
+#include "IO/MappedFile.hpp"
+#include "Render/Geometry/Model.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+namespace suplex {
+
+    std::string MeshCache::s_Directory = "Cache/Mesh";
+
+    namespace {
+        // Bump whenever the records below or the import processing change
+        constexpr uint32_t CacheVersion = 5;
+        constexpr uint32_t CacheMagic   = 0x48534D53;  // "SMSH"
+
+        static_assert(std::is_trivially_copyable_v<Vertex>, "vertices are written and mapped as raw bytes");
+
+        struct Header
+        {
+            uint32_t magic          = CacheMagic;
+            uint32_t version        = CacheVersion;
+            uint64_t key            = 0;
+            uint32_t vertexSize     = sizeof(Vertex);
+            uint32_t meshCount      = 0;
+            uint32_t textureCount   = 0;
+            uint32_t boneCount      = 0;
+            int32_t  boneCounter    = 0;
+            uint32_t nodeCount      = 0;
+            uint64_t meshesOffset   = 0;
+            uint64_t texturesOffset = 0;
+            uint64_t bonesOffset    = 0;
+            uint64_t nodesOffset    = 0;
+        };
+
+        struct MeshRecord
+        {
+            uint64_t  verticesOffset;
+            uint64_t  indicesOffset;
+            uint32_t  vertexCount;
+            uint32_t  indexCount;
+            uint32_t  firstTexture;
+            uint32_t  textureCount;
+            glm::vec3 boundsMin, boundsMax;
+            glm::vec3 sphereCenter;
+            float     sphereRadius;
+            uint32_t  lodCount;  // ranges of the index array, see GenerateLods
+            MeshLod   lods[MaxMeshLods];
+        };
+
+        struct TextureRecord
+        {
+            uint64_t typeOffset, pathOffset, embeddedOffset;
+            uint64_t embeddedSize;
+            uint32_t typeLength, pathLength;
+        };
+
+        struct BoneRecord
+        {
+            glm::mat4 offset;
+            uint64_t  nameOffset;
+            uint32_t  nameLength;
+            int32_t   id;
+        };
+
+        struct NodeRecord
+        {
+            glm::mat4 transform;
+            uint64_t  nameOffset;
+            uint32_t  nameLength;
+            int32_t   parent;
+            uint32_t  firstMesh;
+            uint32_t  meshCount;
+        };
+
+        class Writer {
+        public:
+            // Returns the offset of the data, aligned so arrays can be used in place once mapped
+            uint64_t Append(const void* data, size_t size, size_t alignment = 16)
+            {
+                m_Data.resize((m_Data.size() + alignment - 1) / alignment * alignment);
+                auto offset = m_Data.size();
+                m_Data.insert(m_Data.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+                return offset;
+            }
+
+            uint64_t Append(const std::string& string) { return Append(string.data(), string.size(), 1); }
+
+            template <class T>
+            uint64_t Append(const std::vector<T>& array)
+            {
+                return Append(array.data(), array.size() * sizeof(T));
+            }
+
+            void Patch(uint64_t offset, const void* data, size_t size) { memcpy(m_Data.data() + offset, data, size); }
+
+            const auto& GetData() const { return m_Data; }
+
+        private:
+            std::vector<uint8_t> m_Data;
+        };
+
+        class Reader {
+        public:
+            explicit Reader(const MappedFile& file) : m_File(file) {}
+
+            // nullptr if the range lies outside the file
+            template <class T>
+            const T* Get(uint64_t offset, uint64_t count = 1) const
+            {
+                if (offset > m_File.GetSize() || count > (m_File.GetSize() - offset) / sizeof(T))
+                    return nullptr;
+                return reinterpret_cast<const T*>(m_File.GetData() + offset);
+            }
+
+            bool GetString(uint64_t offset, uint32_t length, std::string& string) const
+            {
+                auto chars = Get<char>(offset, length);
+                if (!chars)
+                    return false;
+                string.assign(chars, length);
+                return true;
+            }
+
+        private:
+            const MappedFile& m_File;
+        };
+    }  // namespace
+
+    uint64_t MeshCache::GetKey(const std::string& sourcePath, uint32_t importFlags)
+    {
+        MappedFile source(sourcePath);
+        if (!source.IsOpen())
+            return 0;
+
+        uint32_t layout[] = {CacheVersion, importFlags, static_cast<uint32_t>(sizeof(Vertex))};
+        return Hash64(source.GetData(), source.GetSize(), Hash64(layout, sizeof(layout)));
+    }
+
+    std::string MeshCache::GetPath(uint64_t key) { return fmt::format("{}/{:016x}.mesh", s_Directory, key); }
+
+    bool MeshCache::Load(Model& model, uint64_t key, std::vector<std::vector<MeshTextureReference>>& textureReferences)
+    {
+        if (key == 0)
+            return false;
+
+        auto file = std::make_shared<MappedFile>(GetPath(key));
+        if (!file->IsOpen())
+            return false;
+
+        Reader reader(*file);
+        auto   header = reader.Get<Header>(0);
+        if (!header || header->magic != CacheMagic || header->version != CacheVersion || header->key != key ||
+            header->vertexSize != sizeof(Vertex)) {
+            spdlog::warn("Ignoring stale mesh cache entry {}", GetPath(key));
+            return false;
+        }
+
+        auto meshes   = reader.Get<MeshRecord>(header->meshesOffset, header->meshCount);
+        auto textures = reader.Get<TextureRecord>(header->texturesOffset, header->textureCount);
+        auto bones    = reader.Get<BoneRecord>(header->bonesOffset, header->boneCount);
+        auto nodes    = reader.Get<NodeRecord>(header->nodesOffset, header->nodeCount);
+        if (!meshes || !textures || !bones || !nodes)
+            return false;
+
+        std::map<std::string, BoneInfo> boneInfoMap;
+        for (uint32_t i = 0; i < header->boneCount; ++i) {
+            std::string name;
+            if (!reader.GetString(bones[i].nameOffset, bones[i].nameLength, name))
+                return false;
+            boneInfoMap[name] = {bones[i].id, bones[i].offset};
+        }
+
+        // Parents come first and the mesh ranges stay inside the mesh table, as written by ProcessNode
+        std::vector<ModelNode> nodeTable(header->nodeCount);
+        for (uint32_t i = 0; i < header->nodeCount; ++i) {
+            auto& record = nodes[i];
+            if (record.parent >= static_cast<int32_t>(i) || record.parent < -1)
+                return false;
+            if (record.firstMesh > header->meshCount || record.meshCount > header->meshCount - record.firstMesh)
+                return false;
+            if (!reader.GetString(record.nameOffset, record.nameLength, nodeTable[i].name))
+                return false;
+            nodeTable[i].transform = record.transform;
+            nodeTable[i].parent    = record.parent;
+            nodeTable[i].firstMesh = record.firstMesh;
+            nodeTable[i].meshCount = record.meshCount;
+        }
+
+        // Validate every range before creating any GL object
+        for (uint32_t i = 0; i < header->meshCount; ++i) {
+            auto& record = meshes[i];
+            if (!reader.Get<Vertex>(record.verticesOffset, record.vertexCount))
+                return false;
+            if (!reader.Get<uint32_t>(record.indicesOffset, record.indexCount))
+                return false;
+            if (record.firstTexture > header->textureCount || record.textureCount > header->textureCount - record.firstTexture)
+                return false;
+        }
+
+        std::vector<Mesh>                              loaded;
+        std::vector<std::vector<MeshTextureReference>> references(header->meshCount);
+        loaded.reserve(header->meshCount);
+        for (uint32_t i = 0; i < header->meshCount; ++i) {
+            auto& record = meshes[i];
+
+            for (uint32_t t = record.firstTexture; t < record.firstTexture + record.textureCount; ++t) {
+                auto&                texture = textures[t];
+                MeshTextureReference reference;
+                if (texture.embeddedSize) {
+                    reference.embeddedData = reader.Get<uint8_t>(texture.embeddedOffset, texture.embeddedSize);
+                    reference.embeddedSize = texture.embeddedSize;
+                    if (!reference.embeddedData)
+                        return false;
+                }
+                if (!reader.GetString(texture.typeOffset, texture.typeLength, reference.type))
+                    return false;
+                if (!reader.GetString(texture.pathOffset, texture.pathLength, reference.path))
+                    return false;
+                references[i].push_back(std::move(reference));
+            }
+
+            AABB           bounds{record.boundsMin, record.boundsMax};
+            BoundingSphere sphere{record.sphereCenter, record.sphereRadius};
+            auto           vertices = std::span(reader.Get<Vertex>(record.verticesOffset, record.vertexCount), record.vertexCount);
+            auto           indices  = std::span(reader.Get<uint32_t>(record.indicesOffset, record.indexCount), record.indexCount);
+            auto           lods     = std::vector<MeshLod>(record.lods, record.lods + std::min(record.lodCount, MaxMeshLods));
+            loaded.emplace_back(file, vertices, indices, std::vector<Texture2D>(), bounds, sphere, std::move(lods));
+        }
+
+        textureReferences   = std::move(references);
+        model.m_Meshes      = std::move(loaded);
+        model.m_Nodes       = std::move(nodeTable);
+        model.m_BoneInfoMap = std::move(boneInfoMap);
+        model.m_BoneCounter = header->boneCounter;
+        return true;
+    }
+
+    void MeshCache::Store(const Model& model, uint64_t key, const std::vector<std::vector<MeshTextureReference>>& textures)
+    {
+        if (key == 0 || textures.size() != model.m_Meshes.size())
+            return;
+
+        Writer writer;
+        Header header;
+        writer.Append(&header, sizeof(header));
+
+        std::vector<MeshRecord>    meshRecords;
+        std::vector<TextureRecord> textureRecords;
+        for (size_t i = 0; i < model.m_Meshes.size(); ++i) {
+            auto& mesh     = model.m_Meshes[i];
+            auto  vertices = mesh.GetVertices();
+            auto  indices  = mesh.GetIndices();
+
+            MeshRecord record{};
+            record.verticesOffset = writer.Append(vertices.data(), vertices.size_bytes());
+            record.indicesOffset  = writer.Append(indices.data(), indices.size_bytes());
+            record.vertexCount    = static_cast<uint32_t>(vertices.size());
+            record.indexCount     = static_cast<uint32_t>(indices.size());
+            record.firstTexture   = static_cast<uint32_t>(textureRecords.size());
+            record.textureCount   = static_cast<uint32_t>(textures[i].size());
+            record.boundsMin      = mesh.GetBounds().min;
+            record.boundsMax      = mesh.GetBounds().max;
+            record.sphereCenter   = mesh.GetBoundingSphere().center;
+            record.sphereRadius   = mesh.GetBoundingSphere().radius;
+            record.lodCount       = mesh.GetLodCount();
+            std::copy(mesh.GetLods().begin(), mesh.GetLods().end(), record.lods);
+            meshRecords.push_back(record);
+
+            for (auto& texture : textures[i]) {
+                TextureRecord textureRecord{};
+                textureRecord.typeOffset = writer.Append(texture.type);
+                textureRecord.typeLength = static_cast<uint32_t>(texture.type.size());
+                textureRecord.pathOffset = writer.Append(texture.path);
+                textureRecord.pathLength = static_cast<uint32_t>(texture.path.size());
+                if (texture.embeddedData) {
+                    textureRecord.embeddedOffset = writer.Append(texture.embeddedData, texture.embeddedSize);
+                    textureRecord.embeddedSize   = texture.embeddedSize;
+                }
+                textureRecords.push_back(textureRecord);
+            }
+        }
+
+        std::vector<BoneRecord> boneRecords;
+        for (auto& [name, info] : model.m_BoneInfoMap) {
+            BoneRecord record;
+            record.offset     = info.offset;
+            record.id         = info.id;
+            record.nameOffset = writer.Append(name);
+            record.nameLength = static_cast<uint32_t>(name.size());
+            boneRecords.push_back(record);
+        }
+
+        std::vector<NodeRecord> nodeRecords;
+        for (auto& node : model.m_Nodes) {
+            NodeRecord record;
+            record.transform  = node.transform;
+            record.nameOffset = writer.Append(node.name);
+            record.nameLength = static_cast<uint32_t>(node.name.size());
+            record.parent     = node.parent;
+            record.firstMesh  = node.firstMesh;
+            record.meshCount  = node.meshCount;
+            nodeRecords.push_back(record);
+        }
+
+        header.key            = key;
+        header.meshCount      = static_cast<uint32_t>(meshRecords.size());
+        header.textureCount   = static_cast<uint32_t>(textureRecords.size());
+        header.boneCount      = static_cast<uint32_t>(boneRecords.size());
+        header.boneCounter    = model.m_BoneCounter;
+        header.nodeCount      = static_cast<uint32_t>(nodeRecords.size());
+        header.meshesOffset   = writer.Append(meshRecords);
+        header.texturesOffset = writer.Append(textureRecords);
+        header.bonesOffset    = writer.Append(boneRecords);
+        header.nodesOffset    = writer.Append(nodeRecords);
+        writer.Patch(0, &header, sizeof(header));
+
+        // Written under a temporary name first, so an interrupted write never leaves a truncated entry behind
+        std::error_code error;
+        std::filesystem::create_directories(s_Directory, error);
+
+        auto path      = GetPath(key);
+        auto temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(writer.GetData().data()), writer.GetData().size());
+            if (!out) {
+                spdlog::warn("Failed to write mesh cache entry {}", path);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+            spdlog::warn("Failed to write mesh cache entry {}: {}", path, error.message());
+        else
+            spdlog::debug("Stored mesh cache entry {} ({} bytes)", path, writer.GetData().size());
+    }
+
+}  // namespace suplex
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace suplex {
+
+    class Model;
+
+    // A material texture as found during import. Embedded images point into the Assimp scene, or into the mapped
+    // cache file after Load.
+    struct MeshTextureReference
+    {
+        std::string    type;
+        std::string    path;  // relative to the model directory, empty for embedded images
+        const uint8_t* embeddedData = nullptr;
+        size_t         embeddedSize = 0;
+    };
+
+    // On-disk cache of imported models: final vertex/index arrays, bounds, texture references, the bone map and the node table.
+    // Entries are named by a hash of the source file content, the import flags and the cache layout, so editing the
+    // source or changing the flags simply misses. Cached files are memory mapped and the meshes upload straight from
+    // the mapping, which stays alive as long as one of the meshes does.
+    class MeshCache {
+    public:
+        static void SetDirectory(const std::string& directory) { s_Directory = directory; }
+
+        // 0 if the source file cannot be read.
+        static uint64_t    GetKey(const std::string& sourcePath, uint32_t importFlags);
+        static std::string GetPath(uint64_t key);
+
+        // Fills the model meshes, nodes and bone map, false on a miss or an unusable entry. No GL calls, the meshes are
+        // returned without textures and textures[i] receives the references of model.m_Meshes[i].
+        static bool Load(Model& model, uint64_t key, std::vector<std::vector<MeshTextureReference>>& textures);
+
+        // textures[i] are the references of model.m_Meshes[i].
+        static void Store(const Model& model, uint64_t key, const std::vector<std::vector<MeshTextureReference>>& textures);
+
+    private:
+        static std::string s_Directory;
+    };
+
+}  // namespace suplex
@@ -0,0 +1,608 @@
+#include "Render/Geometry/MeshOptimizer.hpp"
+#include "IO/Hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string.h>
+
+namespace suplex {
+
+    namespace {
+        // Cache modelled by the Forsyth scores, a bit larger than the FIFO of the statistics as recommended
+        constexpr int ForsythCacheSize = 32;
+
+        // Overdraw clusters may cost this much more ACMR than the cache optimised order they are cut from
+        constexpr float OverdrawThreshold = 1.05f;
+
+        // Levels of detail are not generated below this many triangles
+        constexpr size_t MinLodTriangles = 32;
+
+        // Planes through open border edges count this much more than the area of the triangles around them
+        constexpr float BorderWeight = 10.0f;
+
+        constexpr uint32_t Unused = UINT32_MAX;
+
+        // FIFO of post-transform cache entries by insertion time, Reset() empties it in O(1).
+        class FifoCache {
+        public:
+            FifoCache(size_t vertexCount, uint32_t size) : m_Times(vertexCount, 0), m_Size(size) {}
+
+            // True on a miss, which also inserts the vertex.
+            bool Miss(uint32_t vertex)
+            {
+                if (m_Times[vertex] != 0 && m_Time - m_Times[vertex] < m_Size)
+                    return false;
+                m_Times[vertex] = m_Time++;
+                return true;
+            }
+
+            void Reset() { m_Time += m_Size; }
+
+        private:
+            std::vector<uint64_t> m_Times;
+            uint64_t              m_Time = 1;
+            uint32_t              m_Size;
+        };
+
+        void DeduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+        {
+            size_t capacity = 1;
+            while (capacity < vertices.size() * 2)
+                capacity <<= 1;
+
+            // Open addressing over the compacted prefix, which is built in place
+            std::vector<uint32_t> table(capacity, Unused), remap(vertices.size());
+            uint32_t              unique = 0;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                size_t slot = Hash64(&vertices[i], sizeof(Vertex)) & (capacity - 1);
+                while (table[slot] != Unused && memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0)
+                    slot = (slot + 1) & (capacity - 1);
+
+                if (table[slot] == Unused) {
+                    table[slot]        = unique;
+                    vertices[unique++] = vertices[i];
+                }
+                remap[i] = table[slot];
+            }
+
+            vertices.resize(unique);
+            for (auto& index : indices)
+                index = remap[index];
+        }
+
+        float GetVertexScore(int cachePosition, uint32_t liveTriangles)
+        {
+            if (liveTriangles == 0)
+                return -1.0f;
+
+            // The last triangle's vertices get a fixed score, so its neighbours do not win just by being newest
+            float score = 0.0f;
+            if (cachePosition >= 0 && cachePosition < 3)
+                score = 0.75f;
+            else if (cachePosition >= 3)
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (ForsythCacheSize - 3), 1.5f);
+
+            // Vertices with few triangles left are finished first, so they can leave the cache
+            return score + 2.0f / std::sqrt(static_cast<float>(liveTriangles));
+        }
+
+        // T. Forsyth, Linear-Speed Vertex Cache Optimisation: greedily emits the best scoring triangle among those
+        // using a cached vertex, falling back to the next unused one in input order.
+        std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount)
+        {
+            size_t triangleCount = indices.size() / 3;
+
+            // Triangles of each vertex, the live ones are kept at the front of its range
+            std::vector<uint32_t> live(vertexCount, 0), offsets(vertexCount + 1, 0);
+            for (auto index : indices)
+                ++live[index];
+            for (size_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1] = offsets[v] + live[v];
+
+            std::vector<uint32_t> adjacency(indices.size()), cursors(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+                adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+            std::vector<int>   cachePositions(vertexCount, -1);
+            std::vector<float> vertexScores(vertexCount), triangleScores(triangleCount);
+            for (size_t v = 0; v < vertexCount; ++v)
+                vertexScores[v] = GetVertexScore(-1, live[v]);
+
+            auto scoreTriangle = [&](size_t t) {
+                return vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+            };
+
+            int64_t best      = -1;
+            float   bestScore = -1.0f;
+            for (size_t t = 0; t < triangleCount; ++t) {
+                triangleScores[t] = scoreTriangle(t);
+                if (triangleScores[t] > bestScore)
+                    best = static_cast<int64_t>(t), bestScore = triangleScores[t];
+            }
+
+            std::vector<uint32_t> result, cache, nextCache;
+            std::vector<bool>     emitted(triangleCount, false);
+            result.reserve(indices.size());
+            cache.reserve(ForsythCacheSize + 3);
+            nextCache.reserve(ForsythCacheSize + 3);
+
+            size_t scan = 0;
+            while (result.size() < indices.size()) {
+                if (best < 0) {
+                    while (emitted[scan])
+                        ++scan;
+                    best = static_cast<int64_t>(scan);
+                }
+
+                const uint32_t* triangle = &indices[best * 3];
+                emitted[best]            = true;
+                result.insert(result.end(), triangle, triangle + 3);
+
+                for (int k = 0; k < 3; ++k) {
+                    auto  vertex = triangle[k];
+                    auto* first  = &adjacency[offsets[vertex]];
+                    auto* last   = first + live[vertex];
+                    std::iter_swap(std::find(first, last, static_cast<uint32_t>(best)), last - 1);
+                    --live[vertex];
+                }
+
+                // Most recent first, what falls off the end is still rescored below
+                nextCache.assign(triangle, triangle + 3);
+                for (auto vertex : cache) {
+                    if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                        nextCache.push_back(vertex);
+                }
+                for (size_t i = 0; i < nextCache.size(); ++i) {
+                    auto vertex            = nextCache[i];
+                    cachePositions[vertex] = i < ForsythCacheSize ? static_cast<int>(i) : -1;
+                    vertexScores[vertex]   = GetVertexScore(cachePositions[vertex], live[vertex]);
+                }
+
+                best      = -1;
+                bestScore = -1.0f;
+                for (auto vertex : nextCache) {
+                    for (uint32_t i = offsets[vertex]; i < offsets[vertex] + live[vertex]; ++i) {
+                        auto t            = adjacency[i];
+                        triangleScores[t] = scoreTriangle(t);
+                        if (triangleScores[t] > bestScore)
+                            best = t, bestScore = triangleScores[t];
+                    }
+                }
+
+                nextCache.resize(std::min<size_t>(nextCache.size(), ForsythCacheSize));
+                std::swap(cache, nextCache);
+            }
+            return result;
+        }
+
+        // P. Sander, D. Nehab, J. Barczak, Fast Triangle Reordering for Vertex Locality and Reduced Overdraw: cuts the
+        // cache optimised order into clusters wherever the cache starts over, or where the cluster so far is within
+        // the threshold of its whole, then draws clusters facing away from the mesh center first.
+        std::vector<uint32_t> OptimizeOverdraw(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices)
+        {
+            size_t    triangleCount = indices.size() / 3;
+            FifoCache cache(vertices.size(), 16);
+
+            auto countMisses = [&](size_t t) {
+                uint32_t misses = 0;
+                for (int k = 0; k < 3; ++k)
+                    misses += cache.Miss(indices[t * 3 + k]);
+                return misses;
+            };
+
+            // Hard boundaries at triangles missing all three vertices
+            std::vector<size_t> hard;
+            for (size_t t = 0; t < triangleCount; ++t) {
+                if (countMisses(t) == 3)
+                    hard.push_back(t);
+            }
+            if (hard.empty() || hard[0] != 0)
+                hard.insert(hard.begin(), 0);
+            hard.push_back(triangleCount);
+
+            std::vector<size_t> clusters;
+            for (size_t c = 0; c + 1 < hard.size(); ++c) {
+                size_t begin = hard[c], end = hard[c + 1];
+
+                cache.Reset();
+                uint32_t clusterMisses = 0;
+                for (size_t t = begin; t < end; ++t)
+                    clusterMisses += countMisses(t);
+                float threshold = OverdrawThreshold * clusterMisses / static_cast<float>(end - begin);
+
+                cache.Reset();
+                clusters.push_back(begin);
+                uint32_t misses = 0, triangles = 0;
+                for (size_t t = begin; t < end; ++t) {
+                    misses += countMisses(t);
+                    ++triangles;
+                    if (t + 1 < end && misses <= threshold * triangles) {
+                        clusters.push_back(t + 1);
+                        cache.Reset();
+                        misses = triangles = 0;
+                    }
+                }
+            }
+            clusters.push_back(triangleCount);
+
+            glm::vec3 center(0.0f);
+            for (auto& vertex : vertices)
+                center += vertex.position;
+            center /= static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+            // Area weighted centroid and normal of each cluster
+            size_t             clusterCount = clusters.size() - 1;
+            std::vector<float> keys(clusterCount);
+            for (size_t c = 0; c < clusterCount; ++c) {
+                glm::vec3 centroid(0.0f), normal(0.0f);
+                float     area = 0.0f;
+                for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+                    auto& a = vertices[indices[t * 3]].position;
+                    auto& b = vertices[indices[t * 3 + 1]].position;
+                    auto& d = vertices[indices[t * 3 + 2]].position;
+
+                    auto  cross  = glm::cross(b - a, d - a);
+                    float length = glm::length(cross);
+                    centroid += (a + b + d) * (length / 3.0f);
+                    normal += cross;
+                    area += length;
+                }
+
+                float normalLength = glm::length(normal);
+                if (area > 0.0f && normalLength > 0.0f)
+                    keys[c] = glm::dot(centroid / area - center, normal / normalLength);
+            }
+
+            std::vector<uint32_t> order(clusterCount);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+            for (auto c : order)
+                result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+            return result;
+        }
+
+        void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+        {
+            std::vector<uint32_t> remap(vertices.size(), Unused);
+            uint32_t              next = 0;
+            for (auto& index : indices) {
+                if (remap[index] == Unused)
+                    remap[index] = next++;
+                index = remap[index];
+            }
+
+            std::vector<Vertex> reordered(next);
+            for (size_t v = 0; v < vertices.size(); ++v) {
+                if (remap[v] != Unused)
+                    reordered[remap[v]] = vertices[v];
+            }
+            vertices = std::move(reordered);
+        }
+
+        // Sum of squared distances to weighted planes, as the symmetric matrix A, vector b and scalar c of
+        // p^T A p + 2 b.p + c.
+        struct Quadric
+        {
+            double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0;
+
+            // The plane normal . p + distance = 0, normal of unit length
+            void AddPlane(const glm::vec3& normal, float distance, float weight)
+            {
+                double x = normal.x, y = normal.y, z = normal.z, d = distance;
+
+                a00 += weight * x * x, a11 += weight * y * y, a22 += weight * z * z;
+                a01 += weight * x * y, a02 += weight * x * z, a12 += weight * y * z;
+                b0 += weight * x * d, b1 += weight * y * d, b2 += weight * z * d;
+                c += weight * d * d;
+            }
+
+            void Add(const Quadric& q)
+            {
+                a00 += q.a00, a11 += q.a11, a22 += q.a22, a01 += q.a01, a02 += q.a02, a12 += q.a12;
+                b0 += q.b0, b1 += q.b1, b2 += q.b2, c += q.c;
+            }
+
+            double Evaluate(const glm::vec3& p) const
+            {
+                double x = p.x, y = p.y, z = p.z;
+                double error = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                               2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return std::max(error, 0.0);
+            }
+        };
+
+        uint64_t GetEdgeKey(uint32_t a, uint32_t b) { return a < b ? uint64_t(a) << 32 | b : uint64_t(b) << 32 | a; }
+
+        // Sorted keys of the edges of every triangle, an edge used once is on an open border
+        void CollectEdges(std::span<const uint32_t> indices, const std::vector<uint32_t>& positions, std::vector<uint64_t>& edges)
+        {
+            edges.clear();
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    auto a = positions[indices[i + k]], b = positions[indices[i + (k + 1) % 3]];
+                    if (a != b)
+                        edges.push_back(GetEdgeKey(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+        }
+
+        size_t CountEdge(const std::vector<uint64_t>& edges, uint64_t key)
+        {
+            auto range = std::equal_range(edges.begin(), edges.end(), key);
+            return static_cast<size_t>(range.second - range.first);
+        }
+    }  // namespace
+
+    void MeshOptimizationStats::Merge(const MeshOptimizationStats& other)
+    {
+        auto mix = [](float a, size_t weightA, float b, size_t weightB) {
+            return weightA + weightB ? (a * weightA + b * weightB) / static_cast<float>(weightA + weightB) : 0.0f;
+        };
+
+        before.acmr = mix(before.acmr, triangles, other.before.acmr, other.triangles);
+        after.acmr  = mix(after.acmr, triangles, other.after.acmr, other.triangles);
+        before.atvr = mix(before.atvr, verticesBefore, other.before.atvr, other.verticesBefore);
+        after.atvr  = mix(after.atvr, verticesAfter, other.after.atvr, other.verticesAfter);
+
+        verticesBefore += other.verticesBefore;
+        verticesAfter += other.verticesAfter;
+        triangles += other.triangles;
+    }
+
+    VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+    {
+        VertexCacheStats stats;
+        if (indices.size() < 3)
+            return stats;
+
+        FifoCache         cache(vertexCount, cacheSize);
+        std::vector<bool> referenced(vertexCount, false);
+        size_t            misses = 0, unique = 0;
+        for (auto index : indices) {
+            misses += cache.Miss(index);
+            if (!referenced[index]) {
+                referenced[index] = true;
+                ++unique;
+            }
+        }
+
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+        return stats;
+    }
+
+    std::vector<uint32_t> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> source, size_t targetCount)
+    {
+        std::vector<uint32_t> indices(source.begin(), source.end());
+        size_t                vertexCount = vertices.size();
+
+        // Vertices at the same position form one topological vertex, named after the first of them
+        std::vector<uint32_t> positions(vertexCount), variants(vertexCount, 0);
+        {
+            size_t capacity = 1;
+            while (capacity < vertexCount * 2)
+                capacity <<= 1;
+
+            std::vector<uint32_t> table(capacity, Unused);
+            for (uint32_t i = 0; i < vertexCount; ++i) {
+                auto&  position = vertices[i].position;
+                size_t slot     = Hash64(&position, sizeof(position)) & (capacity - 1);
+                while (table[slot] != Unused && memcmp(&vertices[table[slot]].position, &position, sizeof(position)) != 0)
+                    slot = (slot + 1) & (capacity - 1);
+
+                if (table[slot] == Unused)
+                    table[slot] = i;
+                positions[i] = table[slot];
+                ++variants[table[slot]];
+            }
+        }
+
+        // Split attributes and non-manifold edges lock a vertex, open borders restrict it
+        enum : uint8_t { Manifold, Border, Locked };
+        std::vector<uint8_t>  kinds(vertexCount, Manifold);
+        std::vector<uint64_t> edges;
+        CollectEdges(indices, positions, edges);
+        for (size_t i = 0; i < edges.size();) {
+            size_t count = 1;
+            while (i + count < edges.size() && edges[i + count] == edges[i])
+                ++count;
+
+            uint32_t ends[] = {static_cast<uint32_t>(edges[i] >> 32), static_cast<uint32_t>(edges[i])};
+            for (auto end : ends) {
+                if (count > 2)
+                    kinds[end] = Locked;
+                else if (count == 1 && kinds[end] == Manifold)
+                    kinds[end] = Border;
+            }
+            i += count;
+        }
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            if (variants[i] > 1)
+                kinds[i] = Locked;
+        }
+
+        // Area weighted triangle planes, plus planes perpendicular to the border edges that hold the outline in place
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            auto&     p0     = vertices[indices[i]].position;
+            glm::vec3 normal = glm::cross(vertices[indices[i + 1]].position - p0, vertices[indices[i + 2]].position - p0);
+            float     length = glm::length(normal);
+            if (length == 0.0f)
+                continue;
+
+            normal /= length;
+            for (int k = 0; k < 3; ++k)
+                quadrics[positions[indices[i + k]]].AddPlane(normal, -glm::dot(normal, p0), length * 0.5f);
+
+            for (int k = 0; k < 3; ++k) {
+                auto a = indices[i + k], b = indices[i + (k + 1) % 3];
+                if (CountEdge(edges, GetEdgeKey(positions[a], positions[b])) != 1)
+                    continue;
+
+                auto      edge  = vertices[b].position - vertices[a].position;
+                glm::vec3 plane = glm::cross(edge, normal);
+                float     size  = glm::length(plane);
+                if (size == 0.0f)
+                    continue;
+
+                plane /= size;
+                float distance = -glm::dot(plane, vertices[a].position);
+                quadrics[positions[a]].AddPlane(plane, distance, glm::dot(edge, edge) * BorderWeight);
+                quadrics[positions[b]].AddPlane(plane, distance, glm::dot(edge, edge) * BorderWeight);
+            }
+        }
+
+        struct Collapse
+        {
+            uint32_t from;  // a vertex without variants, so both its index and its position
+            uint32_t to;
+            double   cost;
+        };
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> offsets, adjacency, remap(vertexCount);
+        std::vector<uint8_t>  busy(vertexCount);
+        std::iota(remap.begin(), remap.end(), 0);
+
+        // Passes of independent collapses, cheapest first, until the target is met or nothing is left to collapse
+        while (indices.size() > targetCount) {
+            CollectEdges(indices, positions, edges);
+
+            offsets.assign(vertexCount + 1, 0);
+            for (auto index : indices)
+                ++offsets[positions[index] + 1];
+            for (size_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1] += offsets[v];
+            adjacency.resize(indices.size());
+            std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+                adjacency[cursors[positions[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+
+            collapses.clear();
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t pair[] = {indices[i + k], indices[i + (k + 1) % 3]};
+                    if (positions[pair[0]] == positions[pair[1]])
+                        continue;
+
+                    bool border = CountEdge(edges, GetEdgeKey(positions[pair[0]], positions[pair[1]])) == 1;
+                    for (int side = 0; side < 2; ++side) {
+                        auto from = pair[side], to = pair[1 - side];
+                        if (kinds[from] == Locked || (kinds[from] == Border && !border))
+                            continue;
+
+                        Quadric quadric = quadrics[from];
+                        quadric.Add(quadrics[positions[to]]);
+                        collapses.push_back({from, to, quadric.Evaluate(vertices[to].position)});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+            // Each collapse removes about two triangles; the one-ring of a collapse is left alone for the rest of the pass
+            size_t limit   = (indices.size() - targetCount) / 6 + 1;
+            size_t applied = 0;
+            std::fill(busy.begin(), busy.end(), 0);
+            for (auto& collapse : collapses) {
+                if (applied == limit)
+                    break;
+
+                auto from = collapse.from, to = positions[collapse.to];
+                if (busy[from] || busy[to])
+                    continue;
+
+                // Reject collapses that fold a remaining triangle over
+                bool flips = false;
+                for (uint32_t a = offsets[from]; a < offsets[from + 1] && !flips; ++a) {
+                    const uint32_t* triangle = &indices[adjacency[a] * 3];
+                    glm::vec3       before[3], after[3];
+                    bool            removed = false;
+                    for (int k = 0; k < 3; ++k) {
+                        removed |= positions[triangle[k]] == to;
+                        before[k] = vertices[triangle[k]].position;
+                        after[k]  = triangle[k] == from ? vertices[collapse.to].position : before[k];
+                    }
+                    if (removed)
+                        continue;
+
+                    auto normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    auto normalAfter  = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    flips = glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter);
+                }
+                if (flips)
+                    continue;
+
+                remap[from] = collapse.to;
+                quadrics[to].Add(quadrics[from]);
+                busy[to] = 1;
+                for (uint32_t a = offsets[from]; a < offsets[from + 1]; ++a) {
+                    for (int k = 0; k < 3; ++k)
+                        busy[positions[indices[adjacency[a] * 3 + k]]] = 1;
+                }
+                ++applied;
+            }
+            if (applied == 0)
+                break;
+
+            // Triangles that lost a corner are gone
+            size_t kept = 0;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                uint32_t a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+                if (positions[a] == positions[b] || positions[b] == positions[c] || positions[a] == positions[c])
+                    continue;
+                indices[kept++] = a;
+                indices[kept++] = b;
+                indices[kept++] = c;
+            }
+            indices.resize(kept);
+        }
+        return indices;
+    }
+
+    std::vector<MeshLod> GenerateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices)
+    {
+        std::vector<MeshLod> lods = {{0, static_cast<uint32_t>(indices.size())}};
+        if (indices.empty() || indices.size() % 3 != 0)
+            return lods;
+
+        while (lods.size() < MaxMeshLods) {
+            auto previous = lods.back();
+            if (previous.indexCount / 3 < MinLodTriangles * 2)
+                break;
+
+            auto source = std::span<const uint32_t>(indices).subspan(previous.firstIndex, previous.indexCount);
+            auto level  = SimplifyMesh(vertices, source, previous.indexCount / 6 * 3);
+            if (level.size() > previous.indexCount / 5 * 4)
+                break;
+
+            level = OptimizeVertexCache(level, vertices.size());
+            lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(level.size())});
+            indices.insert(indices.end(), level.begin(), level.end());
+        }
+        return lods;
+    }
+
+    MeshOptimizationStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        MeshOptimizationStats stats;
+        stats.verticesBefore = vertices.size();
+        stats.triangles      = indices.size() / 3;
+        stats.before         = AnalyzeVertexCache(indices, vertices.size());
+
+        if (!indices.empty() && indices.size() % 3 == 0) {
+            DeduplicateVertices(vertices, indices);
+            indices = OptimizeVertexCache(indices, vertices.size());
+            indices = OptimizeOverdraw(indices, vertices);
+            OptimizeVertexFetch(vertices, indices);
+        }
+
+        stats.verticesAfter = vertices.size();
+        stats.after         = AnalyzeVertexCache(indices, vertices.size());
+        return stats;
+    }
+
+}  // namespace suplex
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Render/Geometry/Vertex.hpp"
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Post-transform cache behaviour of an index buffer under a FIFO cache: misses per triangle (ACMR, 0.5 at best
+    // for a regular grid, 3 at worst) and per referenced vertex (ATVR, 1 is ideal).
+    struct VertexCacheStats
+    {
+        float acmr = 0.0f;
+        float atvr = 0.0f;
+    };
+
+    struct MeshOptimizationStats
+    {
+        size_t           verticesBefore = 0;
+        size_t           verticesAfter  = 0;
+        size_t           triangles      = 0;
+        VertexCacheStats before, after;
+
+        // Weighted by triangle count, for the totals of a model.
+        void Merge(const MeshOptimizationStats& other);
+    };
+
+    VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+    // Import time optimisation of a triangle list, in order:
+    //  - bitwise identical vertices are merged,
+    //  - triangles are reordered for the post-transform cache (Forsyth),
+    //  - runs of that order are sorted outside in against overdraw (Sander et al.), at most 5% ACMR worse,
+    //  - vertices are renumbered in first use order for fetch locality, unreferenced ones are dropped.
+    // Index counts that are not a multiple of 3 are left alone.
+    MeshOptimizationStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    // Range of one level of detail in a mesh index buffer, level 0 is the full mesh.
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    constexpr uint32_t MaxMeshLods = 4;
+
+    // Quadric error edge collapse (Garland & Heckbert) down to about targetCount indices. Vertices only collapse
+    // onto existing ones, so the result indexes the same vertex array. Vertices on attribute seams, hard edges or
+    // non-manifold edges are kept, those on open borders only collapse along the border.
+    std::vector<uint32_t> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t targetCount);
+
+    // Appends coarser levels to the index buffer of an optimized mesh, each simplified to about half of the one before
+    // and ordered for the vertex cache. Stops once a level would save less than a fifth. Returns the whole chain.
+    std::vector<MeshLod> GenerateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices);
+
+}  // namespace suplex
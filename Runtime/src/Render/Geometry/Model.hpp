@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Render/Geometry/Mesh.hpp"
+#include "Render/Geometry/MeshCache.hpp"
+#include "Render/Geometry/MeshOptimizer.hpp"
 #include "Render/Geometry/Model.hpp"
 #include "Render/Texture/Texture.hpp"
 #include "Render/Texture/Texture2D.hpp"
+#include "Render/Texture/TextureCache.hpp"
+#include "Render/Texture/TextureCook.hpp"
+#include "Thread/ThreadPool.hpp"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
@@ -17,6 +22,9 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/trigonometric.hpp>
 #include <intrin0.inl.h>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <spdlog/spdlog.h>
 #include <stdint.h>
 #include <utility>
@@ -75,8 +83,22 @@ namespace suplex {
         glm::mat4 offset;
     };
 
+    // One aiNode of the imported file, in pre-order so parents come first and every subtree is contiguous.
+    struct ModelNode
+    {
+        std::string name;
+        glm::mat4   transform{1.0f};  // local to the parent node
+        int32_t     parent    = -1;
+        uint32_t    firstMesh = 0;    // the node's meshes are m_Meshes[firstMesh, firstMesh + meshCount)
+        uint32_t    meshCount = 0;
+    };
+
     class Model {
     public:
+        // Part of the mesh cache key, changing them invalidates cached imports
+        static constexpr uint32_t ImportFlags =
+            aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
         Model() = default;
 
         Model(std::string const& path)
@@ -87,6 +109,9 @@ namespace suplex {
                 debug("Load model {} complete", path);
         }
 
+        // Procedural model, e.g. the placeholder drawn while an import is in flight
+        explicit Model(std::vector<Mesh>&& meshes) : m_Meshes(std::move(meshes)) { ComputeBounds(); }
+
         ~Model()
         {
             // for (auto& mesh : m_Meshes) { mesh.Unbind(); }
@@ -95,22 +120,59 @@ namespace suplex {
         void OnUpdate(float ts) {}
 
         auto& GetMeshes() { return m_Meshes; }
-        auto& GetMaterialIndex() { return m_MaterialIndex; }
         auto& GetFilePath() { return m_FilePath; }
 
-        void SetMaterialIndex(uint32_t materialIndex) { m_MaterialIndex = materialIndex; }
+        // Deletes the GL objects of every mesh and drops its texture references, see AssetManager::CollectGarbage.
+        // Node models only borrow the GL objects of their source, which keeps it alive, so they have nothing to release.
+        void Release()
+        {
+            if (m_Source)
+                return;
+            for (auto& mesh : m_Meshes) {
+                for (auto& texture : mesh.GetTextures())
+                    TextureCache::Release(texture);
+                mesh.Unbind();
+            }
+        }
 
         // void AddMesh(const Mesh& mesh) { m_Meshes.emplace_back(mesh); }
 
+        // Import() followed by a complete Upload(), all on the calling thread.
         bool LoadModel()
+        {
+            if (!Import())
+                return false;
+
+            size_t budget = SIZE_MAX;
+            Upload(budget);
+            return true;
+        }
+
+        // CPU half of LoadModel: imports the file (or maps an earlier import from the MeshCache) and decodes the
+        // material textures. Makes no GL calls, so it may run on a worker thread while nothing else uses the model.
+        bool Import()
         {
             info("Load Model at path {}", m_FilePath);
             std::string path = m_FilePath;
             m_Meshes.clear();
+            m_Nodes.clear();
+            m_BoneInfoMap.clear();
+            m_BoneCounter    = 0;
+            m_UploadedMeshes = 0;
+            m_Directory      = path.substr(0, path.find_last_of('/'));
+
+            // Repeat loads map the result of an earlier import instead of running Assimp
+            auto cacheKey = MeshCache::GetKey(path, ImportFlags);
+            if (MeshCache::Load(*this, cacheKey, m_TextureReferences)) {
+                ComputeBounds();
+                DecodeTextures();
+                debug("Loaded {} from the mesh cache", path);
+                return true;
+            }
+
             // read file via ASSIMP
             Assimp::Importer importer;
-            const aiScene*   scene = importer.ReadFile(path.data(), aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-                                                                        aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+            const aiScene*   scene = importer.ReadFile(path.data(), ImportFlags);
             // check for errors
             if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)  // if is Not Zero
             {
@@ -118,22 +180,128 @@ namespace suplex {
                 return false;
             }
 
-            auto suffix = path.substr(path.find_last_of('.') + 1);
-            m_Directory = path.substr(0, path.find_last_of('/'));
             // process ASSIMP's root node recursively
+            m_OptimizationStats = MeshOptimizationStats();
             ProcessNode(scene->mRootNode, scene);
+            ComputeBounds();
+
+            auto& stats = m_OptimizationStats;
+            info("Optimized {}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", path, stats.verticesBefore,
+                 stats.verticesAfter, stats.before.acmr, stats.after.acmr, stats.before.atvr, stats.after.atvr);
+
+            // Embedded textures point into the scene, so they are stored and decoded before the importer goes away
+            MeshCache::Store(*this, cacheKey, m_TextureReferences);
+            DecodeTextures();
             return true;
         }
 
+        // GL half of LoadModel: creates the buffers and textures of the imported meshes in order while budget bytes
+        // are left, a mesh larger than the budget still goes through. True once every mesh is uploaded.
+        // Each texture slot holds a TextureCache reference until Release().
+        bool Upload(size_t& budget)
+        {
+            for (; m_UploadedMeshes < m_Meshes.size(); ++m_UploadedMeshes) {
+                if (budget == 0)
+                    return false;
+
+                auto&                  mesh  = m_Meshes[m_UploadedMeshes];
+                size_t                 bytes = mesh.GetCPUBytes();
+                std::vector<Texture2D> textures;
+                for (auto& [type, key] : m_PendingTextures[m_UploadedMeshes]) {
+                    // The first slot using an image uploads it (unless it was cached already), later ones hit the cache
+                    auto& image = m_DecodedTextures[key];
+                    bytes += image.GetSize();
+
+                    auto texture = TextureCache::Acquire(key, std::move(image));
+                    texture.SetType(type);
+                    textures.push_back(texture);
+                    image = TextureImage();
+                }
+                mesh.SetTextures(std::move(textures));
+                mesh.BindBuffer();
+                budget -= std::min(budget, bytes);
+            }
+
+            m_PendingTextures.clear();
+            m_DecodedTextures.clear();
+            return true;
+        }
+
+        const auto& GetBounds() const { return m_Bounds; }
+        const auto& GetBoundingSphere() const { return m_BoundingSphere; }
+
+        const auto& GetNodes() const { return m_Nodes; }
+
+        // Index in the node table of the source model for node models, -1 for models loaded from a file.
+        int32_t GetSourceNode() const { return m_SourceNode; }
+
+        // The meshes of one node of an uploaded model, drawn with the node's world transform by the entity Scene::InstantiateModel
+        // creates for it. Shared while anyone uses it, so every entity of the same node batches together.
+        static std::shared_ptr<Model> GetNodeModel(const std::shared_ptr<Model>& source, size_t node)
+        {
+            if (node >= source->m_Nodes.size())
+                return nullptr;
+
+            source->m_NodeModels.resize(source->m_Nodes.size());
+            if (auto model = source->m_NodeModels[node].lock())
+                return model;
+
+            // Copies of uploaded meshes refer to the same buffers and textures
+            auto& record = source->m_Nodes[node];
+            auto  first  = source->m_Meshes.begin() + record.firstMesh;
+            auto  model  = std::make_shared<Model>(std::vector<Mesh>(first, first + record.meshCount));
+            model->m_FilePath    = source->m_FilePath;
+            model->m_Directory   = source->m_Directory;
+            model->m_BoneInfoMap = source->m_BoneInfoMap;
+            model->m_BoneCounter = source->m_BoneCounter;
+            model->m_Source      = source;
+            model->m_SourceNode  = static_cast<int32_t>(node);
+
+            source->m_NodeModels[node] = model;
+            return model;
+        }
+
         auto& GetBoneInfoMap() { return m_BoneInfoMap; }
         int&  GetBoneCount() { return m_BoneCounter; }
 
+        // Totals of the last Assimp import, a MeshCache hit leaves them untouched (cached meshes are optimized already).
+        const auto& GetOptimizationStats() const { return m_OptimizationStats; }
+
+        // Levels of the mesh with the most, entities pick one for all meshes and each mesh clamps it to its own chain.
+        uint32_t GetLodCount() const
+        {
+            uint32_t count = 1;
+            for (auto& mesh : m_Meshes)
+                count = std::max(count, mesh.GetLodCount());
+            return count;
+        }
+
     private:
+        // Union of the mesh bounds. The node transforms are not applied to the meshes, drawing the whole model places every mesh
+        // at the origin, the entities of Scene::InstantiateModel carry the node transforms instead.
+        void ComputeBounds()
+        {
+            m_Bounds = AABB();
+            for (auto& mesh : m_Meshes)
+                m_Bounds.Merge(mesh.GetBounds());
+
+            m_BoundingSphere.center = m_Bounds.GetCenter();
+            m_BoundingSphere.radius = 0.0f;
+            for (auto& mesh : m_Meshes) {
+                auto& sphere            = mesh.GetBoundingSphere();
+                m_BoundingSphere.radius = std::max(m_BoundingSphere.radius, glm::length(sphere.center - m_BoundingSphere.center) + sphere.radius);
+            }
+        }
+
         // processes a node in a recursive fashion. Processes each individual
         // mesh located at the node and repeats this process on its children
-        // nodes (if any).
-        void ProcessNode(aiNode* node, const aiScene* scene)
+        // nodes (if any). Every node is recorded in m_Nodes with its meshes.
+        void ProcessNode(aiNode* node, const aiScene* scene, int32_t parent = -1)
         {
+            auto index = static_cast<int32_t>(m_Nodes.size());
+            m_Nodes.push_back({node->mName.C_Str(), utils::ConvertMatrixToGLMFormat(node->mTransformation), parent,
+                               static_cast<uint32_t>(m_Meshes.size()), node->mNumMeshes});
+
             // process each mesh located at the current node
             for (unsigned int i = 0; i < node->mNumMeshes; i++) {
                 // the node object only contains indices to index the actual
@@ -146,16 +314,15 @@ namespace suplex {
             // after we've processed all of the meshes (if any) we then
             // recursively process each of the children nodes
             for (unsigned int i = 0; i < node->mNumChildren; i++) {
-                ProcessNode(node->mChildren[i], scene);
+                ProcessNode(node->mChildren[i], scene, index);
             }
         }
 
         Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene)
         {
             // data to fill
-            std::vector<Vertex>    vertices;
-            std::vector<uint32_t>  indices;
-            std::vector<Texture2D> textures;
+            std::vector<Vertex>   vertices;
+            std::vector<uint32_t> indices;
 
             // walk through each of the mesh's vertices
             for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -204,24 +371,24 @@ namespace suplex {
                 for (unsigned int j = 0; j < face.mNumIndices; j++)
                     indices.push_back(face.mIndices[j]);
             }
+            m_OptimizationStats.Merge(OptimizeMesh(vertices, indices));
+            auto lods = GenerateLods(vertices, indices);
+
             // process materials
             aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            m_TextureReferences.emplace_back();
 
             // 1. diffuse maps
-            std::vector<Texture2D> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, "DiffuseMap", scene);
-            textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+            LoadMaterialTextures(material, aiTextureType_DIFFUSE, "DiffuseMap", scene);
             // 2. specular maps
-            std::vector<Texture2D> specularMaps = LoadMaterialTextures(material, aiTextureType_SPECULAR, "SpecularMap", scene);
-            textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+            LoadMaterialTextures(material, aiTextureType_SPECULAR, "SpecularMap", scene);
             // 3. normal maps
-            std::vector<Texture2D> normalMaps = LoadMaterialTextures(material, aiTextureType_HEIGHT, "NormalMap", scene);
-            textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+            LoadMaterialTextures(material, aiTextureType_HEIGHT, "NormalMap", scene);
             // 4. height maps
-            std::vector<Texture2D> heightMaps = LoadMaterialTextures(material, aiTextureType_AMBIENT, "HeightMap", scene);
-            textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
+            LoadMaterialTextures(material, aiTextureType_AMBIENT, "HeightMap", scene);
 
-            // return a mesh object created from the extracted mesh data
-            return Mesh(std::move(vertices), std::move(indices), std::move(textures));
+            // return a mesh object created from the extracted mesh data, textures are attached by Upload()
+            return Mesh(std::move(vertices), std::move(indices), {}, std::move(lods));
         }
 
         void ProcessBoneWeight(std::vector<Vertex>& vertices, aiMesh* mesh, const aiScene* scene)
@@ -253,44 +420,103 @@ namespace suplex {
             }
         }
 
-        // checks all material textures of a given type and loads the textures
-        // if they're not loaded yet. the required info is returned as a Texture2D struct.
-        std::vector<Texture2D> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName, const aiScene* scene)
+        // records all material textures of a given type for the current mesh, DecodeTextures() decodes them and
+        // Upload() gets them from the TextureCache.
+        void LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName, const aiScene* scene)
         {
-            std::vector<Texture2D> textures;
             for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
                 aiString str;
                 mat->GetTexture(type, i, &str);
 
-                auto      embeddedTexture = scene->GetEmbeddedTexture(str.C_Str());
-                Texture2D texture;
-
-                if (embeddedTexture) {
-                    texture.LoadData(embeddedTexture, TextureFormat::RGB);
+                // Embedded FBX textures are a compressed image file (mHeight == 0)
+                MeshTextureReference reference;
+                reference.type = typeName;
+                if (auto embeddedTexture = scene->GetEmbeddedTexture(str.C_Str())) {
+                    reference.embeddedData = reinterpret_cast<const uint8_t*>(embeddedTexture->pcData);
+                    reference.embeddedSize = embeddedTexture->mHeight == 0 ? embeddedTexture->mWidth
+                                                                           : embeddedTexture->mWidth * embeddedTexture->mHeight;
                 }
                 else {
-                    // To prevent temporary object been constructed
-                    // use emplace_back here instead of push_back(Texture2D(str.C_Str())))
-                    auto textureFilename = m_Directory + "/" + std::string(str.C_Str());
-                    debug("Try to find {} {}", typeName, textureFilename);
-                    texture.LoadData(textureFilename, TextureFormat::RGB);
+                    reference.path = str.C_Str();
                 }
 
-                texture.SetType(typeName);
-                textures.push_back(texture);
+                m_TextureReferences.back().push_back(std::move(reference));
             }
+        }
 
-            return textures;
+        // Turns the texture references into TextureCache keys and cooks every distinct image once, in parallel.
+        // Only diffuse maps hold sRGB color, normal/specular/height data is filtered as stored.
+        void DecodeTextures()
+        {
+            struct PendingDecode
+            {
+                TextureImage*               image;
+                const MeshTextureReference* reference;
+                TextureUsage                usage;
+            };
+            std::vector<PendingDecode> decodes;
+
+            m_PendingTextures.clear();
+            m_DecodedTextures.clear();
+            for (auto& references : m_TextureReferences) {
+                auto& pending = m_PendingTextures.emplace_back();
+                for (auto& reference : references) {
+                    auto usage = reference.type == "DiffuseMap"  ? TextureUsage::Color
+                               : reference.type == "NormalMap" ? TextureUsage::Normal
+                                                               : TextureUsage::Data;
+                    auto path  = m_Directory + "/" + reference.path;
+                    auto key   = reference.embeddedData
+                                     ? TextureCache::GetKey(reference.embeddedData, reference.embeddedSize, usage)
+                                     : TextureCache::GetKey(path, TextureFormat::RGB, usage);
+                    auto [image, inserted] = m_DecodedTextures.try_emplace(key);
+                    if (inserted)
+                        decodes.push_back({&image->second, &reference, usage});
+                    pending.push_back({reference.type, key});
+                }
+            }
+
+            ThreadPool::ParallelFor(decodes.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    auto [image, reference, usage] = decodes[i];
+                    if (reference->embeddedData)
+                        *image = TextureCook::Cook(reference->embeddedData, reference->embeddedSize, usage);
+                    else
+                        *image = TextureCook::Cook(m_Directory + "/" + reference->path, usage);
+                }
+            });
+            m_TextureReferences.clear();
         }
 
     public:
         std::map<std::string, BoneInfo> m_BoneInfoMap;
         int                             m_BoneCounter = 0;
 
-        std::vector<Mesh> m_Meshes;
-        std::string       m_Directory;
-        std::string       m_FilePath;
+        std::vector<Mesh>      m_Meshes;
+        std::vector<ModelNode> m_Nodes;
+        std::string            m_Directory;
+        std::string            m_FilePath;
 
-        uint32_t m_MaterialIndex = 0;
+        AABB           m_Bounds;
+        BoundingSphere m_BoundingSphere;
+
+    private:
+        struct PendingTexture
+        {
+            std::string type, key;
+        };
+
+        // Per mesh, filled during an import for MeshCache::Store and DecodeTextures
+        std::vector<std::vector<MeshTextureReference>> m_TextureReferences;
+        MeshOptimizationStats                          m_OptimizationStats;
+
+        // Between Import() and Upload(): per mesh texture slots and the decoded images by TextureCache key
+        std::vector<std::vector<PendingTexture>>      m_PendingTextures;
+        std::unordered_map<std::string, TextureImage> m_DecodedTextures;
+        size_t                                        m_UploadedMeshes = 0;
+
+        // See GetNodeModel
+        std::vector<std::weak_ptr<Model>> m_NodeModels;
+        std::shared_ptr<Model>            m_Source;
+        int32_t                           m_SourceNode = -1;
     };
 }  // namespace suplex
\ No newline at end of file
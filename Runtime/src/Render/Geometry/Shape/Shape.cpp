@@ -1,5 +1,6 @@
 #include "Shape.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
+#include "Render/RHI.hpp"
 #include <glm/gtc/type_ptr.hpp>
 #include <memory>
 #include <stdint.h>
@@ -30,7 +31,7 @@ namespace suplex {
                 // setup plane VAO
                 glGenVertexArrays(1, &quadVAO);
                 glGenBuffers(1, &quadVBO);
-                glBindVertexArray(quadVAO);
+                RHI::BindVertexArray(quadVAO);
                 glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
                 glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
                 glEnableVertexAttribArray(0);
@@ -38,9 +39,9 @@ namespace suplex {
                 glEnableVertexAttribArray(1);
                 glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
             }
-            glBindVertexArray(quadVAO);
+            RHI::BindVertexArray(quadVAO);
             glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            glBindVertexArray(0);
+            RHI::BindVertexArray(0);
         }
 
         void RenderCube(const std::shared_ptr<Shader> shader)
@@ -103,7 +104,7 @@ namespace suplex {
                 glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
                 glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
                 // link vertex attributes
-                glBindVertexArray(cubeVAO);
+                RHI::BindVertexArray(cubeVAO);
                 glEnableVertexAttribArray(0);
                 glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
                 glEnableVertexAttribArray(1);
@@ -111,12 +112,12 @@ namespace suplex {
                 glEnableVertexAttribArray(2);
                 glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
                 glBindBuffer(GL_ARRAY_BUFFER, 0);
-                glBindVertexArray(0);
+                RHI::BindVertexArray(0);
             }
             // render Cube
-            glBindVertexArray(cubeVAO);
+            RHI::BindVertexArray(cubeVAO);
             glDrawArrays(GL_TRIANGLES, 0, 36);
-            glBindVertexArray(0);
+            RHI::BindVertexArray(0);
         }
 
         void RenderSphere(const std::shared_ptr<Shader> shader)
@@ -188,7 +189,7 @@ namespace suplex {
                         data.push_back(uv[i].y);
                     }
                 }
-                glBindVertexArray(sphereVAO);
+                RHI::BindVertexArray(sphereVAO);
                 glBindBuffer(GL_ARRAY_BUFFER, vbo);
                 glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
                 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
@@ -202,7 +203,7 @@ namespace suplex {
                 glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
             }
 
-            glBindVertexArray(sphereVAO);
+            RHI::BindVertexArray(sphereVAO);
             glDrawElements(GL_TRIANGLE_STRIP, indexCount, GL_UNSIGNED_INT, 0);
         }
 
@@ -239,7 +240,7 @@ namespace suplex {
                 }
 
                 glGenVertexArrays(1, &gridVAO);
-                glBindVertexArray(gridVAO);
+                RHI::BindVertexArray(gridVAO);
 
                 glGenBuffers(1, &gridVBO);
                 glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
@@ -252,15 +253,15 @@ namespace suplex {
                 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
                 glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(glm::uvec4), glm::value_ptr(indices[0]), GL_STATIC_DRAW);
 
-                glBindVertexArray(0);
+                RHI::BindVertexArray(0);
                 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
                 glBindBuffer(GL_ARRAY_BUFFER, 0);
 
                 length = (GLuint)indices.size() * 4;
             }
-            glBindVertexArray(gridVAO);
+            RHI::BindVertexArray(gridVAO);
             glDrawElements(GL_LINES, length, GL_UNSIGNED_INT, NULL);
-            glBindVertexArray(0);
+            RHI::BindVertexArray(0);
         }
     }  // namespace utils
 }  // namespace suplex
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Render/Geometry/Vertex.hpp"
+#include "Render/Texture/TextureImage.hpp"
+#include "Thread/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace suplex {
+
+    namespace {
+        // About this many vertices per ParallelFor chunk
+        constexpr size_t VerticesPerTask = 16384;
+
+        constexpr int MaxSkinBoneID = UINT16_MAX;
+
+        int32_t ToSnorm(float value, float scale)
+        {
+            return static_cast<int32_t>(std::round(std::clamp(value, -1.0f, 1.0f) * scale));
+        }
+
+        // GL_INT_2_10_10_10_REV, x in the low bits
+        uint32_t PackSnorm1010102(const glm::vec3& xyz, float w)
+        {
+            uint32_t packed = 0;
+            for (int c = 0; c < 3; ++c)
+                packed |= (static_cast<uint32_t>(ToSnorm(xyz[c], 511.0f)) & 0x3FF) << (10 * c);
+            return packed | (static_cast<uint32_t>(ToSnorm(w, 1.0f)) & 0x3) << 30;
+        }
+
+        glm::vec3 Normalize(const glm::vec3& v)
+        {
+            float length = glm::length(v);
+            return length > 1e-12f ? v / length : glm::vec3(0.0f);
+        }
+    }  // namespace
+
+    PackedVertex PackVertex(const Vertex& vertex)
+    {
+        // Gram-Schmidt, the bitangent only survives as the handedness of the frame
+        auto  normal  = Normalize(vertex.normal);
+        auto  tangent = Normalize(vertex.tangent - normal * glm::dot(normal, vertex.tangent));
+        float sign    = glm::dot(glm::cross(normal, tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+
+        PackedVertex packed;
+        packed.position    = vertex.position;
+        packed.normal      = PackSnorm1010102(normal, 0.0f);
+        packed.tangent     = PackSnorm1010102(tangent, sign);
+        packed.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+        packed.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+        return packed;
+    }
+
+    SkinVertex PackSkin(const Vertex& vertex)
+    {
+        float total = 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+            if (vertex.boneIDs[i] >= 0 && vertex.boneIDs[i] <= MaxSkinBoneID && vertex.weights[i] > 0.0f)
+                total += vertex.weights[i];
+        }
+
+        SkinVertex skin;
+        if (total <= 0.0f)
+            return skin;
+
+        // Renormalized so the weights still sum to one, the rounding error goes to the largest
+        int sum = 0, largest = 0;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+            if (vertex.boneIDs[i] < 0 || vertex.boneIDs[i] > MaxSkinBoneID || vertex.weights[i] <= 0.0f)
+                continue;
+
+            skin.boneIDs[i] = static_cast<uint16_t>(vertex.boneIDs[i]);
+            skin.weights[i] = static_cast<uint8_t>(std::lround(vertex.weights[i] / total * 255.0f));
+            sum += skin.weights[i];
+            if (skin.weights[i] > skin.weights[largest])
+                largest = i;
+        }
+        skin.weights[largest] = static_cast<uint8_t>(skin.weights[largest] + 255 - sum);
+        return skin;
+    }
+
+    std::vector<PackedVertex> PackVertices(std::span<const Vertex> vertices)
+    {
+        std::vector<PackedVertex> packed(vertices.size());
+        ThreadPool::ParallelFor(vertices.size(), VerticesPerTask, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                packed[i] = PackVertex(vertices[i]);
+        });
+        return packed;
+    }
+
+    std::vector<SkinVertex> PackSkins(std::span<const Vertex> vertices)
+    {
+        bool   skinned  = false;
+        size_t outRange = 0;
+        for (auto& vertex : vertices) {
+            for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+                if (vertex.boneIDs[i] >= 0 && vertex.weights[i] > 0.0f) {
+                    skinned = true;
+                    outRange += vertex.boneIDs[i] > MaxSkinBoneID;
+                }
+            }
+        }
+        if (!skinned)
+            return {};
+        if (outRange > 0)
+            spdlog::warn("{} bone influences reference ids past {}, they are left out of the skin stream", outRange, MaxSkinBoneID);
+
+        std::vector<SkinVertex> skins(vertices.size());
+        ThreadPool::ParallelFor(vertices.size(), VerticesPerTask, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                skins[i] = PackSkin(vertices[i]);
+        });
+        return skins;
+    }
+
+}  // namespace suplex
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "glad/glad.h"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <span>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    constexpr int MAX_BONE_INFLUENCE = 4;
+
+    struct Vertex
+    {
+        glm::vec3 position  = {0, 0, 0};
+        glm::vec3 normal    = {0, 0, 0};
+        glm::vec2 texCoord  = {0, 0};
+        glm::vec3 tangent   = {0, 0, 0};
+        glm::vec3 bitangent = {0, 0, 0};
+
+        int   boneIDs[MAX_BONE_INFLUENCE]{-1};
+        float weights[MAX_BONE_INFLUENCE]{0.0f};
+
+        Vertex()
+        {
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+                boneIDs[i] = -1;
+                weights[i] = 0.0f;
+            }
+        }
+
+        void Reset()
+        {
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+                boneIDs[i] = -1;
+                weights[i] = 0.0f;
+            }
+        }
+
+        // Fills the first free slot. Past MAX_BONE_INFLUENCE the weakest influence is replaced if this one is stronger.
+        void SetBoneData(int boneID, float weight)
+        {
+            int slot = 0;
+            for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+                if (boneIDs[i] < 0) {
+                    slot = i;
+                    break;
+                }
+                if (weights[i] < weights[slot])
+                    slot = i;
+            }
+            if (boneIDs[slot] >= 0 && weights[slot] >= weight)
+                return;
+
+            boneIDs[slot] = boneID;
+            weights[slot] = weight;
+        }
+    };
+
+    // Attribute layout of Vertex for the currently bound vertex array and GL_ARRAY_BUFFER, locations 0..6.
+    inline void SetVertexAttributes()
+    {
+        // set the vertex attribute pointers
+        // vertex Positions
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        // vertex normals
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+        // vertex texture coords
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+        // vertex tangent
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+        // vertex bitangent
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
+
+        // Bone Id & weights. The shaders read the ids as uvec4 like the packed stream, unused slots (-1) have no weight
+        glEnableVertexAttribArray(5);
+        glVertexAttribIPointer(5, 4, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
+    }
+
+    // Layout of the GPU vertex buffers. Vertex itself stays the import and MeshCache format, Full uploads it as is.
+    enum class VertexFormat { Full, Packed };
+
+    // Packed stream of every mesh, 24 of the 88 bytes of Vertex. Normal and tangent are signed 10:10:10:2 that the
+    // vertex fetch turns back into floats, the tangent's w is the bitangent sign. UVs are half floats.
+    struct PackedVertex
+    {
+        glm::vec3 position{0.0f};
+        uint32_t  normal  = 0;
+        uint32_t  tangent = 0;
+        uint16_t  texCoord[2]{};
+    };
+
+    // Second stream, only uploaded for meshes with bone weights. Weights are unorm8 summing to 255, unused slots are 0.
+    // Ids are 16 bit, rigs past 256 bones (face rigs, merged skeletons) are common enough that 8 would drop influences.
+    struct SkinVertex
+    {
+        uint16_t boneIDs[MAX_BONE_INFLUENCE]{};
+        uint8_t  weights[MAX_BONE_INFLUENCE]{};
+    };
+
+    static_assert(sizeof(PackedVertex) == 24, "PackedVertex does not match SetPackedVertexAttributes");
+    static_assert(sizeof(SkinVertex) == 12, "SkinVertex does not match SetSkinAttributes");
+
+    PackedVertex PackVertex(const Vertex& vertex);
+    SkinVertex   PackSkin(const Vertex& vertex);
+
+    // Split over the ThreadPool. PackSkins is empty if no vertex has a bone weight, and warns about ids past 65535 whose
+    // influences it has to drop.
+    std::vector<PackedVertex> PackVertices(std::span<const Vertex> vertices);
+    std::vector<SkinVertex>   PackSkins(std::span<const Vertex> vertices);
+
+    // Attribute layout of PackedVertex for the currently bound vertex array and GL_ARRAY_BUFFER, locations 0..3.
+    // Shaders read the same inputs as with Vertex, the tangent gains a w and there is no bitangent.
+    inline void SetPackedVertexAttributes()
+    {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, tangent));
+    }
+
+    // Locations 5 and 6 from a SkinVertex buffer bound to GL_ARRAY_BUFFER.
+    inline void SetSkinAttributes()
+    {
+        glEnableVertexAttribArray(5);
+        glVertexAttribIPointer(5, 4, GL_UNSIGNED_SHORT, sizeof(SkinVertex), (void*)offsetof(SkinVertex, boneIDs));
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, weights));
+    }
+
+}  // namespace suplex
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Render/RHI.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "glm/glm.hpp"
 #include <algorithm>
@@ -28,7 +29,7 @@ namespace suplex {
             info("Apply Bloom window size = ({}, {})", m_Width, m_Height);
 
             glGenFramebuffers(1, &m_FramebufferID);
-            glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
+            RHI::BindFramebuffer(m_FramebufferID);
 
             glm::vec2  mipSize((float)w, (float)h);
             glm::ivec2 mipIntSize((int)w, (int)h);
@@ -42,7 +43,7 @@ namespace suplex {
                 mip.isize = mipIntSize;
 
                 glGenTextures(1, &mip.textureID);
-                glBindTexture(GL_TEXTURE_2D, mip.textureID);
+                RHI::BindTexture(GL_TEXTURE_2D, mip.textureID);
                 // we are downscaling an HDR color buffer, so we need a float texture format
                 glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, (int)mipSize.x, (int)mipSize.y, 0, GL_RGB, GL_FLOAT, nullptr);
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -63,11 +64,11 @@ namespace suplex {
             int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
             if (status != GL_FRAMEBUFFER_COMPLETE) {
                 spdlog::error("gbuffer FBO error, status: 0x\%x\n", status);
-                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                RHI::BindFramebuffer(0);
                 return;
             }
 
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            RHI::BindFramebuffer(0);
 
             m_DownsampleShader = std::make_shared<Shader>("quad.vert", "bloom_downsample.frag");
             m_UpsampleShader   = std::make_shared<Shader>("quad.vert", "bloom_upsample.frag");
@@ -82,35 +83,35 @@ namespace suplex {
         ~Bloom()
         {
             for (int i = 0; i < m_MipChains.size(); i++) {
-                glDeleteTextures(1, &m_MipChains[i].textureID);
+                RHI::DeleteTextures(1, &m_MipChains[i].textureID);
                 m_MipChains[i].textureID = 0;
             }
-            glDeleteFramebuffers(1, &m_FramebufferID);
+            RHI::DeleteFramebuffers(1, &m_FramebufferID);
             m_FramebufferID = 0;
         }
 
         void Render(uint32_t srcTextureID, float radius)
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
-            glViewport(0, 0, m_Width, m_Height);
+            RHI::BindFramebuffer(m_FramebufferID);
+            RHI::Viewport(0, 0, m_Width, m_Height);
             RenderDownsample(srcTextureID);
             RenderUpsample(radius);
         }
 
         void RenderDownsample(uint32_t srcTextureID)
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
+            RHI::BindFramebuffer(m_FramebufferID);
             m_DownsampleShader->Bind();
             m_DownsampleShader->SetFloat2("resolution", glm::value_ptr(m_Resolution));
 
             // Bind srcTexture (HDR color buffer) as initial texture input
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, srcTextureID);
+            RHI::ActiveTexture(0);
+            RHI::BindTexture(GL_TEXTURE_2D, srcTextureID);
 
             // Progressively downsample through the mip chain
             for (int i = 0; i < m_MipChains.size(); i++) {
                 auto& mip = m_MipChains[i];
-                glViewport(0, 0, mip.size.x, mip.size.y);
+                RHI::Viewport(0, 0, mip.size.x, mip.size.y);
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mip.textureID, 0);
 
                 // Render screen-filled quad of resolution of current mip
@@ -119,7 +120,7 @@ namespace suplex {
                 // Set current mip resolution as srcResolution for next iteration
                 m_DownsampleShader->SetFloat2("resolution", glm::value_ptr(mip.size));
                 // Set current mip as texture input for next iteration
-                glBindTexture(GL_TEXTURE_2D, mip.textureID);
+                RHI::BindTexture(GL_TEXTURE_2D, mip.textureID);
             }
 
             m_DownsampleShader->Unbind();
@@ -131,20 +132,20 @@ namespace suplex {
             m_UpsampleShader->SetFloat("filterRadius", &radius);
 
             // Enable additive blending
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_ONE, GL_ONE);
-            glBlendEquation(GL_FUNC_ADD);
+            RHI::Enable(GL_BLEND);
+            RHI::BlendFunc(GL_ONE, GL_ONE);
+            RHI::BlendEquation(GL_FUNC_ADD);
 
             for (int i = m_MipChains.size() - 1; i > 0; i--) {
                 const auto& mip     = m_MipChains[i];
                 const auto& nextMip = m_MipChains[i - 1];
 
                 // Bind viewport and texture from where to read
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, mip.textureID);
+                RHI::ActiveTexture(0);
+                RHI::BindTexture(GL_TEXTURE_2D, mip.textureID);
 
                 // Set framebuffer render target (we write to this texture)
-                glViewport(0, 0, nextMip.size.x, nextMip.size.y);
+                RHI::Viewport(0, 0, nextMip.size.x, nextMip.size.y);
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, nextMip.textureID, 0);
 
                 // Render screen-filled quad of resolution of current mip
@@ -152,8 +153,8 @@ namespace suplex {
             }
 
             // Disable additive blending
-            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);  // Restore if this was default
-            glDisable(GL_BLEND);
+            RHI::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);  // Restore if this was default
+            RHI::Disable(GL_BLEND);
 
             m_UpsampleShader->Unbind();
         }
@@ -0,0 +1,55 @@
+#include "RHI.hpp"
+
+namespace suplex {
+
+    RHI::State RHI::s_State;
+    RHI::Stats RHI::s_Stats;
+    RHI::Stats RHI::s_LastFrameStats;
+
+    RHI::State::State()
+    {
+        for (auto& unit : textures)
+            unit[0] = unit[1] = Unknown;
+    }
+
+    void RHI::Invalidate() { s_State = State(); }
+
+    void RHI::NewFrame()
+    {
+        s_LastFrameStats = s_Stats;
+        s_Stats          = Stats();
+        Invalidate();
+    }
+
+    void RHI::DeleteTextures(int count, const uint32_t* textures)
+    {
+        for (int i = 0; i < count; ++i) {
+            for (auto& unit : s_State.textures) {
+                for (auto& bound : unit) {
+                    if (bound == textures[i])
+                        bound = 0;
+                }
+            }
+        }
+        glDeleteTextures(count, textures);
+    }
+
+    void RHI::DeleteVertexArrays(int count, const uint32_t* vertexArrays)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (s_State.vertexArray == vertexArrays[i])
+                s_State.vertexArray = 0;
+        }
+        glDeleteVertexArrays(count, vertexArrays);
+    }
+
+    void RHI::DeleteFramebuffers(int count, const uint32_t* framebuffers)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (s_State.framebuffer == framebuffers[i])
+                s_State.framebuffer = 0;
+        }
+        glDeleteFramebuffers(count, framebuffers);
+    }
+
+}  // namespace suplex
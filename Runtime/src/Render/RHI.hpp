@@ -1,8 +1,262 @@
 #pragma once
 
+#include "glad/glad.h"
+#include <stdint.h>
+
 namespace suplex {
+
+    // Shadows the GL state the renderer touches and drops calls that would not change it.
+    // Runtime code binds through here; Invalidate() after anything else talked to GL directly (ImGui, third party code).
     class RHI {
     public:
+        static constexpr uint32_t MaxTextureUnits = 32;
+
+        struct Stats
+        {
+            uint32_t issued   = 0;
+            uint32_t filtered = 0;
+        };
+
+        static void Invalidate();
+
+        // Called once per frame by the renderer: publishes the counters of the previous frame and invalidates the cache.
+        static void NewFrame();
+
+        static const Stats& GetLastFrameStats() { return s_LastFrameStats; }
+
+        // Bindings
+        // ------
+        static void UseProgram(uint32_t program)
+        {
+            if (Filter(s_State.program == program))
+                return;
+            s_State.program = program;
+            glUseProgram(program);
+        }
+
+        static void BindVertexArray(uint32_t vertexArray)
+        {
+            if (Filter(s_State.vertexArray == vertexArray))
+                return;
+            s_State.vertexArray = vertexArray;
+            glBindVertexArray(vertexArray);
+        }
+
+        // Binds both the draw and the read framebuffer, same as GL_FRAMEBUFFER.
+        static void BindFramebuffer(uint32_t framebuffer)
+        {
+            if (Filter(s_State.framebuffer == framebuffer))
+                return;
+            s_State.framebuffer = framebuffer;
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+
+        static void ActiveTexture(uint32_t unit)
+        {
+            if (Filter(s_State.activeUnit == unit))
+                return;
+            s_State.activeUnit = unit;
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+
+        // Binds to the active unit, only GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are shadowed.
+        static void BindTexture(GLenum target, uint32_t texture)
+        {
+            int slot = TextureTargetSlot(target);
+            if (slot < 0 || s_State.activeUnit >= MaxTextureUnits) {
+                Filter(false);
+                glBindTexture(target, texture);
+                return;
+            }
+
+            auto& bound = s_State.textures[s_State.activeUnit][slot];
+            if (Filter(bound == texture))
+                return;
+            bound = texture;
+            glBindTexture(target, texture);
+        }
+
+        static void BindTexture(uint32_t unit, GLenum target, uint32_t texture)
+        {
+            ActiveTexture(unit);
+            BindTexture(target, texture);
+        }
+
+        // Deleting a bound object resets the binding to 0 and the name may be handed out again
+        static void DeleteTextures(int count, const uint32_t* textures);
+        static void DeleteVertexArrays(int count, const uint32_t* vertexArrays);
+        static void DeleteFramebuffers(int count, const uint32_t* framebuffers);
+
+        // Fixed function state
+        // ------
+        static void Enable(GLenum capability) { SetCapability(capability, true); }
+        static void Disable(GLenum capability) { SetCapability(capability, false); }
+
+        static void SetCapability(GLenum capability, bool enable)
+        {
+            int slot = CapabilitySlot(capability);
+            if (slot >= 0) {
+                if (Filter(s_State.capabilities[slot] == (int8_t)enable))
+                    return;
+                s_State.capabilities[slot] = enable;
+            }
+            else {
+                Filter(false);
+            }
+            enable ? glEnable(capability) : glDisable(capability);
+        }
+
+        static void BlendFunc(GLenum source, GLenum destination)
+        {
+            if (Filter(s_State.blendSource == source && s_State.blendDestination == destination))
+                return;
+            s_State.blendSource      = source;
+            s_State.blendDestination = destination;
+            glBlendFunc(source, destination);
+        }
+
+        static void BlendEquation(GLenum mode)
+        {
+            if (Filter(s_State.blendEquation == mode))
+                return;
+            s_State.blendEquation = mode;
+            glBlendEquation(mode);
+        }
+
+        static void CullFace(GLenum face)
+        {
+            if (Filter(s_State.cullFace == face))
+                return;
+            s_State.cullFace = face;
+            glCullFace(face);
+        }
+
+        static void DepthFunc(GLenum func)
+        {
+            if (Filter(s_State.depthFunc == func))
+                return;
+            s_State.depthFunc = func;
+            glDepthFunc(func);
+        }
+
+        static void DepthMask(bool write)
+        {
+            if (Filter(s_State.depthMask == (int8_t)write))
+                return;
+            s_State.depthMask = write;
+            glDepthMask(write ? GL_TRUE : GL_FALSE);
+        }
+
+        static void StencilFunc(GLenum func, int reference, uint32_t mask)
+        {
+            auto& stencil = s_State.stencilFunc;
+            if (Filter(stencil.func == func && stencil.reference == reference && stencil.mask == mask))
+                return;
+            stencil = {func, reference, mask};
+            glStencilFunc(func, reference, mask);
+        }
+
+        static void StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+        {
+            auto& stencil = s_State.stencilOp;
+            if (Filter(stencil.stencilFail == stencilFail && stencil.depthFail == depthFail && stencil.depthPass == depthPass))
+                return;
+            stencil = {stencilFail, depthFail, depthPass};
+            glStencilOp(stencilFail, depthFail, depthPass);
+        }
+
+        static void StencilMask(uint32_t mask)
+        {
+            if (Filter(s_State.stencilMask == (int64_t)mask))
+                return;
+            s_State.stencilMask = mask;
+            glStencilMask(mask);
+        }
+
+        static void Viewport(int x, int y, int width, int height)
+        {
+            auto& viewport = s_State.viewport;
+            if (Filter(viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height))
+                return;
+            viewport[0] = x, viewport[1] = y, viewport[2] = width, viewport[3] = height;
+            glViewport(x, y, width, height);
+        }
+
+        static void PolygonMode(GLenum mode)
+        {
+            if (Filter(s_State.polygonMode == mode))
+                return;
+            s_State.polygonMode = mode;
+            glPolygonMode(GL_FRONT_AND_BACK, mode);
+        }
+
+    private:
+        static constexpr uint32_t Unknown = 0xFFFFFFFF;
+
+        struct State
+        {
+            State();
+
+            uint32_t program     = Unknown;
+            uint32_t vertexArray = Unknown;
+            uint32_t framebuffer = Unknown;
+            uint32_t activeUnit  = Unknown;
+            uint32_t textures[MaxTextureUnits][2];  // GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP
+
+            int8_t capabilities[4] = {-1, -1, -1, -1};  // GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_CULL_FACE
+            int8_t depthMask       = -1;
+
+            GLenum blendSource      = Unknown;
+            GLenum blendDestination = Unknown;
+            GLenum blendEquation    = Unknown;
+            GLenum cullFace         = Unknown;
+            GLenum depthFunc        = Unknown;
+            GLenum polygonMode      = Unknown;
+
+            struct
+            {
+                GLenum   func      = Unknown;
+                int      reference = 0;
+                uint32_t mask      = 0;
+            } stencilFunc;
+
+            struct
+            {
+                GLenum stencilFail = Unknown, depthFail = Unknown, depthPass = Unknown;
+            } stencilOp;
+
+            int64_t stencilMask = -1;
+            int     viewport[4] = {-1, -1, -1, -1};
+        };
+
+        static bool Filter(bool redundant)
+        {
+            redundant ? ++s_Stats.filtered : ++s_Stats.issued;
+            return redundant;
+        }
+
+        static int TextureTargetSlot(GLenum target)
+        {
+            switch (target) {
+                case GL_TEXTURE_2D: return 0;
+                case GL_TEXTURE_CUBE_MAP: return 1;
+                default: return -1;
+            }
+        }
+
+        static int CapabilitySlot(GLenum capability)
+        {
+            switch (capability) {
+                case GL_BLEND: return 0;
+                case GL_DEPTH_TEST: return 1;
+                case GL_STENCIL_TEST: return 2;
+                case GL_CULL_FACE: return 3;
+                default: return -1;
+            }
+        }
+
     private:
+        static State s_State;
+        static Stats s_Stats, s_LastFrameStats;
     };
-}  // namespace suplex
\ No newline at end of file
+}  // namespace suplex
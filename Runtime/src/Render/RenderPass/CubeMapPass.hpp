@@ -1,5 +1,6 @@
 #pragma once
 #include "Render/Config/Config.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/RenderPass.hpp"
 #include <glm/gtc/type_ptr.hpp>
 
@@ -14,7 +15,7 @@ namespace suplex {
         {
             // render to custom framebuffer
             // ------
-            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+            RHI::BindFramebuffer(m_Framebuffer->GetID());
             // glClearColor(.6f, .7f, .9f, 1.0f);
             // glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -24,7 +25,7 @@ namespace suplex {
             view = mat4(mat3(view));
 
             auto& shader = m_Shaders[0];
-            glDepthFunc(GL_LEQUAL);  // change depth function so depth test passes when values are equal to depth buffer's content
+            RHI::DepthFunc(GL_LEQUAL);  // change depth function so depth test passes when values are equal to depth buffer's content
             shader->Bind();          // remove translation from the view matrix
             shader->SetMaterix4("view", glm::value_ptr(view));
             shader->SetMaterix4("proj", glm::value_ptr(proj));
@@ -35,8 +36,8 @@ namespace suplex {
             shader->Unbind();
 
             // Return to default framebuffer
-            glDepthFunc(GL_LESS);
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            RHI::DepthFunc(GL_LESS);
+            RHI::BindFramebuffer(0);
         }
     };
 }  // namespace suplex
\ No newline at end of file
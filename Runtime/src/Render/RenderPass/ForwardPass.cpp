@@ -1,5 +1,6 @@
 #include "ForwardPass.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/ForwardPass.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "Render/Texture/Texture2D.hpp"
@@ -26,71 +27,57 @@ namespace suplex {
                                  const std::shared_ptr<PrecomputeContext> context)
     {
         m_Framebuffer->Bind();
-        glCullFace(GL_BACK);
-        auto& config  = graphicsContext->config;
-        auto& shaders = m_Shaders;
-        for (auto& shader : shaders) {
-            // // Bind Depth buffer to forward sampler
-            shader->Bind();
-
-            shader->SetInt("useEnvMap", config->lightSetting.useEnvMap);
-
-            shader->BindTexture("DepthMap", graphicsContext->depthMapLS, 15, SamplerType::Texture2D);
-
-            shader->BindTexture("IrradianceMap", context->IrradianceMap.GetID(), 14, SamplerType::CubeMap);
-
-            shader->BindTexture("PrefilterMap", context->PrefilterMap.GetID(), 13, SamplerType::CubeMap);
-
-            shader->BindTexture("BRDF_LUT", context->BRDF_LUT.GetID(), 12, SamplerType::Texture2D);
-
-            shader->BindTexture("SSAOMap", graphicsContext->SSAOMap, 11, SamplerType::Texture2D);
-            shader->BindTexture("gPosition", graphicsContext->gPosition, 10, SamplerType::Texture2D);
-            shader->BindTexture("gNormal", graphicsContext->gNormal, 9, SamplerType::Texture2D);
-
-            // Light position
-            for (unsigned int i = 0; i < 4; ++i) {
-                shader->SetFloat3("lightPositions[" + std::to_string(i) + "]", glm::value_ptr(lightPositions[i]));
-                shader->SetFloat3("lightColors[" + std::to_string(i) + "]", glm::value_ptr(lightColors[i]));
-            }
-
-            // for (unsigned int i = 0; i < 100; ++i) {
-            //     shader->SetMaterix4("boneTransform[" + std::to_string(i) + "]", glm::value_ptr(glm::mat4(1.0f)));
-            // }
-
-            shader->Unbind();
+        RHI::CullFace(GL_BACK);
+        auto& config      = graphicsContext->config;
+        auto& lightCamera = config->lightSetting.cameraLS;
+
+        FrameUniforms frame;
+        frame.view           = camera->GetView();
+        frame.proj           = camera->GetProjection();
+        frame.mvpLS          = lightCamera->GetProjection() * lightCamera->GetView();
+        frame.viewPos        = camera->GetPosition();
+        frame.lightPosition  = lightCamera->GetPosition();
+        frame.lightDirection = lightCamera->GetForward();
+        frame.lightColor     = config->lightSetting.lightColor;
+        frame.lightIntensity = config->lightSetting.lightIntensity;
+        frame.useEnvMap      = config->lightSetting.useEnvMap;
+
+        // For postprocessing
+        frame.bloomThreshold = config->postprocessSetting.bloomThreshold;
+
+        // Light position
+        for (unsigned int i = 0; i < 4; ++i) {
+            frame.lightPositions[i] = glm::vec4(lightPositions[i], 1.0f);
+            frame.lightColors[i]    = glm::vec4(lightColors[i], 1.0f);
         }
+        graphicsContext->UploadUniforms(frame);
+
+        // Shared textures stay on fixed units for the whole pass, see the sampler setup in the constructor
+        RHI::BindTexture(15, GL_TEXTURE_2D, graphicsContext->depthMapLS);
+        RHI::BindTexture(14, GL_TEXTURE_CUBE_MAP, context->IrradianceMap.GetID());
+        RHI::BindTexture(13, GL_TEXTURE_CUBE_MAP, context->PrefilterMap.GetID());
+        RHI::BindTexture(12, GL_TEXTURE_2D, context->BRDF_LUT.GetID());
+        RHI::BindTexture(11, GL_TEXTURE_2D, graphicsContext->SSAOMap);
+        RHI::BindTexture(10, GL_TEXTURE_2D, graphicsContext->gPosition);
+        RHI::BindTexture(9, GL_TEXTURE_2D, graphicsContext->gNormal);
+        BonePaletteBuffer::Bind();
+        RHI::ActiveTexture(0);
     }
 
     void ForwardRenderPass::RenderLight(const std::shared_ptr<Camera>            camera,
                                         const std::shared_ptr<GraphicsContext>   graphicsContext,
                                         const std::shared_ptr<PrecomputeContext> context)
     {
-        glDisable(GL_CULL_FACE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        const auto& view   = camera->GetView();
-        const auto& proj   = camera->GetProjection();
-        auto        config = graphicsContext->config;
+        RHI::Disable(GL_CULL_FACE);
+        RHI::Enable(GL_BLEND);
+        RHI::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        const auto& view = camera->GetView();
+        const auto& proj = camera->GetProjection();
         // Render Directional Light
         {
             auto& lightShader = m_Shaders[3];
             lightShader->Bind();
-            // Light Setting
-            lightShader->SetFloat3("lightDirection", glm::value_ptr(config->lightSetting.cameraLS->GetForward()));
-            lightShader->SetFloat3("lightPosition", glm::value_ptr(config->lightSetting.cameraLS->GetPosition()));
-            lightShader->SetFloat("lightIntensity", &config->lightSetting.lightIntensity);
-            lightShader->SetFloat3("lightColor", glm::value_ptr(config->lightSetting.lightColor));
-
-            // Camera Position
-            lightShader->SetFloat3("viewPos", glm::value_ptr(camera->GetPosition()));
-
-            // MVP & Light MVP
-            auto model = glm::translate(glm::mat4(1.0f), config->lightSetting.cameraLS->GetPosition());
-            model      = glm::scale(model, vec3(0.5f));
-
-            lightShader->SetMaterix4("model", glm::value_ptr(model));
-            lightShader->SetMaterix4("view", glm::value_ptr(view));
-            lightShader->SetMaterix4("proj", glm::value_ptr(proj));
+            m_ObjectUniforms->Bind(m_LightObjectSlot);
 
             utils::RenderSphere(lightShader);
             lightShader->Unbind();
@@ -111,40 +98,30 @@ namespace suplex {
             }
         }
 
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        RHI::Disable(GL_BLEND);
+        RHI::Enable(GL_CULL_FACE);
     }
 
     void ForwardRenderPass::RenderOutline(const std::shared_ptr<Camera>            camera,
                                           const std::shared_ptr<GraphicsContext>   graphicsContext,
                                           const std::shared_ptr<PrecomputeContext> context)
     {
-        const auto& view = camera->GetView();
-        const auto& proj = camera->GetProjection();
-        // Render Stencil for active entity
-        if (auto entity = graphicsContext->activeEntity) {
-            glEnable(GL_STENCIL_TEST);
-            glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
-            glStencilMask(0x00);
+        // Render Stencil for active entity, skipped when it was culled this frame
+        if (auto entity = graphicsContext->activeEntity; entity && m_ActiveEntityVisible) {
+            RHI::Enable(GL_STENCIL_TEST);
+            RHI::StencilFunc(GL_NOTEQUAL, 1, 0xFF);
+            RHI::StencilMask(0x00);
 
             m_OutlineShader->Bind();
+            m_ObjectUniforms->Bind(m_OutlineObjectSlot);
             auto& meshRenderer = entity.GetComponent<MeshRendererComponent>();
 
-            m_OutlineShader->SetInt("entityID", static_cast<int>(entity.GetID()));
-
-            // MVP & Light MVP
-            auto transform = entity.GetComponent<TransformComponent>();
-            transform.m_Scale *= vec3(1.01);
-            m_OutlineShader->SetMaterix4("model", glm::value_ptr(transform.GetTransform()));
-            m_OutlineShader->SetMaterix4("view", glm::value_ptr(view));
-            m_OutlineShader->SetMaterix4("proj", glm::value_ptr(proj));
-
             for (auto& mesh : meshRenderer.m_Model->GetMeshes())
                 mesh.Render(m_OutlineShader);
             m_OutlineShader->Unbind();
 
-            glStencilMask(0xFF);
-            glDisable(GL_STENCIL_TEST);
+            RHI::StencilMask(0xFF);
+            RHI::Disable(GL_STENCIL_TEST);
         }
     }
 }  // namespace suplex
\ No newline at end of file
@@ -1,10 +1,17 @@
 #pragma once
+#include "Render/Buffer/BonePaletteBuffer.hpp"
 #include "Render/Config/Config.hpp"
+#include "Render/Culling/CullingStage.hpp"
+#include "Render/Culling/LodSelection.hpp"
 #include "Render/Geometry/Mesh.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
+#include "Render/RHI.hpp"
+#include "Render/RenderQueue/InstanceBatcher.hpp"
+#include "Render/RenderQueue/RenderQueue.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "Render/Texture/Texture.hpp"
 #include "Render/Texture/Texture2D.hpp"
+#include "Render/Texture/TextureStreamer.hpp"
 #include "RenderPass.hpp"
 #include "Scene/Component/Component.hpp"
 #include <cmath>
@@ -13,6 +20,7 @@
 #include <memory>
 #include <Scene/Scene.hpp>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include <Scene/Entity/Entity.hpp>
 
@@ -30,6 +38,25 @@ namespace suplex {
             PushShader(std::make_shared<Shader>("common.vert", "phong.frag"));
             PushShader(std::make_shared<Shader>("toon.vert", "toon.frag"));
             PushShader(std::make_shared<Shader>("common.vert", "light.frag"));
+
+            // Everything else comes from the uniform blocks, samplers only need to be pointed at their units once
+            for (auto& shader : m_Shaders) {
+                shader->Bind();
+                shader->SetInt("DiffuseMap", 0);
+                shader->SetInt("gNormal", 9);
+                shader->SetInt("gPosition", 10);
+                shader->SetInt("SSAOMap", 11);
+                shader->SetInt("BRDF_LUT", 12);
+                shader->SetInt("PrefilterMap", 13);
+                shader->SetInt("IrradianceMap", 14);
+                shader->SetInt("DepthMap", 15);
+                shader->SetInt("BonePalette", BonePaletteBuffer::TextureUnit);
+                shader->Unbind();
+            }
+
+            m_OutlineShader->Bind();
+            m_OutlineShader->SetInt("BonePalette", BonePaletteBuffer::TextureUnit);
+            m_OutlineShader->Unbind();
         }
 
         virtual void Render(const std::shared_ptr<Camera>            camera,
@@ -43,91 +70,122 @@ namespace suplex {
             Bind(camera, graphicsContext, context);
 
             static int value = -1;
-            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+            RHI::BindFramebuffer(m_Framebuffer->GetID());
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
             glClearTexImage(m_Framebuffer->GetColorAttachmentID(2), 0, GL_RED_INTEGER, GL_INT, &value);
-            glDisable(GL_STENCIL_TEST);
+            RHI::Disable(GL_STENCIL_TEST);
             // =====================================================
 
             auto config = graphicsContext->config;
-            glEnable(GL_CULL_FACE);
-
-            auto view = camera->GetView();
-            auto proj = camera->GetProjection();
-
-            auto& lightCamera = config->lightSetting.cameraLS;
-            auto  viewLS      = lightCamera->GetView();
-            auto  projLS      = lightCamera->GetProjection();
-
-            auto mvpLS = projLS * viewLS;
+            RHI::Enable(GL_CULL_FACE);
 
             m_GridShader->Bind();
-            m_GridShader->SetMaterix4("view", glm::value_ptr(view));
-            m_GridShader->SetMaterix4("proj", glm::value_ptr(proj));
+            m_GridShader->SetMaterix4("view", glm::value_ptr(camera->GetView()));
+            m_GridShader->SetMaterix4("proj", glm::value_ptr(camera->GetProjection()));
             utils::RenderGird(nullptr);
             m_GridShader->Unbind();
 
-            // render container
-            auto DrawEntity = [&](Entity entity, std::optional<std::shared_ptr<Shader>> effectShader = std::nullopt) {
-                auto& meshRenderer = entity.GetComponent<MeshRendererComponent>();
+            // Gather the draws and per-object blocks of this pass, upload the blocks in one go
+            m_ObjectUniforms->Begin();
+            m_RenderQueue.Clear();
+            m_Batcher.Begin();
+
+            auto cameraPosition = camera->GetPosition();
+            auto farClip        = camera->GetFarClip();
+            auto nearClip       = camera->GetNearClip();
+            auto pixelScale     = camera->GetProjection()[1][1] * camera->GetViewportHeight();
+            m_Footprints.clear();
+
+            // Entities sharing a model file, material, pass and level of detail become one instanced draw per mesh
+            auto& visible         = m_Culling.Run(*scene, camera->GetProjection() * camera->GetView(), graphicsContext->renderStats);
+            m_ActiveEntityVisible = false;
+            for (auto entityID : visible) {
+                Entity entity(entityID, scene.get());
+                auto&  meshRenderer = entity.GetComponent<MeshRendererComponent>();
+                auto&  sphere       = entity.GetComponent<BoundsComponent>().m_WorldSphere;
+
+                // Same selection as the camera DepthRenderPass earlier in the frame, which makes this a no-op
+                if (config->enableLod) {
+                    float size = GetScreenSize(sphere, cameraPosition, camera->GetProjection(), camera->GetViewportHeight());
+                    meshRenderer.m_Lod =
+                        SelectLod(GetLodLevel(size, config->lodScreenSize), meshRenderer.m_Lod, meshRenderer.m_Model->GetLodCount());
+                }
+                else {
+                    meshRenderer.m_Lod = 0;
+                }
 
-                auto shader = effectShader.value_or(m_Shaders[meshRenderer.m_Model->GetMaterialIndex()]);
-                shader->Bind();
-                shader->SetInt("entityID", static_cast<int>(entity.GetID()));
-                // Light Setting
-                shader->SetFloat3("lightDirection", glm::value_ptr(config->lightSetting.cameraLS->GetForward()));
-                shader->SetFloat3("lightPosition", glm::value_ptr(config->lightSetting.cameraLS->GetPosition()));
-                shader->SetFloat("lightIntensity", &config->lightSetting.lightIntensity);
-                shader->SetFloat3("lightColor", glm::value_ptr(config->lightSetting.lightColor));
+                // The active entity also writes the stencil used by the outline
+                bool active  = entity == graphicsContext->activeEntity;
+                auto pass    = active ? RenderQueuePass::Selected : RenderQueuePass::Opaque;
+                auto variant = (meshRenderer.m_Lod << 16) | (static_cast<uint32_t>(pass) << 8) | meshRenderer.m_MaterialIndex;
 
-                // For postprocessing
-                shader->SetFloat("bloomThreshold", &config->postprocessSetting.bloomThreshold);
+                m_ActiveEntityVisible |= active;
 
-                // Camera Position
-                shader->SetFloat3("viewPos", glm::value_ptr(camera->GetPosition()));
+                InstanceData instance;
+                instance.model         = entity.GetComponent<WorldTransformComponent>().m_Matrix;
+                instance.entityID      = static_cast<int>(entity.GetID());
+                instance.paletteOffset = GetPaletteOffset(*scene, entityID);
 
-                // MVP & Light MVP
-                auto transform = entity.GetComponent<TransformComponent>();
-                shader->SetMaterix4("model", glm::value_ptr(transform.GetTransform()));
-                shader->SetMaterix4("view", glm::value_ptr(view));
-                shader->SetMaterix4("proj", glm::value_ptr(proj));
-                shader->SetMaterix4("mvpLS", glm::value_ptr(mvpLS));
-
-                // material parameters
-                shader->SetFloat("baseF", config->pbrSetting.baseF);
-                shader->SetFloat3("baseColor", glm::value_ptr(config->pbrSetting.baseColor));
-                shader->SetFloat("metallic", &config->pbrSetting.metallic);
-                shader->SetFloat("roughness", &config->pbrSetting.roughness);
-                shader->SetFloat("ao", &config->pbrSetting.ao);
-                shader->SetInt("kullaConty", config->pbrSetting.enableKullaConty);
-
-                shader->BindTexture("DiffuseMap", solidWhite.GetID(), 0, SamplerType::Texture2D);
+                float depth = glm::length(glm::vec3(instance.model[3]) - cameraPosition) / farClip;
+                m_Batcher.Add(*meshRenderer.m_Model, variant, instance, depth);
 
-                for (auto& mesh : meshRenderer.m_Model->GetMeshes())
-                    mesh.Render(shader);
-                shader->Unbind();
-            };
+                // On-screen diameter in pixels, the largest instance decides which mips a model's textures need
+                float distance  = std::max(glm::length(sphere.center - cameraPosition) - sphere.radius, nearClip);
+                auto& footprint = m_Footprints[meshRenderer.m_Model.get()];
+                footprint       = std::max(footprint, sphere.radius * pixelScale / distance);
+            }
+            m_Batcher.Flush();
+            for (auto& [model, footprint] : m_Footprints)
+                TextureStreamer::Request(*model, footprint);
+
+            // Instanced draws take the transform from the instance, the block only contributes identity
+            auto instancedSlot = PushObject(glm::mat4(1.0f), -1);
+            for (auto& batch : m_Batcher.GetBatches()) {
+                DrawItem item;
+                item.shaderIndex   = batch.variant & 0xFF;
+                item.objectSlot    = instancedSlot;
+                item.pass          = static_cast<RenderQueuePass>((batch.variant >> 8) & 0xFF);
+                item.lod           = batch.variant >> 16;
+                item.firstInstance = batch.firstInstance;
+                item.instanceCount = batch.instanceCount;
+
+                for (auto& mesh : batch.model->GetMeshes()) {
+                    item.mesh = &mesh;
+                    m_RenderQueue.Push(item, batch.nearestDepth);
+                }
+            }
 
-            auto sceneView = scene->GetAllEntitiesWith<MeshRendererComponent>();
-            for (auto& entityID : sceneView) {
-                Entity entity(entityID, scene.get());
+            auto lightModel   = glm::translate(glm::mat4(1.0f), config->lightSetting.cameraLS->GetPosition());
+            m_LightObjectSlot = PushObject(glm::scale(lightModel, vec3(0.5f)), -1);
+
+            if (auto entity = graphicsContext->activeEntity; entity && m_ActiveEntityVisible) {
+                auto& world         = entity.GetComponent<WorldTransformComponent>().m_Matrix;
+                m_OutlineObjectSlot = PushObject(glm::scale(world, vec3(1.01)), static_cast<int>(entity.GetID()),
+                                                 GetPaletteOffset(*scene, entity.GetID()));
+            }
+            m_ObjectUniforms->Upload();
 
-                if (entity == graphicsContext->activeEntity) {
-                    glEnable(GL_STENCIL_TEST);
-                    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-                    glStencilMask(0x00);
-                    glStencilFunc(GL_ALWAYS, 1, 0xFF);
-                    glStencilMask(0xFF);
-                    DrawEntity(entity);
-                    glDisable(GL_STENCIL_TEST);
+            // render container
+            m_RenderQueue.Sort();
+            auto onPassBegin = [](RenderQueuePass pass) {
+                if (pass == RenderQueuePass::Selected) {
+                    RHI::Enable(GL_STENCIL_TEST);
+                    RHI::StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+                    RHI::StencilFunc(GL_ALWAYS, 1, 0xFF);
+                    RHI::StencilMask(0xFF);
                 }
-                DrawEntity(entity);
             };
+            if (config->multiDrawIndirect)
+                m_RenderQueue.SubmitIndirect(m_Shaders, *m_ObjectUniforms, solidWhite.GetID(), graphicsContext->renderStats, onPassBegin);
+            else
+                m_RenderQueue.Submit(m_Shaders, *m_ObjectUniforms, solidWhite.GetID(), graphicsContext->renderStats, onPassBegin);
+            RHI::Disable(GL_STENCIL_TEST);
+            RHI::UseProgram(0);
 
             RenderLight(camera, graphicsContext, context);
             RenderOutline(camera, graphicsContext, context);
 
-            glDisable(GL_CULL_FACE);
+            RHI::Disable(GL_CULL_FACE);
         }
 
         void Bind(const std::shared_ptr<Camera>            camera,
@@ -142,11 +200,36 @@ namespace suplex {
                            const std::shared_ptr<GraphicsContext>   graphicsContext,
                            const std::shared_ptr<PrecomputeContext> context);
 
+    private:
+        uint32_t PushObject(const glm::mat4& model, int entityID, int32_t paletteOffset = -1)
+        {
+            ObjectUniforms object;
+            object.model         = model;
+            object.entityID      = entityID;
+            object.paletteOffset = paletteOffset;
+            return m_ObjectUniforms->Push(object);
+        }
+
+        // First bone matrix of an animated entity in the BonePaletteBuffer, -1 if it is not skinned
+        static int32_t GetPaletteOffset(Scene& scene, entt::entity entity)
+        {
+            auto animator = scene.m_Registry.try_get<AnimatorComponent>(entity);
+            return animator ? animator->m_PaletteOffset : -1;
+        }
+
     private:
         std::shared_ptr<Shader>    m_GridShader    = std::make_shared<Shader>("line.vert", "line.frag");
         std::shared_ptr<Shader>    m_OutlineShader = std::make_shared<Shader>("common.vert", "outline.frag");
         std::shared_ptr<Shader>    m_IconShader    = std::make_shared<Shader>("quad.vert", "quad.frag");
         std::shared_ptr<Texture2D> m_LightIcon = std::make_shared<Texture2D>("../Assets/Icons/icon-light.png", TextureFormat::RGBA);
+
+        std::shared_ptr<ObjectUniformBuffer> m_ObjectUniforms = std::make_shared<ObjectUniformBuffer>();
+        RenderQueue                          m_RenderQueue;
+        InstanceBatcher                      m_Batcher;
+        CullingStage                         m_Culling;
+        std::unordered_map<Model*, float>    m_Footprints;
+        bool                                 m_ActiveEntityVisible = false;
+        uint32_t                             m_LightObjectSlot = 0, m_OutlineObjectSlot = 0;
     };
 
     class OutlineRenderPass : public RenderPass {
@@ -157,37 +240,41 @@ namespace suplex {
                             const std::shared_ptr<GraphicsContext>   graphicsContext,
                             const std::shared_ptr<PrecomputeContext> context) override
         {
-            glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
-            glStencilMask(0x00);
+            RHI::StencilFunc(GL_NOTEQUAL, 1, 0xFF);
+            RHI::StencilMask(0x00);
 
             // render container
-            auto view = camera->GetView();
-            auto proj = camera->GetProjection();
-
             m_OutlineShader->Bind();
-            if (auto entity = graphicsContext->activeEntity) {
+            auto entity = graphicsContext->activeEntity;
+            if (entity && entity.HasComponent<BoundsComponent>() &&
+                Frustum(camera->GetProjection() * camera->GetView()).Intersects(entity.GetComponent<BoundsComponent>().m_WorldBounds)) {
                 // if (m_Running) object->OnUpdate(0.03f);
                 auto& meshRenderer = entity.GetComponent<MeshRendererComponent>();
 
-                m_OutlineShader->SetInt("entityID", static_cast<int>(entity.GetID()));
-
                 // MVP & Light MVP
                 auto transform    = entity.GetComponent<TransformComponent>();
                 transform.m_Scale = vec3(1.01);
-                m_OutlineShader->SetMaterix4("model", glm::value_ptr(transform.GetTransform()));
-                m_OutlineShader->SetMaterix4("view", glm::value_ptr(view));
-                m_OutlineShader->SetMaterix4("proj", glm::value_ptr(proj));
+
+                ObjectUniforms object;
+                object.model    = transform.GetTransform();
+                object.entityID = static_cast<int>(entity.GetID());
+
+                m_ObjectUniforms->Begin();
+                auto slot = m_ObjectUniforms->Push(object);
+                m_ObjectUniforms->Upload();
+                m_ObjectUniforms->Bind(slot);
 
                 for (auto& mesh : meshRenderer.m_Model->GetMeshes())
                     mesh.Render(m_OutlineShader);
             }
             m_OutlineShader->Unbind();
 
-            glStencilMask(0xFF);
-            glDisable(GL_STENCIL_TEST);
+            RHI::StencilMask(0xFF);
+            RHI::Disable(GL_STENCIL_TEST);
         }
 
     private:
-        std::shared_ptr<Shader> m_OutlineShader;
+        std::shared_ptr<Shader>              m_OutlineShader;
+        std::shared_ptr<ObjectUniformBuffer> m_ObjectUniforms = std::make_shared<ObjectUniformBuffer>(1);
     };
 }  // namespace suplex
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Render/Buffer/Framebuffer.hpp"
 #include "Render/Buffer/HdrFramebuffer.hpp"
 #include "Render/Postprocess/Noise.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/RenderPass.hpp"
 #include "Render/Texture/Texture2D.hpp"
 #include <Render/Postprocess/Bloom.hpp>
@@ -91,7 +92,7 @@ namespace suplex {
         virtual void OnResize(uint32_t w, uint32_t h) override
         {
             m_OutputFramebuffer->OnResize(w, h);
-            glViewport(0, 0, w, h);
+            RHI::Viewport(0, 0, w, h);
         }
 
         virtual uint32_t GetFramebufferImage() override { return m_OutputFramebuffer->GetColorAttachmentID(0); }
@@ -7,6 +7,7 @@
 
 #include "Render/Buffer/Framebuffer.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/RenderPass.hpp"
 #include "Render/Texture/CubeMap.hpp"
 #include "Render/Texture/Texture.hpp"
@@ -32,16 +33,16 @@ namespace suplex {
         {
             // =============================================================================================================
             // Bake to cubemap
-            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+            RHI::BindFramebuffer(m_Framebuffer->GetID());
             glBindRenderbuffer(GL_RENDERBUFFER, m_Framebuffer->GetRenderbufferID());
             glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 2048, 2048);
-            glViewport(0, 0, 2048, 2048);
+            RHI::Viewport(0, 0, 2048, 2048);
 
             auto& shader = m_Shaders[0];
             shader->Bind();
             shader->SetMaterix4("proj", glm::value_ptr(captureProjection));
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, context->HDR_EnvironmentTexture.GetID());
+            RHI::ActiveTexture(0);
+            RHI::BindTexture(GL_TEXTURE_2D, context->HDR_EnvironmentTexture.GetID());
 
             for (uint32_t i = 0; i < 6; ++i) {
                 shader->SetMaterix4("view", glm::value_ptr(captureViews[i]));
@@ -58,13 +59,13 @@ namespace suplex {
             shader->Bind();
             shader->SetMaterix4("proj", glm::value_ptr(captureProjection));
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, context->HDR_EnvironmentTexture.GetID());
+            RHI::ActiveTexture(0);
+            RHI::BindTexture(GL_TEXTURE_2D, context->HDR_EnvironmentTexture.GetID());
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+            RHI::BindFramebuffer(m_Framebuffer->GetID());
             glBindRenderbuffer(GL_RENDERBUFFER, m_Framebuffer->GetRenderbufferID());
             glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 32, 32);
-            glViewport(0, 0, 32, 32);
+            RHI::Viewport(0, 0, 32, 32);
 
             for (uint32_t i = 0; i < 6; ++i) {
                 shader->SetMaterix4("view", glm::value_ptr(captureViews[i]));
@@ -81,8 +82,8 @@ namespace suplex {
             shader = m_Shaders[2];
             shader->Bind();
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, context->EnvironmentMap.GetID());
+            RHI::ActiveTexture(0);
+            RHI::BindTexture(GL_TEXTURE_CUBE_MAP, context->EnvironmentMap.GetID());
 
             shader->SetMaterix4("proj", glm::value_ptr(captureProjection));
             uint32_t maxMipLevels = 6;
@@ -91,10 +92,10 @@ namespace suplex {
                 uint32_t mipWidth  = 128 * std::pow(0.5, mip);
                 uint32_t mipHeight = 128 * std::pow(0.5, mip);
 
-                glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+                RHI::BindFramebuffer(m_Framebuffer->GetID());
                 glBindRenderbuffer(GL_RENDERBUFFER, m_Framebuffer->GetRenderbufferID());
                 glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, mipWidth, mipHeight);
-                glViewport(0, 0, mipWidth, mipHeight);
+                RHI::Viewport(0, 0, mipWidth, mipHeight);
 
                 float roughness = (float)mip / (float)(maxMipLevels - 1);
                 shader->SetFloat("roughness", &roughness);
@@ -116,20 +117,20 @@ namespace suplex {
             // then re-configure capture framebuffer object and render screen-space quad
             // with BRDF shader.
             shader->Bind();
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, context->BRDF_LUT.GetID());
-            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer->GetID());
+            RHI::ActiveTexture(0);
+            RHI::BindTexture(GL_TEXTURE_2D, context->BRDF_LUT.GetID());
+            RHI::BindFramebuffer(m_Framebuffer->GetID());
             glBindRenderbuffer(GL_RENDERBUFFER, m_Framebuffer->GetRenderbufferID());
             glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 512, 512);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, context->BRDF_LUT.GetID(), 0);
-            glViewport(0, 0, 512, 512);
+            RHI::Viewport(0, 0, 512, 512);
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             utils::RenderQuad(shader, QuadRenderSpecification::Screen);
             shader->Unbind();
 
             // Return to default framebuffer
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            RHI::BindFramebuffer(0);
         }
 
         virtual void Render(uint32_t framebufferID) override {}
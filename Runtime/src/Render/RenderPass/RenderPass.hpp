@@ -1,11 +1,17 @@
 #pragma once
 
+#include "Render/Buffer/BonePaletteBuffer.hpp"
 #include "Render/Buffer/Depthbuffer.hpp"
+#include "Render/Buffer/GeometryPool.hpp"
 #include "Render/Buffer/HdrFramebuffer.hpp"
 #include "Render/Geometry/Mesh.hpp"
 #include "Render/Geometry/Model.hpp"
 #include "Render/Buffer/Framebuffer.hpp"
 #include "Render/Config/Config.hpp"
+#include "Render/Culling/CullingStage.hpp"
+#include "Render/Culling/LodSelection.hpp"
+#include "Render/RHI.hpp"
+#include "Render/RenderQueue/InstanceBatcher.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "Render/Camera/Camera.hpp"
 #include "Scene/Component/Component.hpp"
@@ -94,7 +100,9 @@ namespace suplex {
 
     class DepthRenderPass : public RenderPass {
     public:
-        DepthRenderPass()
+        // The light space pass sizes objects in shadow map texels and adds GraphicsConfig::shadowLodBias, the camera
+        // pass picks the same levels as the ForwardRenderPass.
+        explicit DepthRenderPass(bool lightSpace = false) : m_LightSpace(lightSpace)
         {
             FramebufferSpecification spec;
             spec.Attachments     = {{TextureFormat::Depth}, {TextureFormat::RGBA}, {TextureFormat::RGB}};
@@ -104,6 +112,15 @@ namespace suplex {
             // m_Depthbuffer->OnResize(2048, 2048);
 
             m_Shaders = {std::make_shared<Shader>("depth.vert", "depth.frag")};
+
+            m_ViewLSUniform   = m_Shaders[0]->GetUniform<glm::mat4>("viewLS");
+            m_ProjLSUniform   = m_Shaders[0]->GetUniform<glm::mat4>("projLS");
+            m_FarClipUniform  = m_Shaders[0]->GetUniform<float>("farClip");
+            m_NearClipUniform = m_Shaders[0]->GetUniform<float>("nearClip");
+
+            m_Shaders[0]->Bind();
+            m_Shaders[0]->SetInt("BonePalette", BonePaletteBuffer::TextureUnit);
+            m_Shaders[0]->Unbind();
         }
 
         virtual void Render(const std::shared_ptr<Camera>            camera,
@@ -113,7 +130,7 @@ namespace suplex {
         {
             // render to custom framebuffer
             // ------
-            glCullFace(GL_FRONT);
+            RHI::CullFace(GL_FRONT);
             m_Framebuffer->Bind();
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             auto config = graphicsContext->config;
@@ -122,32 +139,107 @@ namespace suplex {
 
             auto& shader = m_Shaders[0];
             shader->Bind();
-            shader->SetMaterix4("viewLS", glm::value_ptr(viewLS));
-            shader->SetMaterix4("projLS", glm::value_ptr(projLS));
-            shader->SetFloat("farClip", camera->GetFarClip());
-            shader->SetFloat("nearClip", camera->GetNearClip());
-
-            auto entities = scene->m_Registry.view<MeshRendererComponent>();
-            for (auto& entity : entities) {
-                auto transform = scene->m_Registry.get<TransformComponent>(entity);
-
-                shader->SetMaterix4("model", glm::value_ptr(transform.GetTransform()));
-                auto& meshRenderer = scene->m_Registry.get<MeshRendererComponent>(entity);
-                for (auto& mesh : meshRenderer.m_Model->GetMeshes())
-                    mesh.Render(shader);
+            shader->Set(m_ViewLSUniform, viewLS);
+            shader->Set(m_ProjLSUniform, projLS);
+            shader->Set(m_FarClipUniform, camera->GetFarClip());
+            shader->Set(m_NearClipUniform, camera->GetNearClip());
+            BonePaletteBuffer::Bind();
+            RHI::ActiveTexture(0);
+
+            // Transforms and palette offsets come from the instance buffer, the object block stays at identity
+            m_ObjectUniforms->Begin();
+            m_ObjectUniforms->Bind(m_ObjectUniforms->Push(ObjectUniforms()));
+            m_ObjectUniforms->Upload();
+
+            // Depth only needs geometry, so every entity of the same model file and level shares a batch regardless of material.
+            // For the light space pass the camera is LightSetting::cameraLS, so this culls against its orthographic frustum.
+            m_Batcher.Begin();
+            auto& entities = m_Culling.Run(*scene, projLS * viewLS, graphicsContext->renderStats);
+            float height   = m_LightSpace ? m_DepthmapResolution : camera->GetViewportHeight();
+            for (auto entity : entities) {
+                auto&    meshRenderer = scene->m_Registry.get<MeshRendererComponent>(entity);
+                auto&    sphere       = scene->m_Registry.get<BoundsComponent>(entity).m_WorldSphere;
+                uint32_t lod          = 0;
+                if (config->enableLod) {
+                    auto  lodCount = meshRenderer.m_Model->GetLodCount();
+                    float level    = GetLodLevel(GetScreenSize(sphere, camera->GetPosition(), projLS, height), config->lodScreenSize);
+                    if (m_LightSpace) {
+                        level = std::floor(level) + static_cast<float>(config->shadowLodBias);
+                        lod   = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(lodCount - 1)));
+                    }
+                    else {
+                        lod = meshRenderer.m_Lod = SelectLod(level, meshRenderer.m_Lod, lodCount);
+                    }
+                }
+                else if (!m_LightSpace) {
+                    meshRenderer.m_Lod = 0;
+                }
+
+                InstanceData instance;
+                instance.model    = scene->m_Registry.get<WorldTransformComponent>(entity).m_Matrix;
+                instance.entityID = static_cast<int>(entity);
+                if (auto animator = scene->m_Registry.try_get<AnimatorComponent>(entity))
+                    instance.paletteOffset = animator->m_PaletteOffset;
+                m_Batcher.Add(*meshRenderer.m_Model, lod, instance);
+            }
+            m_Batcher.Flush();
+
+            auto& stats = graphicsContext->renderStats;
+            if (config->multiDrawIndirect) {
+                // No per-draw state at all, the whole pass is a single call
+                m_Commands.clear();
+                for (auto& batch : m_Batcher.GetBatches()) {
+                    for (auto& mesh : batch.model->GetMeshes()) {
+                        auto& allocation = mesh.GetPoolAllocation();
+                        auto& lod        = mesh.GetLod(batch.variant);
+                        m_Commands.push_back({lod.indexCount, batch.instanceCount, allocation.firstIndex + lod.firstIndex,
+                                              allocation.baseVertex, batch.firstInstance});
+                        stats.instances += batch.instanceCount;
+                        stats.triangles += uint64_t(lod.indexCount / 3) * batch.instanceCount;
+                    }
+                }
+
+                if (!m_Commands.empty()) {
+                    auto firstCommand = GeometryPool::PushCommands(m_Commands);
+                    GeometryPool::Bind();
+                    GeometryPool::MultiDraw(firstCommand, static_cast<uint32_t>(m_Commands.size()));
+                    ++stats.drawCalls;
+                }
+            }
+            else {
+                for (auto& batch : m_Batcher.GetBatches()) {
+                    for (auto& mesh : batch.model->GetMeshes()) {
+                        RHI::BindVertexArray(mesh.GetVAO());
+                        mesh.Draw(batch.instanceCount, batch.firstInstance, batch.variant);
+                        ++stats.drawCalls;
+                        stats.instances += batch.instanceCount;
+                        stats.triangles += uint64_t(mesh.GetLod(batch.variant).indexCount / 3) * batch.instanceCount;
+                    }
+                }
             }
+            RHI::BindVertexArray(0);
 
             shader->Unbind();
 
             // Return to default framebuffer
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glCullFace(GL_BACK);
+            RHI::BindFramebuffer(0);
+            RHI::CullFace(GL_BACK);
         }
 
         virtual uint32_t GetFramebufferImage() override { return m_Framebuffer->GetDepthAttachmentID(); }
 
     private:
         float m_DepthmapResolution = 2048;
+        bool  m_LightSpace         = false;
+
+        UniformHandle<glm::mat4> m_ViewLSUniform, m_ProjLSUniform;
+        UniformHandle<float>     m_FarClipUniform, m_NearClipUniform;
+
+        std::shared_ptr<ObjectUniformBuffer> m_ObjectUniforms = std::make_shared<ObjectUniformBuffer>(1);
+        InstanceBatcher                      m_Batcher;
+        CullingStage                         m_Culling;
+
+        std::vector<DrawElementsIndirectCommand> m_Commands;
     };
 
     class ImGuiRenderPass : public RenderPass {
@@ -157,7 +249,7 @@ namespace suplex {
                             const std::shared_ptr<GraphicsContext>   graphicsContext,
                             const std::shared_ptr<PrecomputeContext> context) override
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            RHI::BindFramebuffer(0);
             // glClearColor(.6f, 0.7f, 0.9f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT);
 
@@ -171,9 +263,10 @@ namespace suplex {
                 ImGui::RenderPlatformWindowsDefault();
                 glfwMakeContextCurrent(backupWindow);
             }
+            RHI::Invalidate();
 
             // Return to default framebuffer
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            RHI::BindFramebuffer(0);
         }
 
     private:
@@ -4,6 +4,7 @@
 #include "Render/Geometry/Model.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
 #include "Render/Postprocess/Noise.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/RenderPass.hpp"
 #include <memory>
 #include <spdlog/spdlog.h>
@@ -50,7 +51,7 @@ namespace suplex {
         virtual void OnResize(uint32_t w, uint32_t h) override
         {
             m_Framebuffer->OnResize(w, h);
-            glViewport(0, 0, w, h);
+            RHI::Viewport(0, 0, w, h);
         }
 
         virtual uint32_t GetFramebufferImage() override { return m_Framebuffer->GetColorAttachmentID(0); }
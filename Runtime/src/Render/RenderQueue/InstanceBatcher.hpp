@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Render/Buffer/InstanceBuffer.hpp"
+#include "Render/Geometry/Model.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace suplex {
+
+    struct InstanceBatch
+    {
+        Model*   model         = nullptr;  // its meshes are drawn for every instance
+        uint32_t variant       = 0;
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+        float    nearestDepth  = 1.0f;
+    };
+
+    // Groups the instances of a model into consecutive InstanceBuffer ranges. Entities using the same file share
+    // one Model through the AssetManager, so the model pointer identifies the geometry.
+    // variant is caller defined (material, pass), instances only share a batch when it matches too.
+    class InstanceBatcher {
+    public:
+        void Begin()
+        {
+            m_Lookup.clear();
+            m_Batches.clear();
+            m_Instances.clear();
+        }
+
+        void Add(Model& model, uint32_t variant, const InstanceData& instance, float depth01 = 0.0f)
+        {
+            auto [iter, inserted] = m_Lookup.try_emplace(BatchKey{&model, variant}, static_cast<uint32_t>(m_Batches.size()));
+            if (inserted)
+                m_Batches.push_back({&model, variant});
+
+            auto& batch        = m_Batches[iter->second];
+            batch.nearestDepth = std::min(batch.nearestDepth, depth01);
+            ++batch.instanceCount;
+            m_Instances.push_back({iter->second, instance});
+        }
+
+        // Pushes the instances batch by batch into the InstanceBuffer and uploads them.
+        void Flush()
+        {
+            uint32_t first = InstanceBuffer::GetCount();
+            for (auto& batch : m_Batches) {
+                batch.firstInstance = first;
+                first += batch.instanceCount;
+            }
+
+            m_Sorted.resize(m_Instances.size());
+            m_Cursors.resize(m_Batches.size());
+            for (size_t i = 0; i < m_Batches.size(); ++i)
+                m_Cursors[i] = m_Batches[i].firstInstance - m_Batches[0].firstInstance;
+            for (auto& [batchIndex, instance] : m_Instances)
+                m_Sorted[m_Cursors[batchIndex]++] = instance;
+
+            for (auto& instance : m_Sorted)
+                InstanceBuffer::Push(instance);
+            InstanceBuffer::Upload();
+        }
+
+        const auto& GetBatches() const { return m_Batches; }
+
+    private:
+        struct BatchKey
+        {
+            const Model* model;
+            uint32_t     variant;
+
+            bool operator==(const BatchKey& other) const { return model == other.model && variant == other.variant; }
+        };
+
+        struct BatchKeyHash
+        {
+            size_t operator()(const BatchKey& key) const
+            {
+                auto hash = std::hash<const void*>()(key.model);
+                return hash ^ (std::hash<uint32_t>()(key.variant) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+            }
+        };
+
+    private:
+        std::unordered_map<BatchKey, uint32_t, BatchKeyHash> m_Lookup;
+        std::vector<InstanceBatch>                           m_Batches;
+        std::vector<std::pair<uint32_t, InstanceData>>       m_Instances;
+        std::vector<InstanceData>                            m_Sorted;
+        std::vector<uint32_t>                                m_Cursors;
+    };
+
+}  // namespace suplex
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Render/Buffer/GeometryPool.hpp"
+#include "Render/Buffer/UniformBuffer.hpp"
+#include "Render/Geometry/Mesh.hpp"
+#include "Render/RHI.hpp"
+#include "Render/RenderQueue/RenderStats.hpp"
+#include "Render/Shader/Shader.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace suplex {
+
+    enum class RenderQueuePass : uint32_t { Opaque = 0, Selected = 1 };
+
+    struct DrawItem
+    {
+        Mesh*           mesh        = nullptr;
+        uint32_t        shaderIndex = 0;
+        uint32_t        objectSlot  = 0;
+        RenderQueuePass pass        = RenderQueuePass::Opaque;
+        uint32_t        lod         = 0;  // clamped to the levels of the mesh
+
+        // Range in the InstanceBuffer, see InstanceBatcher
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 1;
+    };
+
+    // Collects the draws of a pass, sorts them by a 64 bit key and submits them skipping redundant state changes.
+    // Key layout, most significant first: | pass (4) | shader (8) | texture set (16) | VAO (16) | depth (20) |
+    class RenderQueue {
+    public:
+        static uint64_t MakeKey(uint32_t pass, uint32_t shaderIndex, uint32_t textureSet, uint32_t vao, float depth01)
+        {
+            auto quantizedDepth = static_cast<uint64_t>(glm::clamp(depth01, 0.0f, 1.0f) * 0xFFFFF);
+            return (uint64_t(pass & 0xF) << 60) | (uint64_t(shaderIndex & 0xFF) << 52) | (uint64_t(textureSet & 0xFFFF) << 36) |
+                   (uint64_t(vao & 0xFFFF) << 20) | quantizedDepth;
+        }
+
+        // Texture set ids are handed out again from 1 after each Clear, so they only overflow the key field when a single
+        // build has more than 65535 distinct sets
+        void Clear()
+        {
+            m_Items.clear();
+            m_ItemTextureSets.clear();
+            m_Keys.clear();
+            m_TextureSets.clear();
+        }
+
+        // depth01 is the view distance divided by the far clip, opaque draws end up front to back.
+        void Push(const DrawItem& item, float depth01)
+        {
+            auto textureSet = GetTextureSetID(*item.mesh);
+            auto key        = MakeKey(static_cast<uint32_t>(item.pass), item.shaderIndex, textureSet, item.mesh->GetVAO(), depth01);
+            m_Keys.push_back({key, static_cast<uint32_t>(m_Items.size())});
+            m_Items.push_back(item);
+            m_ItemTextureSets.push_back(textureSet);
+        }
+
+        // LSD radix sort, one pass per key byte. Bytes shared by every key (e.g. the pass field) are skipped.
+        void Sort()
+        {
+            if (m_Keys.size() < 2)
+                return;
+
+            m_Scratch.resize(m_Keys.size());
+            for (int shift = 0; shift < 64; shift += 8) {
+                uint32_t counts[256] = {};
+                for (auto& [key, index] : m_Keys)
+                    ++counts[(key >> shift) & 0xFF];
+
+                if (counts[(m_Keys[0].first >> shift) & 0xFF] == m_Keys.size())
+                    continue;
+
+                uint32_t offset = 0;
+                for (auto& count : counts) {
+                    auto bucketSize = count;
+                    count           = offset;
+                    offset += bucketSize;
+                }
+
+                for (auto& entry : m_Keys)
+                    m_Scratch[counts[(entry.first >> shift) & 0xFF]++] = entry;
+                std::swap(m_Keys, m_Scratch);
+            }
+        }
+
+        // onPassBegin(RenderQueuePass) is invoked whenever the pass field changes, e.g. to set up stencil state.
+        // fallbackTexture is bound to unit 0 under the mesh textures, the same as the non-queued path did.
+        template <class OnPassBegin>
+        void Submit(const std::vector<std::shared_ptr<Shader>>& shaders,
+                    const ObjectUniformBuffer&                  objects,
+                    uint32_t                                    fallbackTexture,
+                    RenderStats&                                stats,
+                    OnPassBegin&&                               onPassBegin)
+        {
+            int64_t prevPass = -1, prevShader = -1, prevTextureSet = -1, prevVAO = -1, prevSlot = -1;
+
+            for (auto& [key, index] : m_Keys) {
+                auto& item       = m_Items[index];
+                auto  pass       = static_cast<int64_t>(key >> 60);
+                auto  textureSet = static_cast<int64_t>(m_ItemTextureSets[index]);
+                auto  vao        = static_cast<int64_t>(item.mesh->GetVAO());
+                auto& shader     = shaders[item.shaderIndex];
+
+                if (pass != prevPass) {
+                    onPassBegin(static_cast<RenderQueuePass>(pass));
+                    prevPass = pass;
+                }
+
+                if (item.shaderIndex != prevShader) {
+                    shader->Bind();
+                    prevShader     = item.shaderIndex;
+                    prevTextureSet = -1;  // sampler uniforms are per program
+                    ++stats.programBinds;
+                }
+                else {
+                    ++stats.skippedBinds;
+                }
+
+                if (textureSet != prevTextureSet) {
+                    RHI::ActiveTexture(0);
+                    RHI::BindTexture(GL_TEXTURE_2D, fallbackTexture);
+                    item.mesh->BindTextures(shader);
+                    prevTextureSet = textureSet;
+                    ++stats.textureSetBinds;
+                }
+                else {
+                    ++stats.skippedBinds;
+                }
+
+                if (vao != prevVAO) {
+                    RHI::BindVertexArray(vao);
+                    prevVAO = vao;
+                    ++stats.vertexArrayBinds;
+                }
+                else {
+                    ++stats.skippedBinds;
+                }
+
+                if (item.objectSlot != prevSlot) {
+                    objects.Bind(item.objectSlot);
+                    prevSlot = item.objectSlot;
+                }
+
+                item.mesh->Draw(item.instanceCount, item.firstInstance, item.lod);
+                ++stats.drawCalls;
+                stats.instances += item.instanceCount;
+                stats.triangles += uint64_t(item.mesh->GetLod(item.lod).indexCount / 3) * item.instanceCount;
+            }
+
+            RHI::BindVertexArray(0);
+            RHI::ActiveTexture(0);
+        }
+
+        // GeometryPool variant of Submit: consecutive items sharing pass, shader, texture set and object slot become
+        // one glMultiDrawElementsIndirect. All commands of the queue are uploaded with a single buffer update.
+        template <class OnPassBegin>
+        void SubmitIndirect(const std::vector<std::shared_ptr<Shader>>& shaders,
+                            const ObjectUniformBuffer&                  objects,
+                            uint32_t                                    fallbackTexture,
+                            RenderStats&                                stats,
+                            OnPassBegin&&                               onPassBegin)
+        {
+            if (m_Keys.empty())
+                return;
+
+            // Build the command stream and the runs first, runs break wherever Submit would bind something
+            m_Commands.clear();
+            m_Runs.clear();
+            uint64_t prevState      = ~0ull;
+            uint32_t prevTextureSet = ~0u;
+            for (auto& [key, index] : m_Keys) {
+                auto& item       = m_Items[index];
+                auto  state      = (key >> 52) | (uint64_t(item.objectSlot) << 12);  // pass, shader and object slot
+                auto  textureSet = m_ItemTextureSets[index];
+                if (state != prevState || textureSet != prevTextureSet) {
+                    m_Runs.push_back({index, static_cast<uint32_t>(m_Commands.size()), 0});
+                    prevState      = state;
+                    prevTextureSet = textureSet;
+                }
+
+                auto& allocation = item.mesh->GetPoolAllocation();
+                auto& lod        = item.mesh->GetLod(item.lod);
+                m_Commands.push_back({lod.indexCount, item.instanceCount, allocation.firstIndex + lod.firstIndex, allocation.baseVertex,
+                                      item.firstInstance});
+                ++m_Runs.back().commandCount;
+                stats.instances += item.instanceCount;
+                stats.triangles += uint64_t(lod.indexCount / 3) * item.instanceCount;
+            }
+
+            auto firstCommand = GeometryPool::PushCommands(m_Commands);
+            GeometryPool::Bind();
+
+            int64_t prevPass = -1, prevShader = -1;
+            for (auto& run : m_Runs) {
+                auto& item   = m_Items[run.item];
+                auto  pass   = static_cast<int64_t>(item.pass);
+                auto& shader = shaders[item.shaderIndex];
+
+                if (pass != prevPass) {
+                    onPassBegin(item.pass);
+                    prevPass = pass;
+                }
+
+                if (item.shaderIndex != prevShader) {
+                    shader->Bind();
+                    prevShader = item.shaderIndex;
+                    ++stats.programBinds;
+                }
+
+                RHI::ActiveTexture(0);
+                RHI::BindTexture(GL_TEXTURE_2D, fallbackTexture);
+                item.mesh->BindTextures(shader);
+                ++stats.textureSetBinds;
+
+                objects.Bind(item.objectSlot);
+                GeometryPool::MultiDraw(firstCommand + run.firstCommand, run.commandCount);
+                ++stats.drawCalls;
+            }
+            ++stats.vertexArrayBinds;
+
+            RHI::BindVertexArray(0);
+            RHI::ActiveTexture(0);
+        }
+
+        auto GetSize() const { return m_Items.size(); }
+
+    private:
+        // Dense id per distinct combination of texture objects, 0 is the empty set.
+        uint32_t GetTextureSetID(const Mesh& mesh)
+        {
+            auto& textures = mesh.GetTextures();
+            if (textures.empty())
+                return 0;
+
+            uint64_t hash = 14695981039346656037ull;
+            for (auto& texture : textures)
+                hash = (hash ^ texture.GetID()) * 1099511628211ull;
+
+            auto [iter, inserted] = m_TextureSets.try_emplace(hash, static_cast<uint32_t>(m_TextureSets.size() + 1));
+            return iter->second;
+        }
+
+    private:
+        std::vector<DrawItem>                      m_Items;
+        std::vector<uint32_t>                      m_ItemTextureSets;  // full id per item, the key only holds 16 bits
+        std::vector<std::pair<uint64_t, uint32_t>> m_Keys, m_Scratch;
+        std::unordered_map<uint64_t, uint32_t>     m_TextureSets;
+
+        struct IndirectRun
+        {
+            uint32_t item;  // first item, its state is bound for the whole run
+            uint32_t firstCommand;
+            uint32_t commandCount;
+        };
+        std::vector<DrawElementsIndirectCommand> m_Commands;
+        std::vector<IndirectRun>                 m_Runs;
+    };
+
+}  // namespace suplex
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace suplex {
+
+    // Per-frame counters, reset at the start of Renderer::Render and shown in the editor Setting panel.
+    struct RenderStats
+    {
+        uint32_t drawCalls        = 0;
+        uint32_t instances        = 0;  // meshes drawn, a single instanced draw call counts all of them
+        uint32_t programBinds     = 0;
+        uint32_t textureSetBinds  = 0;
+        uint32_t vertexArrayBinds = 0;
+        uint32_t skippedBinds     = 0;  // program/texture/VAO binds the render queue did not have to issue
+        uint32_t culledObjects    = 0;  // summed over every pass that culls
+        uint64_t triangles        = 0;  // submitted, summed over every pass
+        uint32_t boneMatrices     = 0;  // uploaded in the single BonePaletteBuffer update of the frame
+
+        void Reset() { *this = RenderStats(); }
+    };
+
+}  // namespace suplex
@@ -1,12 +1,17 @@
 #include "Renderer.hpp"
+#include "Asset/AssetManager.hpp"
 #include "Camera/Camera.hpp"
 #include <glad/glad.h>
 #include "GLFW/glfw3.h"
+#include "Render/Buffer/BonePaletteBuffer.hpp"
 #include "Render/Buffer/Depthbuffer.hpp"
 #include "Render/Buffer/Framebuffer.hpp"
+#include "Render/Buffer/GeometryPool.hpp"
+#include "Render/Buffer/InstanceBuffer.hpp"
 #include "Render/Config/Config.hpp"
 #include "Render/Geometry/Shape/Shape.hpp"
 #include "Render/Postprocess/Bloom.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/CubeMapPass.hpp"
 #include "Render/RenderPass/ForwardPass.hpp"
 #include "Render/RenderPass/PostprocessPass.hpp"
@@ -21,6 +26,7 @@
 #include <spdlog/spdlog.h>
 #include <stdint.h>
 #include "Render/Texture/Texture2D.hpp"
+#include "Render/Texture/TextureStreamer.hpp"
 #include "Shader/Shader.hpp"
 #include "Texture/CubeMap.hpp"
 #include "Texture/Texture.hpp"
@@ -34,8 +40,8 @@ namespace suplex {
     Renderer::Renderer()
     {
         // Buffer setting
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
+        RHI::Enable(GL_DEPTH_TEST);
+        RHI::Enable(GL_CULL_FACE);
         glEnable(GL_MULTISAMPLE);
         glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
@@ -80,6 +86,18 @@ namespace suplex {
     {
         m_ActiveCamera = camera;
         Walnut::Timer timer;
+        m_Context->renderStats.Reset();
+        // ImGui and the platform windows touched GL since the last frame
+        RHI::NewFrame();
+        InstanceBuffer::NewFrame();
+        GeometryPool::NewFrame();
+        AssetManager::Update();
+        TextureStreamer::Update(static_cast<size_t>(m_Context->config->textureBudgetMB) << 20);
+        m_Scene->UpdatePendingModels();
+        m_Scene->UpdateTransforms();
+        auto palette = m_Scene->GetAnimationSystem().GetPalette();
+        BonePaletteBuffer::Upload(palette);
+        m_Context->renderStats.boneMatrices = static_cast<uint32_t>(palette.size());
 
         m_DepthPassLS->Render(m_Context->config->lightSetting.cameraLS, m_Scene, m_Context, m_PrecomputeContext);
         m_DepthPass->Render(camera, m_Scene, m_Context, m_PrecomputeContext);
@@ -94,9 +112,7 @@ namespace suplex {
         if (config->lightSetting.useEnvMap) {
             auto cubemapShader = m_EnvMapPass->GetShaders()[0];
             cubemapShader->Bind();
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrecomputeContext->EnvironmentMap.GetID());
-            glUniform1i(glGetUniformLocation(cubemapShader->GetID(), "EnvironmentMap"), 0);
+            cubemapShader->BindTexture("EnvironmentMap", m_PrecomputeContext->EnvironmentMap.GetID(), 0, SamplerType::CubeMap);
             cubemapShader->Unbind();
 
             m_EnvMapPass->Render(camera, m_Scene, m_Context, m_PrecomputeContext);
@@ -116,10 +132,13 @@ namespace suplex {
         glfwMakeContextCurrent(g_WindowHandle);
         glfwSwapInterval((int)config->vsync);
 
+        // The editor only calls OnUpdate while playing, so paused scenes keep their pose
+        m_Scene->UpdateAnimations(ts);
+
         // Polygon Mode
         switch (config->polygonMode) {
-            case PolygonMode::Shaded: glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); break;
-            case PolygonMode::WireFrame: glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); break;
+            case PolygonMode::Shaded: RHI::PolygonMode(GL_FILL); break;
+            case PolygonMode::WireFrame: RHI::PolygonMode(GL_LINE); break;
             default: break;
         }
     }
@@ -140,7 +159,7 @@ namespace suplex {
     {
         // Allocate resource for GPU
         auto config = m_Context->config;
-        glDisable(GL_CULL_FACE);
+        RHI::Disable(GL_CULL_FACE);
         float resolution = config->environmentMapResolution;
         m_PrecomputeContext->HDR_EnvironmentTexture.LoadData("H:/GameDev Asset/Textures/EnvironmentMap/newport_loft.hdr",
                                                              TextureFormat::RGBA32F);
@@ -167,14 +186,14 @@ namespace suplex {
         m_PrecomputePass->PushShader(std::make_shared<Shader>("brdf_integration.vert", "brdf_integration.frag"));
 
         m_PrecomputePass->Render(m_ActiveCamera, m_Scene, m_Context, m_PrecomputeContext);
-        glEnable(GL_CULL_FACE);
+        RHI::Enable(GL_CULL_FACE);
     }
 
     void Renderer::BindRenderPass()
     {
         // Depth Pass
         m_DepthPass           = m_PassQueue.emplace_back(std::make_shared<DepthRenderPass>());
-        m_DepthPassLS         = m_PassQueue.emplace_back(std::make_shared<DepthRenderPass>());
+        m_DepthPassLS         = m_PassQueue.emplace_back(std::make_shared<DepthRenderPass>(true));
         m_Context->depthMap   = m_DepthPass->GetFramebufferImage();
         m_Context->depthMapLS = m_DepthPassLS->GetFramebufferImage();
         m_Context->gPosition  = m_DepthPass->GetFramebuffer()->GetColorAttachmentID(0);
@@ -8,6 +8,7 @@
 #include "Render/Config/Config.hpp"
 #include "Render/Geometry/Model.hpp"
 #include "Render/Postprocess/Bloom.hpp"
+#include "Render/RHI.hpp"
 #include "Render/RenderPass/RenderPass.hpp"
 #include "RenderPass/RenderPass.hpp"
 #include "Scene/Scene.hpp"
@@ -53,6 +54,9 @@ namespace suplex {
 
         float LastFrameRenderTime() const { return m_LastRenderTime; }
 
+        const auto& GetRenderStats() const { return m_Context->renderStats; }
+        const auto& GetStateCacheStats() const { return RHI::GetLastFrameStats(); }
+
         auto& GetGraphicsConfig() { return m_Context->config; }
         auto& GetGraphicsContext() { return m_Context; }
         auto& GetGameObjectList() { return m_Scene; }
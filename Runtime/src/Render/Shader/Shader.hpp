@@ -6,7 +6,13 @@
 #include <string_view>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Render/Buffer/UniformBuffer.hpp"
+#include "Render/RHI.hpp"
 #include "spdlog/spdlog.h"
 
 #include <iostream>
@@ -21,6 +27,22 @@ using namespace spdlog;
 namespace suplex {
     enum class SamplerType { Texture2D, CubeMap };
 
+    // Pre-resolved uniform location, typed so that Shader::Set picks the matching glUniform* call.
+    template <class T>
+    struct UniformHandle
+    {
+        int location = -1;
+
+        bool IsValid() const { return location >= 0; }
+    };
+
+    struct UniformNameHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
     class Shader {
     public:
         Shader(std::string const& vert, std::string const& frag) { LoadFromFile(vert, frag); }
@@ -90,63 +112,141 @@ namespace suplex {
             glDeleteShader(vertex);
             glDeleteShader(fragment);
 
+            ReflectUniforms();
+            BindUniformBlocks();
+
             m_ShaderName = shaderName.empty() ? frag.substr(0, frag.find_last_of('.')) : shaderName;
         }
 
-        void  Bind() { glUseProgram(m_ShaderID); }
-        void  Unbind() { glUseProgram(0); }
+        void  Bind() { RHI::UseProgram(m_ShaderID); }
+        void  Unbind() { RHI::UseProgram(0); }
         auto  GetID() { return m_ShaderID; }
         auto& GetShaderName() { return m_ShaderName; }
 
     public:
-        void BindTexture(std::string const& samplerName, const int textureID, const int index, SamplerType samplerType)
+        // Resolve once (e.g. in a pass constructor) and use the handle in per-frame code.
+        template <class T>
+        UniformHandle<T> GetUniform(std::string_view uniformName) const
         {
-            glActiveTexture(GL_TEXTURE0 + index);
-            glBindTexture(samplerType == SamplerType::Texture2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, textureID);
-            glUniform1i(glGetUniformLocation(m_ShaderID, samplerName.data()), index);
+            return UniformHandle<T>{GetUniformLocation(uniformName)};
         }
 
-        void SetInt(std::string const& uniformName, const int value)
+        int GetUniformLocation(std::string_view uniformName) const
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniform1i(id, value);
+            auto iter = m_UniformLocations.find(uniformName);
+            return iter == m_UniformLocations.end() ? -1 : iter->second;
         }
 
-        void SetFloat(std::string const& uniformName, const float* value_ptr)
+        void Set(UniformHandle<int> uniform, const int value) { glUniform1i(uniform.location, value); }
+        void Set(UniformHandle<float> uniform, const float value) { glUniform1f(uniform.location, value); }
+        void Set(UniformHandle<glm::vec2> uniform, const glm::vec2& value) { glUniform2fv(uniform.location, 1, glm::value_ptr(value)); }
+        void Set(UniformHandle<glm::vec3> uniform, const glm::vec3& value) { glUniform3fv(uniform.location, 1, glm::value_ptr(value)); }
+        void Set(UniformHandle<glm::vec4> uniform, const glm::vec4& value) { glUniform4fv(uniform.location, 1, glm::value_ptr(value)); }
+        void Set(UniformHandle<glm::mat4> uniform, const glm::mat4& value)
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniform1fv(id, 1, value_ptr);
+            glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
         }
 
-        void SetFloat(std::string const& uniformName, const float value)
+        void BindTexture(UniformHandle<int> sampler, const int textureID, const int index, SamplerType samplerType)
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniform1f(id, value);
+            RHI::ActiveTexture(index);
+            RHI::BindTexture(samplerType == SamplerType::Texture2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, textureID);
+            glUniform1i(sampler.location, index);
         }
 
-        void SetFloat2(std::string const& uniformName, const float* value_ptr)
+        void BindTexture(std::string_view samplerName, const int textureID, const int index, SamplerType samplerType)
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniform2fv(id, 1, value_ptr);
+            BindTexture(GetUniform<int>(samplerName), textureID, index, samplerType);
         }
 
-        void SetFloat3(std::string const& uniformName, const float* value_ptr)
+        void SetInt(std::string_view uniformName, const int value) { glUniform1i(GetUniformLocation(uniformName), value); }
+
+        void SetFloat(std::string_view uniformName, const float* value_ptr)
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniform3fv(id, 1, value_ptr);
+            glUniform1fv(GetUniformLocation(uniformName), 1, value_ptr);
         }
 
-        void SetMaterix4(std::string const& uniformName, const float* value_ptr)
+        void SetFloat(std::string_view uniformName, const float value) { glUniform1f(GetUniformLocation(uniformName), value); }
+
+        void SetFloat2(std::string_view uniformName, const float* value_ptr)
+        {
+            glUniform2fv(GetUniformLocation(uniformName), 1, value_ptr);
+        }
+
+        void SetFloat3(std::string_view uniformName, const float* value_ptr)
         {
-            auto id = glGetUniformLocation(m_ShaderID, uniformName.data());
-            glUniformMatrix4fv(id, 1, GL_FALSE, value_ptr);
+            glUniform3fv(GetUniformLocation(uniformName), 1, value_ptr);
+        }
+
+        void SetMaterix4(std::string_view uniformName, const float* value_ptr)
+        {
+            glUniformMatrix4fv(GetUniformLocation(uniformName), 1, GL_FALSE, value_ptr);
         }
 
     private:
         uint32_t    m_ShaderID   = 0;
         std::string m_ShaderName = "New Material";
 
+        std::unordered_map<std::string, int, UniformNameHash, std::equal_to<>> m_UniformLocations;
+
     private:
+        // Build the name -> location table from the linked program so that lookups never reach the driver.
+        // Arrays are reported as "name[0]", register the bare name and every element.
+        void ReflectUniforms()
+        {
+            m_UniformLocations.clear();
+
+            int uniformCount = 0, maxNameLength = 0;
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORMS, &uniformCount);
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+            std::string nameBuffer(maxNameLength, '\0');
+            for (int i = 0; i < uniformCount; ++i) {
+                GLsizei length = 0;
+                GLint   size   = 0;
+                GLenum  type   = 0;
+                glGetActiveUniform(m_ShaderID, i, maxNameLength, &length, &size, &type, nameBuffer.data());
+
+                std::string name(nameBuffer.data(), length);
+                int         location = glGetUniformLocation(m_ShaderID, name.data());
+                if (location < 0)
+                    continue;  // member of a uniform block
+
+                if (name.ends_with("[0]")) {
+                    auto baseName                = name.substr(0, name.size() - 3);
+                    m_UniformLocations[baseName] = location;
+                    for (int element = 0; element < size; ++element) {
+                        auto elementName                = baseName + "[" + std::to_string(element) + "]";
+                        m_UniformLocations[elementName] = glGetUniformLocation(m_ShaderID, elementName.data());
+                    }
+                }
+                else {
+                    m_UniformLocations[name] = location;
+                }
+            }
+            debug("Shader {} has {} active uniforms", m_ShaderID, m_UniformLocations.size());
+        }
+
+        // GLSL 410 has no layout(binding) for blocks, assign the shared binding points by block name instead.
+        void BindUniformBlocks()
+        {
+            int blockCount = 0;
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+
+            char nameBuffer[64];
+            for (int i = 0; i < blockCount; ++i) {
+                GLsizei length = 0;
+                glGetActiveUniformBlockName(m_ShaderID, i, sizeof(nameBuffer), &length, nameBuffer);
+
+                int binding = GetUniformBlockBinding(std::string_view(nameBuffer, length));
+                if (binding < 0) {
+                    error("Shader {} has unknown uniform block {}", m_ShaderID, std::string_view(nameBuffer, length));
+                    continue;
+                }
+                glUniformBlockBinding(m_ShaderID, i, binding);
+            }
+        }
+
         // utility function for checking shader compilation/linking errors.
         // ------------------------------------------------------------------------
         void checkCompileErrors(unsigned int shader, std::string type)
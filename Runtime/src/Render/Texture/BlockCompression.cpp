@@ -0,0 +1,401 @@
+#include "Render/Texture/BlockCompression.hpp"
+#include "Thread/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace suplex {
+
+    namespace {
+        // About this many blocks per ParallelFor chunk
+        constexpr size_t BlocksPerTask = 1024;
+
+        struct Block
+        {
+            uint8_t texels[16][4];
+        };
+
+        // RGB16F texels
+        struct HalfBlock
+        {
+            uint16_t texels[16][3];
+        };
+
+        void LoadBlock(const TextureImage& image, const TextureLevel& level, int blockX, int blockY, Block& block)
+        {
+            auto pixels = image.pixels.data() + level.offset;
+            for (int y = 0; y < 4; ++y) {
+                int sourceY = std::min(blockY * 4 + y, level.height - 1);
+                for (int x = 0; x < 4; ++x) {
+                    int sourceX = std::min(blockX * 4 + x, level.width - 1);
+                    memcpy(block.texels[y * 4 + x], pixels + (static_cast<size_t>(sourceY) * level.width + sourceX) * 4, 4);
+                }
+            }
+        }
+
+        void LoadBlock(const TextureImage& image, const TextureLevel& level, int blockX, int blockY, HalfBlock& block)
+        {
+            auto pixels = image.pixels.data() + level.offset;
+            for (int y = 0; y < 4; ++y) {
+                int sourceY = std::min(blockY * 4 + y, level.height - 1);
+                for (int x = 0; x < 4; ++x) {
+                    int sourceX = std::min(blockX * 4 + x, level.width - 1);
+                    memcpy(block.texels[y * 4 + x], pixels + (static_cast<size_t>(sourceY) * level.width + sourceX) * 6, 6);
+                }
+            }
+        }
+
+        // Mean of the points and the direction of their largest spread (power iteration on the covariance), unit length.
+        void FitAxis(const float points[16][3], float mean[3], float axis[3])
+        {
+            mean[0] = mean[1] = mean[2] = 0.0f;
+            for (int i = 0; i < 16; ++i) {
+                for (int c = 0; c < 3; ++c)
+                    mean[c] += points[i][c];
+            }
+            for (int c = 0; c < 3; ++c)
+                mean[c] /= 16.0f;
+
+            float xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+            for (int i = 0; i < 16; ++i) {
+                float x = points[i][0] - mean[0], y = points[i][1] - mean[1], z = points[i][2] - mean[2];
+                xx += x * x, xy += x * y, xz += x * z;
+                yy += y * y, yz += y * z, zz += z * z;
+            }
+
+            axis[0] = axis[1] = axis[2] = 1.0f;
+            for (int i = 0; i < 4; ++i) {
+                float x = xx * axis[0] + xy * axis[1] + xz * axis[2];
+                float y = xy * axis[0] + yy * axis[1] + yz * axis[2];
+                float z = xz * axis[0] + yz * axis[1] + zz * axis[2];
+                float m = std::max({std::abs(x), std::abs(y), std::abs(z)});
+                if (m < 1e-6f)
+                    break;
+                axis[0] = x / m, axis[1] = y / m, axis[2] = z / m;
+            }
+            float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            for (int c = 0; c < 3; ++c)
+                axis[c] /= length;
+        }
+
+        // Smallest and largest projection of the points onto the axis through mean.
+        void ProjectExtent(const float points[16][3], const float mean[3], const float axis[3], float& low, float& high)
+        {
+            low = high = 0.0f;
+            for (int i = 0; i < 16; ++i) {
+                float projection =
+                    (points[i][0] - mean[0]) * axis[0] + (points[i][1] - mean[1]) * axis[1] + (points[i][2] - mean[2]) * axis[2];
+                low  = std::min(low, projection);
+                high = std::max(high, projection);
+            }
+        }
+
+        uint16_t To565(const float color[3])
+        {
+            auto r = static_cast<int>(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            auto g = static_cast<int>(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+            auto b = static_cast<int>(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            return static_cast<uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        void From565(uint16_t color, int rgb[3])
+        {
+            int r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+
+            rgb[0] = r << 3 | r >> 2;
+            rgb[1] = g << 2 | g >> 4;
+            rgb[2] = b << 3 | b >> 2;
+        }
+
+        void Write16(uint8_t* out, uint16_t value)
+        {
+            out[0] = static_cast<uint8_t>(value);
+            out[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        // Fits a line through the colors and uses its extent, inset by 1/16 on both ends, as endpoints. Always the 4
+        // color mode, so the block is also valid as BC3 color.
+        void EncodeBC1(const Block& block, uint8_t* out)
+        {
+            float points[16][3];
+            for (int i = 0; i < 16; ++i) {
+                for (int c = 0; c < 3; ++c)
+                    points[i][c] = block.texels[i][c];
+            }
+
+            float mean[3], axis[3], minProjection, maxProjection;
+            FitAxis(points, mean, axis);
+            ProjectExtent(points, mean, axis, minProjection, maxProjection);
+            float inset = (maxProjection - minProjection) / 16.0f;
+            float high[3], low[3];
+            for (int c = 0; c < 3; ++c) {
+                high[c] = mean[c] + axis[c] * (maxProjection - inset);
+                low[c]  = mean[c] + axis[c] * (minProjection + inset);
+            }
+
+            uint16_t color0 = To565(high), color1 = To565(low);
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            int palette[4][3];
+            From565(color0, palette[0]);
+            From565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            uint32_t indices = 0;
+            if (color0 != color1) {
+                for (int i = 0; i < 16; ++i) {
+                    int best = 0, bestDistance = INT32_MAX;
+                    for (int p = 0; p < 4; ++p) {
+                        int distance = 0;
+                        for (int c = 0; c < 3; ++c) {
+                            int d = block.texels[i][c] - palette[p][c];
+                            distance += d * d;
+                        }
+                        if (distance < bestDistance)
+                            best = p, bestDistance = distance;
+                    }
+                    indices |= static_cast<uint32_t>(best) << (2 * i);
+                }
+            }
+
+            Write16(out, color0);
+            Write16(out + 2, color1);
+            Write16(out + 4, static_cast<uint16_t>(indices));
+            Write16(out + 6, static_cast<uint16_t>(indices >> 16));
+        }
+
+        // One channel between its block min and max, 8 interpolated values.
+        void EncodeBC4(const Block& block, int channel, uint8_t* out)
+        {
+            int low = 255, high = 0;
+            for (auto& texel : block.texels) {
+                low  = std::min<int>(low, texel[channel]);
+                high = std::max<int>(high, texel[channel]);
+            }
+
+            // Index 0 is high, 1 is low and 2..7 step from high to low
+            uint64_t indices = 0;
+            if (high > low) {
+                int range = high - low;
+                for (int i = 0; i < 16; ++i) {
+                    int step  = ((high - block.texels[i][channel]) * 7 + range / 2) / range;
+                    int index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+                    indices |= static_cast<uint64_t>(index) << (3 * i);
+                }
+            }
+
+            out[0] = static_cast<uint8_t>(high);
+            out[1] = static_cast<uint8_t>(low);
+            for (int i = 0; i < 6; ++i)
+                out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+
+        // BC6H_UF16 reconstruction: endpoints widen from 10 to 16 bits, are interpolated with 6 bit weights and scaled to
+        // the half float bit pattern (31/64), so blocks interpolate in that roughly logarithmic space.
+        constexpr int BC6HWeights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        int UnquantizeBC6H(int value)
+        {
+            if (value == 0)
+                return 0;
+            if (value == 1023)
+                return 0xffff;
+            return ((value << 16) + 0x8000) >> 10;
+        }
+
+        int FinishBC6H(int value) { return (value * 31) >> 6; }
+
+        int InterpolateBC6H(int low, int high, int weight) { return FinishBC6H(((64 - weight) * low + weight * high + 32) >> 6); }
+
+        // The 10 bit endpoint whose reconstruction is closest to the half float bit pattern value.
+        int QuantizeBC6H(float value)
+        {
+            int guess = std::clamp(static_cast<int>(std::lround((value * 64.0f / 31.0f - 32.0f) / 64.0f)), 0, 1023);
+            int best = guess, bestError = INT32_MAX;
+            for (int candidate = std::max(guess - 1, 0); candidate <= std::min(guess + 1, 1023); ++candidate) {
+                int error = std::abs(FinishBC6H(UnquantizeBC6H(candidate)) - static_cast<int>(value + 0.5f));
+                if (error < bestError)
+                    best = candidate, bestError = error;
+            }
+            return best;
+        }
+
+        struct BitWriter
+        {
+            uint8_t* out;
+            int      position = 0;
+
+            void Write(uint32_t value, int count)
+            {
+                for (int i = 0; i < count; ++i, ++position) {
+                    if (value >> i & 1)
+                        out[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+                }
+            }
+        };
+
+        // Mode 11 only: one region, 10 bit endpoints stored without deltas and a 4 bit index per texel. The line is fit
+        // through the half float bit patterns, negative texels clamp to 0 and larger than finite ones to the largest half
+        // since BC6H_UF16 stores neither.
+        void EncodeBC6H(const HalfBlock& block, uint8_t* out)
+        {
+            float points[16][3];
+            for (int i = 0; i < 16; ++i) {
+                for (int c = 0; c < 3; ++c) {
+                    uint16_t half = block.texels[i][c];
+                    points[i][c]  = half & 0x8000 ? 0.0f : static_cast<float>(std::min<uint16_t>(half, 0x7bff));
+                }
+            }
+
+            float mean[3], axis[3], minProjection, maxProjection;
+            FitAxis(points, mean, axis);
+            ProjectExtent(points, mean, axis, minProjection, maxProjection);
+
+            float line[2][3];
+            for (int c = 0; c < 3; ++c) {
+                line[0][c] = mean[c] + axis[c] * minProjection;
+                line[1][c] = mean[c] + axis[c] * maxProjection;
+            }
+
+            // Picks the nearest palette entries, then refits every channel's endpoints to those weights by least squares,
+            // which follows texels off the principal axis
+            int endpoints[2][3], indices[16];
+            for (int pass = 0; pass < 3; ++pass) {
+                for (int c = 0; c < 3; ++c) {
+                    endpoints[0][c] = QuantizeBC6H(std::clamp(line[0][c], 0.0f, 31743.0f));
+                    endpoints[1][c] = QuantizeBC6H(std::clamp(line[1][c], 0.0f, 31743.0f));
+                }
+
+                int palette[16][3];
+                for (int p = 0; p < 16; ++p) {
+                    for (int c = 0; c < 3; ++c)
+                        palette[p][c] = InterpolateBC6H(UnquantizeBC6H(endpoints[0][c]), UnquantizeBC6H(endpoints[1][c]), BC6HWeights[p]);
+                }
+
+                for (int i = 0; i < 16; ++i) {
+                    int64_t bestDistance = INT64_MAX;
+                    for (int p = 0; p < 16; ++p) {
+                        int64_t distance = 0;
+                        for (int c = 0; c < 3; ++c) {
+                            int64_t d = static_cast<int>(points[i][c]) - palette[p][c];
+                            distance += d * d;
+                        }
+                        if (distance < bestDistance)
+                            indices[i] = p, bestDistance = distance;
+                    }
+                }
+
+                // Normal equations of texel = (1 - t) * low + t * high, singular when every texel picked the same weight
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+                for (int i = 0; i < 16; ++i) {
+                    float t = BC6HWeights[indices[i]] / 64.0f, s = 1.0f - t;
+                    aa += s * s, ab += s * t, bb += t * t;
+                    for (int c = 0; c < 3; ++c)
+                        ax[c] += s * points[i][c], bx[c] += t * points[i][c];
+                }
+                float determinant = aa * bb - ab * ab;
+                if (std::abs(determinant) < 1e-6f)
+                    break;
+                for (int c = 0; c < 3; ++c) {
+                    line[0][c] = (ax[c] * bb - bx[c] * ab) / determinant;
+                    line[1][c] = (bx[c] * aa - ax[c] * ab) / determinant;
+                }
+            }
+
+            // The first index is stored without its top bit, the weights are symmetric so swapping the endpoints and
+            // mirroring the indices clears it
+            if (indices[0] & 8) {
+                std::swap(endpoints[0], endpoints[1]);
+                for (int& index : indices)
+                    index = 15 - index;
+            }
+
+            memset(out, 0, 16);
+            BitWriter bits{out};
+            bits.Write(0x03, 5);
+            for (auto& endpoint : endpoints) {
+                for (int c = 0; c < 3; ++c)
+                    bits.Write(endpoint[c], 10);
+            }
+            for (int i = 0; i < 16; ++i)
+                bits.Write(indices[i], i == 0 ? 3 : 4);
+        }
+    }  // namespace
+
+    TextureImage Compress(const TextureImage& image, PixelFormat format)
+    {
+        auto sourceFormat = format == PixelFormat::BC6H ? PixelFormat::RGB16F : PixelFormat::RGBA8;
+        if (format == PixelFormat::RGBA8 || format == PixelFormat::RGB16F || image.format != sourceFormat || image.levels.empty())
+            return image;
+
+        TextureImage result;
+        result.channels = image.channels;
+        result.Allocate(image.width, image.height, format);
+
+        // The blocks of all levels form one range, so the small levels do not each pay for a ParallelFor
+        std::vector<size_t> firstBlocks;
+        size_t              blockCount = 0;
+        for (auto& level : image.levels) {
+            firstBlocks.push_back(blockCount);
+            blockCount += static_cast<size_t>((level.width + 3) / 4) * ((level.height + 3) / 4);
+        }
+
+        size_t blockSize = format == PixelFormat::BC1 ? 8 : 16;
+        ThreadPool::ParallelFor(blockCount, BlocksPerTask, [&](size_t begin, size_t end) {
+            size_t level = std::upper_bound(firstBlocks.begin(), firstBlocks.end(), begin) - firstBlocks.begin() - 1;
+            for (size_t i = begin; i < end; ++i) {
+                while (level + 1 < firstBlocks.size() && i >= firstBlocks[level + 1])
+                    ++level;
+
+                auto&  source  = image.levels[level];
+                size_t index   = i - firstBlocks[level];
+                int    blocksX = (source.width + 3) / 4;
+
+                auto out    = result.pixels.data() + result.levels[level].offset + index * blockSize;
+                auto blockX = static_cast<int>(index % blocksX), blockY = static_cast<int>(index / blocksX);
+                if (format == PixelFormat::BC6H) {
+                    HalfBlock block;
+                    LoadBlock(image, source, blockX, blockY, block);
+                    EncodeBC6H(block, out);
+                    continue;
+                }
+
+                Block block;
+                LoadBlock(image, source, blockX, blockY, block);
+                switch (format) {
+                    case PixelFormat::BC1: EncodeBC1(block, out); break;
+                    case PixelFormat::BC3:
+                        EncodeBC4(block, 3, out);
+                        EncodeBC1(block, out + 8);
+                        break;
+                    case PixelFormat::BC5:
+                        EncodeBC4(block, 0, out);
+                        EncodeBC4(block, 1, out + 8);
+                        break;
+                    default: break;
+                }
+            }
+        });
+        return result;
+    }
+
+    bool HasAlpha(const TextureImage& image)
+    {
+        if (image.format != PixelFormat::RGBA8 || image.levels.empty())
+            return false;
+
+        auto&  level  = image.levels[0];
+        auto   pixels = image.pixels.data() + level.offset;
+        size_t count  = static_cast<size_t>(level.width) * level.height;
+        for (size_t i = 0; i < count; ++i) {
+            if (pixels[i * 4 + 3] != 255)
+                return true;
+        }
+        return false;
+    }
+
+}  // namespace suplex
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Render/Texture/TextureImage.hpp"
+
+namespace suplex {
+
+    // Encodes every level of an RGBA8 image to BC1, BC3 or BC5, or of an RGB16F image to BC6H (unsigned). Blocks are
+    // independent and split over the ThreadPool; the result only depends on the input, not on the thread count. Edge
+    // blocks of levels smaller than 4x4 repeat the last row/column. BC1 and BC3 fit the stored values, so sRGB images
+    // stay sRGB encoded. Any other combination returns the image unchanged.
+    TextureImage Compress(const TextureImage& image, PixelFormat format);
+
+    // True if any texel of level 0 is not fully opaque.
+    bool HasAlpha(const TextureImage& image);
+
+}  // namespace suplex
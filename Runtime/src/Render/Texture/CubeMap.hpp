@@ -1,6 +1,8 @@
 #pragma once
+#include "Render/RHI.hpp"
 #include "Render/Shader/Shader.hpp"
 #include "Render/Texture/Texture.hpp"
+#include "Render/Texture/TextureCook.hpp"
 #include "glad/glad.h"
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
@@ -22,12 +24,12 @@ namespace suplex {
         virtual void Allocate() override
         {
             glGenTextures(1, &m_TextureID);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
         };
 
         void AllocateCubeMap(float resolution)
         {
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
 
             for (unsigned int i = 0; i < 6; ++i) {
                 // note that we store each face with 16 bit floating point values
@@ -43,7 +45,7 @@ namespace suplex {
         void AllocateMipCubeMap(float resolution)
         {
             glGenTextures(1, &m_TextureID);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID);
             for (unsigned int i = 0; i < 6; ++i) {
                 glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, resolution, resolution, 0, GL_RGB, GL_FLOAT, nullptr);
             }
@@ -64,8 +66,24 @@ namespace suplex {
 
         void LoadData(std::vector<std::string> const& paths, TextureFormat format)
         {
-            stbi_set_flip_vertically_on_load(true);
+            stbi_set_flip_vertically_on_load_thread(true);
             for (unsigned int i = 0; i < paths.size(); i++) {
+                if (format == TextureFormat::RGBA32F) {
+                    // HDR faces are cooked to BC6H once (see TextureCook), every level is uploaded
+                    auto image = TextureCook::Cook(texture_prefix + paths[i], TextureUsage::HDR);
+                    if (image.levels.empty())
+                        spdlog::error("Cubemap texture failed to load at path: {}", paths[i]);
+                    for (size_t level = 0; level < image.levels.size(); ++level) {
+                        auto& record = image.levels[level];
+                        glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, static_cast<GLint>(level),
+                                               GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, record.width, record.height, 0,
+                                               static_cast<GLsizei>(record.size), image.pixels.data() + record.offset);
+                    }
+                    m_Width = image.width, m_Height = image.height, m_Channels = image.channels;
+                    m_GPUBytes += image.GetSize();
+                    continue;
+                }
+
                 void* data;
                 switch (format) {
                     case TextureFormat::RGB:
@@ -79,10 +97,6 @@ namespace suplex {
                                      data);
                         break;
 
-                    case TextureFormat::RGBA32F:
-                        data = stbi_loadf((texture_prefix + paths[i]).c_str(), &m_Width, &m_Height, &m_Channels, 0);
-                        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, m_Width, m_Height, 0, GL_RGBA, GL_FLOAT, data);
-                        break;
                     default: error("Not Supported Format!"); break;
                 }
 
@@ -90,7 +104,7 @@ namespace suplex {
                     spdlog::error("Cubemap texture failed to load at path: {}", paths[i]);
                 stbi_image_free(data);
             }
-            stbi_set_flip_vertically_on_load(false);
+            stbi_set_flip_vertically_on_load_thread(false);
 
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -36,11 +36,17 @@ namespace suplex {
 
         const auto GetType() const { return m_Type; }
 
+        const auto& GetPath() const { return m_Path; }
+
+        // Estimated video memory of the texture including its mip chain, 0 until data is uploaded.
+        size_t GetGPUBytes() const { return m_GPUBytes; }
+
     protected:
         uint32_t    m_TextureID = 0;
         int         m_Width = 0, m_Height = 0, m_Channels = 0;
         uint8_t*    m_ImageData = nullptr;
         std::string m_Type;
         std::string m_Path;
+        size_t      m_GPUBytes = 0;
     };
 }  // namespace suplex
\ No newline at end of file
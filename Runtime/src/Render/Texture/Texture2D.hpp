@@ -1,12 +1,19 @@
 #pragma once
 #include "Render/Buffer/Framebuffer.hpp"
+#include "Render/Buffer/PixelUnpackBuffer.hpp"
+#include "Render/RHI.hpp"
 #include "Render/Texture/Texture.hpp"
+#include "Render/Texture/TextureCook.hpp"
+#include "Render/Texture/TextureImage.hpp"
+#include "Render/Texture/TextureStreamer.hpp"
+#include "Thread/ThreadPool.hpp"
 #include <algorithm>
 #include <assimp/texture.h>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/fwd.hpp>
 #include <iostream>
+#include <memory>
 
 #include <stb_image.h>
 #include <stdint.h>
@@ -20,6 +27,12 @@
 using namespace glm;
 using namespace spdlog;
 
+// EXT_texture_compression_s3tc, not part of core GL but available on every desktop driver
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+    #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace suplex {
 
     struct Texture2DSpecification
@@ -45,8 +58,10 @@ namespace suplex {
 
             m_Width = w, m_Height = h;
 
+            m_GPUBytes = static_cast<size_t>(w) * h * 4;
+
             // pre-allocate enough memory for the LUT texture.
-            glBindTexture(GL_TEXTURE_2D, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_TextureID);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, w, h, 0, GL_RG, GL_FLOAT, 0);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -58,7 +73,7 @@ namespace suplex {
         {
             auto data = new uint8_t[m_Width * m_Height * 3];
             std::fill(data, data + (m_Width * m_Height * 3), 255);
-            glBindTexture(GL_TEXTURE_2D, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_TextureID);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
             delete[] data;
             info("Create Solid Texture");
@@ -70,135 +85,239 @@ namespace suplex {
                 stbi_image_free(m_ImageData);
         }
 
+        // The flip flag is per thread, so worker threads decoding at the same time are not affected
         virtual void LoadData(std::string const& path, TextureFormat format) override
         {
-            stbi_set_flip_vertically_on_load(true);
+            stbi_set_flip_vertically_on_load_thread(true);
 
             LoadTextureFromFile(path.data(), format);
 
-            stbi_set_flip_vertically_on_load(false);
+            stbi_set_flip_vertically_on_load_thread(false);
         }
 
         virtual void LoadData(void* data, TextureFormat format) override
         {
-            glBindTexture(GL_TEXTURE_2D, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_TextureID);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, 4, 4, 0, GL_RGB, GL_FLOAT, data);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            m_GPUBytes = 4 * 4 * 8;
         }
 
-        virtual void LoadData(const aiTexture* aiTex, TextureFormat format) override { LoadTextureFromMemory(aiTex); }
+        virtual void LoadData(const aiTexture* aiTex, TextureFormat format) override
+        {
+            // Embedded FBX textures are a compressed image file (mHeight == 0)
+            auto size = aiTex->mHeight == 0 ? aiTex->mWidth : aiTex->mWidth * aiTex->mHeight;
+            LoadTextureFromMemory(reinterpret_cast<const uint8_t*>(aiTex->pcData), size);
+        }
 
-    private:
-        void LoadTextureFromFile(std::string_view path, TextureFormat format)
+        // Decodes an image file held in memory, e.g. an embedded texture kept in the mesh cache.
+        void LoadData(const uint8_t* data, size_t size) { LoadTextureFromMemory(data, size); }
+
+        // Safe on any thread, no GL calls: decodes to RGBA and builds the mip chain on the ThreadPool.
+        // Files are flipped like LoadData(path) does, embedded images are not.
+        static TextureImage Decode(const std::string& path, ColorSpace colorSpace = ColorSpace::sRGB)
         {
-            if (format == TextureFormat::RGB) {
-                glGenTextures(1, &m_TextureID);
-                glBindTexture(GL_TEXTURE_2D, m_TextureID);
-                // set the texture wrapping parameters
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                // set texture filtering parameters
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                // load image, create texture and generate mipmaps
-                // stbi_set_flip_vertically_on_load(true);
-                // tell stb_image.h to flip loaded texture's on the y-axis.
-                // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-                uint8_t* data = stbi_load(path.data(), &m_Width, &m_Height, &m_Channels, STBI_rgb);
-                if (data) {
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                    info("Load Texture from path {}", path.data());
-                }
-                else {
-                    error("Failed to load texture");
-                }
-                stbi_image_free(data);
-            }
-            else if (format == TextureFormat::RGBA) {
-                glGenTextures(1, &m_TextureID);
-                glBindTexture(GL_TEXTURE_2D, m_TextureID);
-                // set the texture wrapping parameters
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                // set texture filtering parameters
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                // load image, create texture and generate mipmaps
-                // stbi_set_flip_vertically_on_load(true);
-                // tell stb_image.h to flip loaded texture's on the y-axis.
-                // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-                uint8_t* data = stbi_load(path.data(), &m_Width, &m_Height, &m_Channels, STBI_rgb_alpha);
-                if (data) {
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                    info("Load Texture from path {}", path.data());
-                }
-                else {
-                    error("Failed to load texture");
-                }
-                stbi_image_free(data);
-            }
+            stbi_set_flip_vertically_on_load_thread(true);
 
-            else {
-                int   width, height, nrComponents;
-                void* data = stbi_loadf(path.data(), &width, &height, &nrComponents, 0);
-                if (data) {
-                    glGenTextures(1, &m_TextureID);
-                    glBindTexture(GL_TEXTURE_2D, m_TextureID);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
-
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            int  width, height, channels;
+            auto pixels = stbi_load(path.data(), &width, &height, &channels, STBI_rgb_alpha);
+            if (!pixels)
+                error("Failed to load texture {}", path);
 
-                    info("Load HDR Image for cube map successful.");
-                }
-                else {
-                    error("Failed to load HDR image.");
-                }
-                stbi_image_free(data);
-            }
-            // stbi_set_flip_vertically_on_load(false);
+            stbi_set_flip_vertically_on_load_thread(false);
+            return CreateImage(pixels, width, height, channels, colorSpace);
         }
 
-        void LoadTextureFromMemory(const aiTexture* aiTex)
+        static TextureImage Decode(const uint8_t* encoded, size_t size, ColorSpace colorSpace = ColorSpace::sRGB)
+        {
+            stbi_set_flip_vertically_on_load_thread(false);
+
+            int  width, height, channels;
+            auto pixels = stbi_load_from_memory(encoded, static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
+            if (!pixels)
+                error("Failed to load texture");
+            return CreateImage(pixels, width, height, channels, colorSpace);
+        }
+
+        // Decode for HDR images (.hdr): RGB16F with the mips averaged as floats, flipped like Decode. See TextureUsage::HDR.
+        static TextureImage DecodeHDR(const std::string& path)
+        {
+            stbi_set_flip_vertically_on_load_thread(true);
+
+            int  width, height, channels;
+            auto pixels = stbi_loadf(path.data(), &width, &height, &channels, STBI_rgb);
+            if (!pixels)
+                error("Failed to load HDR image {}", path);
+
+            stbi_set_flip_vertically_on_load_thread(false);
+            return CreateHDRImage(pixels, width, height, channels);
+        }
+
+        static TextureImage DecodeHDR(const uint8_t* encoded, size_t size)
+        {
+            stbi_set_flip_vertically_on_load_thread(false);
+
+            int  width, height, channels;
+            auto pixels = stbi_loadf_from_memory(encoded, static_cast<int>(size), &width, &height, &channels, STBI_rgb);
+            if (!pixels)
+                error("Failed to load HDR image");
+            return CreateHDRImage(pixels, width, height, channels);
+        }
+
+        // Creates the texture from a decoded image, a failed decode still gets an (empty) texture object.
+        // Every level is staged in the PixelUnpackBuffer and copied from there, no glGenerateMipmap. Block compressed
+        // images (see TextureCook) keep their format, format only applies to RGBA8 ones.
+        void Upload(const TextureImage& image, TextureFormat format = TextureFormat::RGB)
         {
             glGenTextures(1, &m_TextureID);
-            glBindTexture(GL_TEXTURE_2D, m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_TextureID);
             // set the texture wrapping parameters
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            // set texture wrapping to GL_REPEAT (default wrapping method)
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
             // set texture filtering parameters
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // load image, create texture and generate mipmaps
 
-            uint8_t* data = nullptr;
+            if (image.levels.empty())
+                return;
+
+            m_Width = image.width, m_Height = image.height, m_Channels = image.channels;
+
+            auto levelCount     = static_cast<GLsizei>(image.levels.size());
+            auto internalFormat = GetInternalFormat(image.format, format);
+            glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, m_Width, m_Height);
 
-            // Read texture from memory when processing FBX format
-            if (aiTex->mHeight == 0) {
-                data = stbi_load_from_memory(reinterpret_cast<uint8_t*>(aiTex->pcData), aiTex->mWidth, &m_Width, &m_Height,
-                                             &m_Channels, STBI_rgb);
+            // RGB half rows are only 2 byte aligned
+            if (image.format == PixelFormat::RGB16F)
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+
+            bool staged = PixelUnpackBuffer::Stage(image.pixels.data(), image.GetSize());
+
+            for (GLsizei i = 0; i < levelCount; ++i) {
+                auto& level  = image.levels[i];
+                auto  pixels = staged ? reinterpret_cast<const void*>(level.offset) : image.pixels.data() + level.offset;
+                if (image.format == PixelFormat::RGBA8)
+                    glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+                else if (image.format == PixelFormat::RGB16F)
+                    glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, GL_RGB, GL_HALF_FLOAT, pixels);
+                else
+                    glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, internalFormat,
+                                              static_cast<GLsizei>(level.size), pixels);
             }
-            else {
-                data = stbi_load_from_memory(reinterpret_cast<uint8_t*>(aiTex->pcData), aiTex->mWidth * aiTex->mHeight, &m_Width,
-                                             &m_Height, &m_Channels, STBI_rgb);
+            if (staged)
+                PixelUnpackBuffer::Unbind();
+            if (image.format == PixelFormat::RGB16F)
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+            m_GPUBytes = image.GetSize();
+        }
+
+        // Like Upload, but only the coarse levels are uploaded now and the TextureStreamer keeps the image to load and
+        // evict the finer ones as the texture's footprint changes.
+        void Stream(TextureImage&& image)
+        {
+            glGenTextures(1, &m_TextureID);
+            RHI::BindTexture(GL_TEXTURE_2D, m_TextureID);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            if (image.levels.empty())
+                return;
+
+            m_Width = image.width, m_Height = image.height, m_Channels = image.channels;
+            m_GPUBytes = image.GetSize();
+            TextureStreamer::Register(m_TextureID, std::move(image));
+        }
+
+        // Deletes the GL texture, copies of this texture must not be bound afterwards.
+        void Release()
+        {
+            TextureStreamer::Unregister(m_TextureID);
+            if (m_TextureID)
+                RHI::DeleteTextures(1, &m_TextureID);
+            m_TextureID = 0;
+            m_GPUBytes  = 0;
+        }
+
+        static GLenum GetInternalFormat(PixelFormat pixelFormat, TextureFormat format)
+        {
+            switch (pixelFormat) {
+                case PixelFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case PixelFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case PixelFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+                case PixelFormat::BC6H: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+                case PixelFormat::RGB16F: return GL_RGB16F;
+                default: return format == TextureFormat::RGBA ? GL_RGBA8 : GL_RGB8;
             }
+        }
 
-            if (data) {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-                glGenerateMipmap(GL_TEXTURE_2D);
+    private:
+        void LoadTextureFromFile(std::string_view path, TextureFormat format)
+        {
+            if (format == TextureFormat::RGB || format == TextureFormat::RGBA) {
+                // The flip flag set by LoadData applies to Decode as well, it sets and clears it on this thread
+                auto image = Decode(std::string(path), ColorSpace::sRGB);
+                Upload(image, format);
+                if (!image.levels.empty())
+                    info("Load Texture from path {}", path.data());
             }
+
             else {
-                error("Failed to load texture");
+                // BC6H through the TextureCook, a sixth of the RGB16F size and decoded only on the first run. Sampled
+                // from level 0 like before, mips would blur the seam of the equirectangular map
+                auto image = TextureCook::Cook(std::string(path), TextureUsage::HDR);
+                Upload(image);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+                if (!image.levels.empty())
+                    info("Load HDR Image for cube map successful.");
+                else
+                    error("Failed to load HDR image.");
             }
-            stbi_image_free(data);
+            // stbi_set_flip_vertically_on_load(false);
+        }
+
+        void LoadTextureFromMemory(const uint8_t* encoded, size_t size) { Upload(Decode(encoded, size)); }
+
+        // Takes ownership of stb pixels (nullptr for a failed decode, giving an empty image)
+        static TextureImage CreateImage(uint8_t* pixels, int width, int height, int channels, ColorSpace colorSpace)
+        {
+            TextureImage image;
+            if (!pixels)
+                return image;
+
+            image.channels = channels;
+            image.Allocate(width, height);
+            memcpy(image.GetLevel(0), pixels, static_cast<size_t>(width) * height * 4);
+            stbi_image_free(pixels);
+
+            GenerateMips(image, colorSpace);
+            return image;
+        }
+
+        // Takes ownership of stb float RGB pixels, like CreateImage
+        static TextureImage CreateHDRImage(float* pixels, int width, int height, int channels)
+        {
+            TextureImage image;
+            if (!pixels)
+                return image;
+
+            // stb decodes the scanlines serially, the half float conversion is split over the ThreadPool
+            auto halves    = ConvertToHalf(pixels, static_cast<size_t>(width) * height * 3);
+            image.channels = channels;
+            image.Allocate(width, height, PixelFormat::RGB16F);
+            memcpy(image.GetLevel(0), halves.data(), halves.size() * sizeof(uint16_t));
+            stbi_image_free(pixels);
+
+            GenerateMips(image, ColorSpace::Linear);
+            return image;
         }
     };
 }  // namespace suplex
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Render/Texture/TextureCache.hpp"
+#include "IO/Hash.hpp"
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+namespace suplex {
+
+    std::unordered_map<std::string, TextureCache::Entry> TextureCache::s_Entries;
+    std::unordered_map<uint32_t, std::string>            TextureCache::s_Keys;
+    TextureCacheStats                                    TextureCache::s_Stats;
+
+    template <class Load>
+    Texture2D TextureCache::AcquireEntry(const std::string& key, Load&& load)
+    {
+        auto [iter, inserted] = s_Entries.try_emplace(key);
+        auto& entry           = iter->second;
+        if (inserted) {
+            load(entry.texture);
+            ++s_Stats.misses;
+
+            // Failed loads stay cached as a null texture, a missing file shared by many meshes is only reported once.
+            // They own no GL object and cannot be told apart in Release, so they are not reference counted
+            if (entry.texture.GetID() == 0)
+                return entry.texture;
+
+            s_Keys[entry.texture.GetID()] = key;
+            ++s_Stats.residentTextures;
+            s_Stats.residentBytes += entry.texture.GetGPUBytes();
+        }
+        else {
+            ++s_Stats.hits;
+            if (entry.texture.GetID() == 0)
+                return entry.texture;
+        }
+
+        ++entry.references;
+        return entry.texture;
+    }
+
+    std::string TextureCache::GetKey(const std::string& path, TextureFormat format, TextureUsage usage)
+    {
+        auto resolved = std::filesystem::path(path).lexically_normal().generic_string();
+        return fmt::format("{}|{}|{}", resolved, static_cast<int>(format), static_cast<int>(usage));
+    }
+
+    std::string TextureCache::GetKey(const uint8_t* encoded, size_t size, TextureUsage usage)
+    {
+        return fmt::format("embedded|{:016x}|{}|{}", Hash64(encoded, size), size, static_cast<int>(usage));
+    }
+
+    Texture2D TextureCache::Acquire(const std::string& path, TextureFormat format)
+    {
+        return AcquireEntry(GetKey(path, format), [&](Texture2D& texture) {
+            auto resolved = std::filesystem::path(path).lexically_normal().generic_string();
+            texture.LoadData(resolved, format);
+            texture.SetPath(resolved);
+        });
+    }
+
+    Texture2D TextureCache::Acquire(const uint8_t* encoded, size_t size)
+    {
+        return AcquireEntry(GetKey(encoded, size), [&](Texture2D& texture) { texture.LoadData(encoded, size); });
+    }
+
+    Texture2D TextureCache::Acquire(const std::string& key, TextureImage&& image)
+    {
+        return AcquireEntry(key, [&](Texture2D& texture) { texture.Stream(std::move(image)); });
+    }
+
+    void TextureCache::Release(const Texture2D& texture)
+    {
+        auto key = s_Keys.find(texture.GetID());
+        if (key == s_Keys.end())
+            return;
+
+        auto entry = s_Entries.find(key->second);
+        if (--entry->second.references > 0)
+            return;
+
+        --s_Stats.residentTextures;
+        s_Stats.residentBytes -= entry->second.texture.GetGPUBytes();
+        entry->second.texture.Release();
+        s_Entries.erase(entry);
+        s_Keys.erase(key);
+    }
+
+}  // namespace suplex
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Render/Texture/Texture2D.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+namespace suplex {
+
+    struct TextureCacheStats
+    {
+        uint32_t hits             = 0;
+        uint32_t misses           = 0;
+        uint32_t residentTextures = 0;
+        size_t   residentBytes    = 0;
+    };
+
+    // Process wide cache of decoded textures, so an atlas shared by many meshes or models is decoded and uploaded once.
+    // Files are keyed by their normalized path and format, embedded images by a hash of their bytes (the aiTexture
+    // pointer is not stable, the same image comes from the Assimp scene on import and from the mapped MeshCache file later).
+    // Every Acquire() holds a reference on the GL texture, which is deleted when the last one is given back. Failed loads
+    // are remembered as null textures for the lifetime of the process and not retried.
+    class TextureCache {
+    public:
+        static Texture2D Acquire(const std::string& path, TextureFormat format = TextureFormat::RGB);
+        static Texture2D Acquire(const uint8_t* encoded, size_t size);
+        static void      Release(const Texture2D& texture);
+
+        // For images decoded ahead of time on another thread, image is only used on a miss: it is handed to the
+        // TextureStreamer, see Texture2D::Stream. The keys are plain functions of their arguments and can be computed on
+        // any thread.
+        static Texture2D   Acquire(const std::string& key, TextureImage&& image);
+        // Images loaded for different usages have different mips and formats and never share an entry.
+        static std::string GetKey(const std::string& path, TextureFormat format = TextureFormat::RGB,
+                                  TextureUsage usage = TextureUsage::Color);
+        static std::string GetKey(const uint8_t* encoded, size_t size, TextureUsage usage = TextureUsage::Color);
+
+        static const TextureCacheStats& GetStats() { return s_Stats; }
+
+    private:
+        struct Entry
+        {
+            Texture2D texture;
+            uint32_t  references = 0;
+        };
+
+        // Adds a reference to the entry of key, calling load(Texture2D&) on a miss
+        template <class Load>
+        static Texture2D AcquireEntry(const std::string& key, Load&& load);
+
+    private:
+        static std::unordered_map<std::string, Entry>    s_Entries;
+        static std::unordered_map<uint32_t, std::string> s_Keys;  // GL texture -> entry, for Release
+        static TextureCacheStats                         s_Stats;
+    };
+
+}  // namespace suplex
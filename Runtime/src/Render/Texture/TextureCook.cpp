@@ -0,0 +1,193 @@
+#include "Render/Texture/TextureCook.hpp"
+#include "IO/Hash.hpp"
+#include "IO/MappedFile.hpp"
+#include "Render/Texture/BlockCompression.hpp"
+#include "Render/Texture/Texture2D.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace suplex {
+
+    std::string TextureCook::s_Directory = "Cache/Texture";
+
+    namespace {
+        // Bump whenever the records below or the encoders change
+        constexpr uint32_t CookVersion = 1;
+        constexpr uint32_t CookMagic   = 0x58455453;  // "STEX"
+        constexpr uint32_t MaxLevels   = 32;
+
+        struct Header
+        {
+            uint32_t magic        = CookMagic;
+            uint32_t version      = CookVersion;
+            uint64_t key          = 0;
+            uint32_t format       = 0;
+            int32_t  width        = 0;
+            int32_t  height       = 0;
+            int32_t  channels     = 0;
+            uint32_t levelCount   = 0;
+            uint32_t padding      = 0;
+            uint64_t levelsOffset = 0;
+            uint64_t dataOffset   = 0;
+            uint64_t dataSize     = 0;
+        };
+
+        // Like a KTX2 level index, offsets are relative to the data block
+        struct LevelRecord
+        {
+            int32_t  width, height;
+            uint64_t offset, size;
+        };
+
+        PixelFormat ChooseFormat(const TextureImage& image, TextureUsage usage)
+        {
+            if (usage == TextureUsage::HDR)
+                return PixelFormat::BC6H;
+            if (usage == TextureUsage::Normal)
+                return PixelFormat::BC5;
+            return HasAlpha(image) ? PixelFormat::BC3 : PixelFormat::BC1;
+        }
+    }  // namespace
+
+    uint64_t TextureCook::GetKey(const uint8_t* source, size_t size, TextureUsage usage)
+    {
+        uint32_t layout[] = {CookVersion, static_cast<uint32_t>(usage)};
+        return Hash64(source, size, Hash64(layout, sizeof(layout)));
+    }
+
+    std::string TextureCook::GetPath(uint64_t key) { return fmt::format("{}/{:016x}.tex", s_Directory, key); }
+
+    TextureImage TextureCook::Cook(const std::string& path, TextureUsage usage)
+    {
+        TextureImage image;
+        uint64_t     key = 0;
+        {
+            MappedFile source(path);
+            if (source.IsOpen())
+                key = GetKey(source.GetData(), source.GetSize(), usage);
+        }
+        if (key && Load(key, image))
+            return image;
+
+        image = usage == TextureUsage::HDR ? Texture2D::DecodeHDR(path) : Texture2D::Decode(path, GetColorSpace(usage));
+        if (image.levels.empty())
+            return image;
+
+        image = Compress(image, ChooseFormat(image, usage));
+        Store(key, image);
+        return image;
+    }
+
+    TextureImage TextureCook::Cook(const uint8_t* encoded, size_t size, TextureUsage usage)
+    {
+        TextureImage image;
+        auto         key = GetKey(encoded, size, usage);
+        if (Load(key, image))
+            return image;
+
+        image = usage == TextureUsage::HDR ? Texture2D::DecodeHDR(encoded, size) : Texture2D::Decode(encoded, size, GetColorSpace(usage));
+        if (image.levels.empty())
+            return image;
+
+        image = Compress(image, ChooseFormat(image, usage));
+        Store(key, image);
+        return image;
+    }
+
+    bool TextureCook::Load(uint64_t key, TextureImage& image)
+    {
+        if (key == 0)
+            return false;
+
+        MappedFile file(GetPath(key));
+        if (!file.IsOpen())
+            return false;
+
+        Header header;
+        if (file.GetSize() < sizeof(header))
+            return false;
+        memcpy(&header, file.GetData(), sizeof(header));
+
+        auto format = static_cast<PixelFormat>(header.format);
+        if (header.magic != CookMagic || header.version != CookVersion || header.key != key || format == PixelFormat::RGBA8 ||
+            format == PixelFormat::RGB16F || header.format > static_cast<uint32_t>(PixelFormat::BC6H) || header.width <= 0 ||
+            header.height <= 0 || header.levelCount == 0 || header.levelCount > MaxLevels) {
+            spdlog::warn("Ignoring stale texture cache entry {}", GetPath(key));
+            return false;
+        }
+
+        // The level index has to match the layout Allocate() gives, so the data block can be copied as is
+        TextureImage loaded;
+        loaded.Allocate(header.width, header.height, format);
+        loaded.channels = header.channels;
+        if (loaded.levels.size() != header.levelCount || loaded.GetSize() != header.dataSize)
+            return false;
+        auto size = file.GetSize();
+        if (header.levelsOffset > size || header.levelCount > (size - header.levelsOffset) / sizeof(LevelRecord))
+            return false;
+        if (header.dataOffset > file.GetSize() || header.dataSize > file.GetSize() - header.dataOffset)
+            return false;
+
+        for (uint32_t i = 0; i < header.levelCount; ++i) {
+            LevelRecord record;
+            memcpy(&record, file.GetData() + header.levelsOffset + i * sizeof(LevelRecord), sizeof(record));
+
+            auto& level = loaded.levels[i];
+            if (record.width != level.width || record.height != level.height || record.offset != level.offset ||
+                record.size != level.size)
+                return false;
+        }
+
+        memcpy(loaded.pixels.data(), file.GetData() + header.dataOffset, header.dataSize);
+        image = std::move(loaded);
+        return true;
+    }
+
+    void TextureCook::Store(uint64_t key, const TextureImage& image)
+    {
+        if (key == 0 || image.levels.empty() || image.format == PixelFormat::RGBA8 || image.format == PixelFormat::RGB16F)
+            return;
+
+        std::vector<LevelRecord> records;
+        for (auto& level : image.levels)
+            records.push_back({level.width, level.height, level.offset, level.size});
+
+        Header header;
+        header.key          = key;
+        header.format       = static_cast<uint32_t>(image.format);
+        header.width        = image.width;
+        header.height       = image.height;
+        header.channels     = image.channels;
+        header.levelCount   = static_cast<uint32_t>(records.size());
+        header.levelsOffset = sizeof(Header);
+        header.dataOffset   = sizeof(Header) + records.size() * sizeof(LevelRecord);
+        header.dataSize     = image.GetSize();
+
+        // Written under a temporary name first, so an interrupted write never leaves a truncated entry behind. Models
+        // importing on different threads may cook the same image, each writes its own temporary.
+        std::error_code error;
+        std::filesystem::create_directories(s_Directory, error);
+
+        auto path      = GetPath(key);
+        auto temporary = fmt::format("{}.{}.tmp", path, std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(LevelRecord));
+            out.write(reinterpret_cast<const char*>(image.pixels.data()), image.GetSize());
+            if (!out) {
+                spdlog::warn("Failed to write texture cache entry {}", path);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+            spdlog::warn("Failed to write texture cache entry {}: {}", path, error.message());
+        else
+            spdlog::debug("Stored texture cache entry {} ({} bytes)", path, header.dataOffset + header.dataSize);
+    }
+
+}  // namespace suplex
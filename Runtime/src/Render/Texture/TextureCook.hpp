@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Render/Texture/TextureImage.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace suplex {
+
+    // Block compressed textures, cooked once and cached on disk next to the mesh cache. Color and data maps become BC1
+    // (BC3 if they have alpha), normal maps BC5 (red/green only, z is left to the shader) and HDR images BC6H. An entry
+    // holds the whole mip chain as uploaded and is named by a hash of the source image and its usage, so editing the
+    // source simply misses. Safe on any thread, no GL calls.
+    class TextureCook {
+    public:
+        static void SetDirectory(const std::string& directory) { s_Directory = directory; }
+
+        // Loads the cooked entry or decodes, compresses and stores the image. Empty if the source cannot be decoded.
+        static TextureImage Cook(const std::string& path, TextureUsage usage);
+        static TextureImage Cook(const uint8_t* encoded, size_t size, TextureUsage usage);
+
+        static uint64_t    GetKey(const uint8_t* source, size_t size, TextureUsage usage);
+        static std::string GetPath(uint64_t key);
+
+        // false on a miss or an unusable entry.
+        static bool Load(uint64_t key, TextureImage& image);
+        static void Store(uint64_t key, const TextureImage& image);
+
+    private:
+        static std::string s_Directory;
+    };
+
+}  // namespace suplex
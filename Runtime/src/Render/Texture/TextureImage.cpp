@@ -0,0 +1,278 @@
+#include "Render/Texture/TextureImage.hpp"
+#include "Thread/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SUPLEX_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SUPLEX_SSE2 0
+#endif
+
+namespace suplex {
+
+    namespace {
+        // About this many texels per ParallelFor chunk
+        constexpr size_t TexelsPerTask = 16 * 1024;
+
+        struct SRGBTables
+        {
+            float   toLinear[256];
+            uint8_t toSRGB[4096];  // indexed by linear * 4095
+
+            SRGBTables()
+            {
+                for (int i = 0; i < 256; ++i) {
+                    float c     = i / 255.0f;
+                    toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (int i = 0; i < 4096; ++i) {
+                    float l   = i / 4095.0f;
+                    float c   = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                    toSRGB[i] = static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+                }
+            }
+        };
+
+        const SRGBTables& GetSRGBTables()
+        {
+            static SRGBTables tables;
+            return tables;
+        }
+
+        struct DownsampleRows
+        {
+            const uint8_t* src;
+            uint8_t*       dst;
+            TextureLevel   srcLevel, dstLevel;
+
+            // Clamped, so 1 texel wide or high levels sample their only column/row twice
+            const uint8_t* SourceRow(int y) const
+            {
+                return src + static_cast<size_t>(std::min(y, srcLevel.height - 1)) * srcLevel.width * 4;
+            }
+            int SourceColumn(int x) const { return std::min(x, srcLevel.width - 1) * 4; }
+        };
+
+        void DownsampleLinear(const DownsampleRows& rows, int yBegin, int yEnd)
+        {
+            int dstWidth = rows.dstLevel.width;
+            for (int y = yBegin; y < yEnd; ++y) {
+                auto row0 = rows.SourceRow(2 * y), row1 = rows.SourceRow(2 * y + 1);
+                auto out  = rows.dst + static_cast<size_t>(y) * dstWidth * 4;
+
+                int x = 0;
+#if SUPLEX_SSE2
+                // Two output texels from four source texels of both rows, summed in 16 bit lanes
+                auto zero  = _mm_setzero_si128();
+                auto round = _mm_set1_epi16(2);
+                for (; x + 2 <= dstWidth && 2 * x + 4 <= rows.srcLevel.width; x += 2) {
+                    auto a   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                    auto b   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                    auto lo  = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));  // texels 0, 1
+                    auto hi  = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));  // texels 2, 3
+                    auto sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    sum      = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero));
+                }
+#endif
+                for (; x < dstWidth; ++x) {
+                    int x0 = rows.SourceColumn(2 * x), x1 = rows.SourceColumn(2 * x + 1);
+                    for (int c = 0; c < 4; ++c) {
+                        int sum        = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                        out[x * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                    }
+                }
+            }
+        }
+
+        void DownsampleSRGB(const DownsampleRows& rows, int yBegin, int yEnd)
+        {
+            auto& tables   = GetSRGBTables();
+            int   dstWidth = rows.dstLevel.width;
+            for (int y = yBegin; y < yEnd; ++y) {
+                auto row0 = rows.SourceRow(2 * y), row1 = rows.SourceRow(2 * y + 1);
+                auto out  = rows.dst + static_cast<size_t>(y) * dstWidth * 4;
+
+                for (int x = 0; x < dstWidth; ++x) {
+                    const uint8_t* texels[4] = {row0 + rows.SourceColumn(2 * x), row0 + rows.SourceColumn(2 * x + 1),
+                                                row1 + rows.SourceColumn(2 * x), row1 + rows.SourceColumn(2 * x + 1)};
+#if SUPLEX_SSE2
+                    auto sum = _mm_setzero_ps();
+                    auto& toLinear = tables.toLinear;
+                    for (auto texel : texels) {
+                        auto linear = _mm_setr_ps(toLinear[texel[0]], toLinear[texel[1]], toLinear[texel[2]], texel[3] / 255.0f);
+                        sum         = _mm_add_ps(sum, linear);
+                    }
+
+                    // Color back through the 4095 entry table, alpha straight to 0..255
+                    alignas(16) int32_t index[4];
+                    auto scale = _mm_setr_ps(4095.0f * 0.25f, 4095.0f * 0.25f, 4095.0f * 0.25f, 255.0f * 0.25f);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_cvtps_epi32(_mm_mul_ps(sum, scale)));
+#else
+                    float sum[4] = {};
+                    for (auto texel : texels) {
+                        for (int c = 0; c < 3; ++c)
+                            sum[c] += tables.toLinear[texel[c]];
+                        sum[3] += texel[3] / 255.0f;
+                    }
+
+                    int32_t index[4];
+                    for (int c = 0; c < 4; ++c)
+                        index[c] = static_cast<int32_t>(std::lround(sum[c] * (c < 3 ? 4095.0f : 255.0f) * 0.25f));
+#endif
+                    for (int c = 0; c < 3; ++c)
+                        out[x * 4 + c] = tables.toSRGB[std::clamp(index[c], 0, 4095)];
+                    out[x * 4 + 3] = static_cast<uint8_t>(std::clamp(index[3], 0, 255));
+                }
+            }
+        }
+
+        void DownsampleHalf(const DownsampleRows& rows, int yBegin, int yEnd)
+        {
+            auto src      = reinterpret_cast<const uint16_t*>(rows.src);
+            auto dst      = reinterpret_cast<uint16_t*>(rows.dst);
+            int  srcWidth = rows.srcLevel.width, dstWidth = rows.dstLevel.width;
+            for (int y = yBegin; y < yEnd; ++y) {
+                auto row0 = src + static_cast<size_t>(std::min(2 * y, rows.srcLevel.height - 1)) * srcWidth * 3;
+                auto row1 = src + static_cast<size_t>(std::min(2 * y + 1, rows.srcLevel.height - 1)) * srcWidth * 3;
+                auto out  = dst + static_cast<size_t>(y) * dstWidth * 3;
+
+                for (int x = 0; x < dstWidth; ++x) {
+                    int x0 = std::min(2 * x, srcWidth - 1) * 3, x1 = std::min(2 * x + 1, srcWidth - 1) * 3;
+                    for (int c = 0; c < 3; ++c) {
+                        float sum = HalfToFloat(row0[x0 + c]) + HalfToFloat(row0[x1 + c]) + HalfToFloat(row1[x0 + c]) +
+                                    HalfToFloat(row1[x1 + c]);
+                        out[x * 3 + c] = FloatToHalf(sum * 0.25f);
+                    }
+                }
+            }
+        }
+    }  // namespace
+
+    // After F. Giesen's float_to_half_fast3_rtne
+    uint16_t FloatToHalf(float value)
+    {
+        constexpr uint32_t infinity       = 255u << 23;
+        constexpr uint32_t halfMax        = (127u + 16u) << 23;
+        constexpr uint32_t denormalMagic  = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        constexpr uint32_t smallestNormal = 113u << 23;
+
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t half;
+        if (bits >= halfMax) {
+            half = bits > infinity ? 0x7e00 : 0x7c00;
+        }
+        else if (bits < smallestNormal) {
+            // Let the FPU round the denormal by adding a magic number
+            float magic, shifted;
+            memcpy(&magic, &denormalMagic, sizeof(magic));
+            memcpy(&shifted, &bits, sizeof(shifted));
+            shifted += magic;
+            memcpy(&bits, &shifted, sizeof(bits));
+            half = static_cast<uint16_t>(bits - denormalMagic);
+        }
+        else {
+            uint32_t mantissaOdd = (bits >> 13) & 1;
+            bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff;
+            bits += mantissaOdd;
+            half = static_cast<uint16_t>(bits >> 13);
+        }
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    // After F. Giesen's half_to_float
+    float HalfToFloat(uint16_t value)
+    {
+        constexpr uint32_t shiftedExponent = 0x7c00u << 13;
+        constexpr uint32_t denormalMagic   = 113u << 23;
+
+        uint32_t bits     = (value & 0x7fffu) << 13;
+        uint32_t exponent = bits & shiftedExponent;
+        bits += (127u - 15u) << 23;
+
+        if (exponent == shiftedExponent) {
+            bits += (128u - 16u) << 23;  // infinity and NaN
+        }
+        else if (exponent == 0) {
+            // Renormalize by letting the FPU subtract the magic number
+            float magic, result;
+            bits += 1u << 23;
+            memcpy(&magic, &denormalMagic, sizeof(magic));
+            memcpy(&result, &bits, sizeof(result));
+            result -= magic;
+            memcpy(&bits, &result, sizeof(bits));
+        }
+        bits |= static_cast<uint32_t>(value & 0x8000u) << 16;
+
+        float result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    size_t GetLevelSize(PixelFormat format, int width, int height)
+    {
+        size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+        switch (format) {
+            case PixelFormat::BC1: return blocks * 8;
+            case PixelFormat::BC3:
+            case PixelFormat::BC5:
+            case PixelFormat::BC6H: return blocks * 16;
+            case PixelFormat::RGB16F: return static_cast<size_t>(width) * height * 6;
+            default: return static_cast<size_t>(width) * height * 4;
+        }
+    }
+
+    void TextureImage::Allocate(int w, int h, PixelFormat pixelFormat)
+    {
+        width  = w;
+        height = h;
+        format = pixelFormat;
+        levels.clear();
+
+        size_t size = 0;
+        for (;;) {
+            levels.push_back({w, h, size, GetLevelSize(format, w, h)});
+            size += levels.back().size;
+            if (w == 1 && h == 1)
+                break;
+            w = std::max(w / 2, 1);
+            h = std::max(h / 2, 1);
+        }
+        pixels.resize(size);
+    }
+
+    void GenerateMips(TextureImage& image, ColorSpace colorSpace)
+    {
+        for (size_t level = 1; level < image.levels.size(); ++level) {
+            DownsampleRows rows{image.GetLevel(level - 1), image.GetLevel(level), image.levels[level - 1], image.levels[level]};
+
+            auto grain = std::max<size_t>(TexelsPerTask / rows.dstLevel.width, 1);
+            ThreadPool::ParallelFor(rows.dstLevel.height, grain, [&](size_t begin, size_t end) {
+                if (image.format == PixelFormat::RGB16F)
+                    DownsampleHalf(rows, static_cast<int>(begin), static_cast<int>(end));
+                else if (colorSpace == ColorSpace::sRGB)
+                    DownsampleSRGB(rows, static_cast<int>(begin), static_cast<int>(end));
+                else
+                    DownsampleLinear(rows, static_cast<int>(begin), static_cast<int>(end));
+            });
+        }
+    }
+
+    std::vector<uint16_t> ConvertToHalf(const float* values, size_t count)
+    {
+        std::vector<uint16_t> halves(count);
+        ThreadPool::ParallelFor(count, TexelsPerTask * 4, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                halves[i] = FloatToHalf(values[i]);
+        });
+        return halves;
+    }
+
+}  // namespace suplex
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // How mips are filtered: sRGB encoded color is averaged in linear space, other data (normals, masks) as stored.
+    enum class ColorSpace { Linear, sRGB };
+
+    // What a texture holds, picks its color space and compressed format (see TextureCook). HDR is linear radiance, e.g.
+    // an environment map.
+    enum class TextureUsage { Color, Data, Normal, HDR };
+
+    inline ColorSpace GetColorSpace(TextureUsage usage)
+    {
+        return usage == TextureUsage::Color ? ColorSpace::sRGB : ColorSpace::Linear;
+    }
+
+    // RGBA8 is 4 bytes per texel and RGB16F 6 (half floats, for HDR images). The block compressed formats store 4x4 texel
+    // blocks of 8 (BC1) or 16 bytes (BC3, BC5, BC6H).
+    enum class PixelFormat { RGBA8, BC1, BC3, BC5, RGB16F, BC6H };
+
+    struct TextureLevel
+    {
+        int    width  = 0;
+        int    height = 0;
+        size_t offset = 0;  // into TextureImage::pixels
+        size_t size   = 0;
+    };
+
+    // Pixels with their full mip chain, decoded off the render thread, see Texture2D::Decode and Texture2D::Upload.
+    struct TextureImage
+    {
+        int                       width = 0, height = 0;
+        int                       channels = 0;  // of the source image
+        PixelFormat               format   = PixelFormat::RGBA8;
+        std::vector<TextureLevel> levels;
+        std::vector<uint8_t>      pixels;
+
+        // Lays out the mip chain of a w x h image down to 1x1, level 0 is left for the caller to fill.
+        void Allocate(int w, int h, PixelFormat pixelFormat = PixelFormat::RGBA8);
+
+        uint8_t* GetLevel(size_t level) { return pixels.data() + levels[level].offset; }
+        size_t   GetSize() const { return pixels.size(); }
+    };
+
+    size_t GetLevelSize(PixelFormat format, int width, int height);
+
+    // Fills levels 1.. of an RGBA8 or RGB16F image from level 0 with a 2x2 box filter (SSE2 for RGBA8 where available),
+    // the rows of each level are split over the ThreadPool. Odd sizes round down like glGenerateMipmap. Half floats are
+    // averaged as floats, colorSpace only applies to RGBA8.
+    void GenerateMips(TextureImage& image, ColorSpace colorSpace);
+
+    // Float to half float with round to nearest even, overflow becomes infinity and NaN stays NaN.
+    uint16_t FloatToHalf(float value);
+
+    // Exact, denormals included.
+    float HalfToFloat(uint16_t value);
+
+    // FloatToHalf over an array, for HDR uploads. Split over the ThreadPool.
+    std::vector<uint16_t> ConvertToHalf(const float* values, size_t count);
+
+}  // namespace suplex
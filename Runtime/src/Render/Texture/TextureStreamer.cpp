@@ -0,0 +1,216 @@
+#include "Render/Texture/TextureStreamer.hpp"
+#include "Render/Buffer/PixelUnpackBuffer.hpp"
+#include "Render/Geometry/Model.hpp"
+#include "Render/RHI.hpp"
+#include "Render/Texture/Texture2D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <vector>
+
+namespace suplex {
+
+    std::unordered_map<uint32_t, TextureStreamer::Entry> TextureStreamer::s_Entries;
+    uint64_t                                              TextureStreamer::s_Frame = 1;
+    TextureStreamingStats                                 TextureStreamer::s_Stats;
+
+    void TextureStreamer::Register(uint32_t textureID, TextureImage&& image)
+    {
+        if (textureID == 0 || image.levels.empty())
+            return;
+
+        auto& entry          = s_Entries[textureID];
+        entry.image          = std::move(image);
+        entry.internalFormat = Texture2D::GetInternalFormat(entry.image.format, TextureFormat::RGB);
+
+        auto& levels    = entry.image.levels;
+        int   lastLevel = static_cast<int>(levels.size()) - 1;
+
+        entry.coarseLevel = lastLevel;
+        for (; entry.coarseLevel > 0; --entry.coarseLevel) {
+            auto& finer = levels[entry.coarseLevel - 1];
+            if (std::max(finer.width, finer.height) > CoarseSize)
+                break;
+        }
+
+        RHI::BindTexture(GL_TEXTURE_2D, textureID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.coarseLevel);
+        for (int level = lastLevel; level >= entry.coarseLevel; --level)
+            UploadLevel(entry, level);
+
+        entry.residentLevel  = entry.coarseLevel;
+        entry.wantedLevel    = entry.coarseLevel;
+        entry.requestedLevel = entry.coarseLevel;
+        ++s_Stats.streamedTextures;
+    }
+
+    void TextureStreamer::Unregister(uint32_t textureID)
+    {
+        auto entry = s_Entries.find(textureID);
+        if (entry == s_Entries.end())
+            return;
+
+        s_Stats.residentBytes -= GetBytes(entry->second, entry->second.residentLevel);
+        --s_Stats.streamedTextures;
+        s_Entries.erase(entry);
+    }
+
+    void TextureStreamer::Request(uint32_t textureID, float screenSize)
+    {
+        auto found = s_Entries.find(textureID);
+        if (found == s_Entries.end())
+            return;
+
+        auto& entry = found->second;
+        auto& base  = entry.image.levels[0];
+        float ratio = static_cast<float>(std::max(base.width, base.height)) / std::max(screenSize, 1.0f);
+        int   level = std::min(static_cast<int>(std::floor(std::log2(std::max(ratio, 1.0f)))), entry.coarseLevel);
+
+        if (entry.lastRequest != s_Frame) {
+            entry.lastRequest    = s_Frame;
+            entry.requestedLevel = level;
+        }
+        else {
+            entry.requestedLevel = std::min(entry.requestedLevel, level);
+        }
+    }
+
+    void TextureStreamer::Request(Model& model, float screenSize)
+    {
+        for (auto& mesh : model.GetMeshes()) {
+            for (auto& texture : mesh.GetTextures())
+                Request(texture.GetID(), screenSize);
+        }
+    }
+
+    void TextureStreamer::Update(size_t budget, size_t uploadBudget)
+    {
+        s_Stats.budget          = budget;
+        s_Stats.trimmedTextures = 0;
+
+        // Textures seen last frame want their requested level, the others keep what they have while it fits
+        size_t                                     wantedBytes = 0;
+        std::vector<std::pair<uint64_t, uint32_t>> idle;
+        for (auto& [id, entry] : s_Entries) {
+            bool seen         = entry.lastRequest == s_Frame;
+            entry.wantedLevel = seen ? entry.requestedLevel : entry.residentLevel;
+            wantedBytes += GetBytes(entry, entry.wantedLevel);
+            if (!seen && entry.wantedLevel < entry.coarseLevel)
+                idle.emplace_back(entry.lastRequest, id);
+        }
+        s_Stats.wantedBytes = wantedBytes;
+
+        // Over budget, idle textures give up their fine levels first, least recently seen first
+        std::sort(idle.begin(), idle.end());
+        for (auto [frame, id] : idle) {
+            auto& entry = s_Entries.at(id);
+            while (wantedBytes > budget && entry.wantedLevel < entry.coarseLevel)
+                wantedBytes -= entry.image.levels[entry.wantedLevel++].size;
+        }
+
+        // Then the visible ones, always dropping the largest wanted level
+        if (wantedBytes > budget) {
+            std::priority_queue<std::pair<size_t, uint32_t>> largest;
+            for (auto& [id, entry] : s_Entries) {
+                if (entry.wantedLevel < entry.coarseLevel)
+                    largest.emplace(entry.image.levels[entry.wantedLevel].size, id);
+            }
+            while (wantedBytes > budget && !largest.empty()) {
+                auto  id    = largest.top().second;
+                auto& entry = s_Entries.at(id);
+                largest.pop();
+
+                wantedBytes -= entry.image.levels[entry.wantedLevel++].size;
+                if (entry.wantedLevel < entry.coarseLevel)
+                    largest.emplace(entry.image.levels[entry.wantedLevel].size, id);
+            }
+        }
+
+        // Evictions are applied at once, they only free memory
+        std::vector<uint32_t> loading;
+        for (auto& [id, entry] : s_Entries) {
+            if (entry.lastRequest == s_Frame && entry.wantedLevel > entry.requestedLevel)
+                ++s_Stats.trimmedTextures;
+
+            if (entry.residentLevel < entry.wantedLevel) {
+                RHI::BindTexture(GL_TEXTURE_2D, id);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.wantedLevel);
+                for (int level = entry.residentLevel; level < entry.wantedLevel; ++level)
+                    EvictLevel(entry, level);
+                entry.residentLevel = entry.wantedLevel;
+            }
+            else if (entry.residentLevel > entry.wantedLevel) {
+                loading.push_back(id);
+            }
+        }
+
+        // One level per texture and round, so every texture sharpens coarse to fine at the same pace
+        while (!loading.empty() && uploadBudget > 0) {
+            size_t kept = 0;
+            for (auto id : loading) {
+                if (uploadBudget == 0)
+                    break;
+
+                auto& entry = s_Entries.at(id);
+                int   level = entry.residentLevel - 1;
+                RHI::BindTexture(GL_TEXTURE_2D, id);
+                UploadLevel(entry, level);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+                entry.residentLevel = level;
+
+                uploadBudget -= std::min(uploadBudget, entry.image.levels[level].size);
+                if (entry.residentLevel > entry.wantedLevel)
+                    loading[kept++] = id;
+            }
+            loading.resize(kept);
+        }
+
+        ++s_Frame;
+    }
+
+    // Expects the texture to be bound
+    void TextureStreamer::UploadLevel(Entry& entry, int level)
+    {
+        auto&       image  = entry.image;
+        auto&       record = image.levels[level];
+        const void* pixels = image.pixels.data() + record.offset;
+
+        bool staged = PixelUnpackBuffer::Stage(pixels, record.size);
+        if (staged)
+            pixels = nullptr;
+
+        if (image.format == PixelFormat::RGBA8)
+            glTexImage2D(GL_TEXTURE_2D, level, entry.internalFormat, record.width, record.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pixels);
+        else
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, entry.internalFormat, record.width, record.height, 0,
+                                   static_cast<GLsizei>(record.size), pixels);
+        if (staged)
+            PixelUnpackBuffer::Unbind();
+
+        s_Stats.residentBytes += record.size;
+        ++s_Stats.levelsLoaded;
+    }
+
+    // Redefines the level as empty, which frees its storage. Expects the texture to be bound.
+    void TextureStreamer::EvictLevel(Entry& entry, int level)
+    {
+        if (entry.image.format == PixelFormat::RGBA8)
+            glTexImage2D(GL_TEXTURE_2D, level, entry.internalFormat, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        else
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, entry.internalFormat, 0, 0, 0, 0, nullptr);
+
+        s_Stats.residentBytes -= entry.image.levels[level].size;
+        ++s_Stats.levelsEvicted;
+    }
+
+    size_t TextureStreamer::GetBytes(const Entry& entry, int firstLevel)
+    {
+        size_t bytes = 0;
+        for (size_t level = firstLevel; level < entry.image.levels.size(); ++level)
+            bytes += entry.image.levels[level].size;
+        return bytes;
+    }
+
+}  // namespace suplex
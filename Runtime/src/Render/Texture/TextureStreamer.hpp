@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Render/Texture/TextureImage.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+
+namespace suplex {
+
+    class Model;
+
+    struct TextureStreamingStats
+    {
+        uint32_t streamedTextures = 0;
+        uint32_t trimmedTextures  = 0;  // kept coarser than their footprint asks for, last Update
+        size_t   residentBytes    = 0;  // levels in video memory
+        size_t   wantedBytes      = 0;  // what the footprints of the last frame asked for
+        size_t   budget           = 0;
+        uint32_t levelsLoaded     = 0;
+        uint32_t levelsEvicted    = 0;
+    };
+
+    // Keeps only the mips of model textures their on-screen footprint needs. The decoded image stays in system memory,
+    // levels up to CoarseSize are always resident and finer ones are uploaded coarse to fine (a few MB per frame) or
+    // dropped again when the budget runs out, idle textures first. Sampling is clamped with GL_TEXTURE_BASE_LEVEL, so
+    // streamed textures use mutable per-level storage instead of glTexStorage2D. GL thread only.
+    class TextureStreamer {
+    public:
+        static constexpr int    CoarseSize          = 64;
+        static constexpr size_t DefaultUploadBudget = 4 << 20;
+
+        // Takes over a texture created by Texture2D::Stream and uploads its coarse levels.
+        static void Register(uint32_t textureID, TextureImage&& image);
+        static void Unregister(uint32_t textureID);
+
+        // screenSize is the on-screen extent in pixels the textures are drawn across, the finest level needed is the
+        // one with about as many texels. Assumes the UVs span each texture once over the model.
+        static void Request(uint32_t textureID, float screenSize);
+        static void Request(Model& model, float screenSize);
+
+        // Once per frame before any pass: applies the requests of the previous frame within budget bytes of streamed
+        // levels, uploading at most uploadBudget bytes.
+        static void Update(size_t budget, size_t uploadBudget = DefaultUploadBudget);
+
+        static const TextureStreamingStats& GetStats() { return s_Stats; }
+
+    private:
+        struct Entry
+        {
+            TextureImage image;
+            uint32_t     internalFormat = 0;
+            int          coarseLevel    = 0;  // finest level that is always resident
+            int          residentLevel  = 0;  // finest level in video memory, the base level
+            int          wantedLevel    = 0;
+            int          requestedLevel = 0;
+            uint64_t     lastRequest    = 0;  // frame of the last Request
+        };
+
+        static void   UploadLevel(Entry& entry, int level);
+        static void   EvictLevel(Entry& entry, int level);
+        static size_t GetBytes(const Entry& entry, int firstLevel);
+
+    private:
+        static std::unordered_map<uint32_t, Entry> s_Entries;
+        static uint64_t                            s_Frame;
+        static TextureStreamingStats               s_Stats;
+    };
+
+}  // namespace suplex
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "Animation/Animation/Animation.hpp"
+#include "Render/Geometry/Bounds.hpp"
 #include "Render/Geometry/Mesh.hpp"
 #include "Render/Geometry/Model.hpp"
+#include <cmath>
+#include <entt/entity/entity.hpp>
+#include <future>
 #include <glm/glm.hpp>
 #include <glm/fwd.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
@@ -10,6 +15,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/trigonometric.hpp>
 #include <memory>
+#include <utility>
 #include <Render/Material/Material.hpp>
 #include <UUID.hpp>
 
@@ -31,16 +37,30 @@ namespace suplex {
         TagComponent(std::string const& tag) : m_Tag(tag) {}
     };
 
+    // translate * rotate * scale, rotation in degrees. The rotation matrix is written straight from the Euler angles
+    // (Rz * Ry * Rx, the same as glm::toMat4(glm::quat(glm::radians(rotation)))) to skip the quaternion round trip.
+    inline glm::mat4 ComposeTransform(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+    {
+        auto  radians = glm::radians(rotation);
+        float cx = std::cos(radians.x), sx = std::sin(radians.x);
+        float cy = std::cos(radians.y), sy = std::sin(radians.y);
+        float cz = std::cos(radians.z), sz = std::sin(radians.z);
+
+        glm::mat4 transform;
+        transform[0] = glm::vec4(cy * cz, cy * sz, -sy, 0.0f) * scale.x;
+        transform[1] = glm::vec4(sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy, 0.0f) * scale.y;
+        transform[2] = glm::vec4(cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy, 0.0f) * scale.z;
+        transform[3] = glm::vec4(translation, 1.0f);
+        return transform;
+    }
+
+    // Local to the parent (see RelationshipComponent), world space for roots.
     struct TransformComponent
     {
-        auto GetTransform()
-        {
-            auto translate = glm::translate(glm::mat4(1.0f), m_Translation);
-            auto rotation  = glm::toMat4(glm::quat(glm::radians(m_Rotation)));
-            auto scale     = glm::scale(glm::mat4(1.0f), m_Scale);
-            return translate * rotation * scale;
-        }
+        // Rebuilds the matrix, renderers read the cached WorldTransformComponent instead.
+        glm::mat4 GetTransform() const { return ComposeTransform(m_Translation, m_Rotation, m_Scale); }
 
+        // Callers go through Entity::MarkTransformDirty afterwards, as after any other write to the members.
         void SetTransform(const glm::mat4& transform)
         {
             auto quaternion = glm::quat();
@@ -62,13 +82,69 @@ namespace suplex {
         glm::vec4 m_Perspective{0.0f};
     };
 
+    // Parent/child links as an intrusive list of siblings, only modified through Scene::SetParent.
+    struct RelationshipComponent
+    {
+        entt::entity m_Parent      = entt::null;
+        entt::entity m_FirstChild  = entt::null;
+        entt::entity m_PrevSibling = entt::null;
+        entt::entity m_NextSibling = entt::null;
+        uint32_t     m_ChildCount  = 0;
+    };
+
+    // Parent world * TransformComponent::GetTransform(), refreshed by Scene::UpdateTransforms for tagged entities and their subtrees.
+    struct WorldTransformComponent
+    {
+        glm::mat4 m_Matrix{1.0f};
+    };
+
+    // Tag, see Entity::MarkTransformDirty.
+    struct TransformDirtyComponent
+    {
+    };
+
     struct MeshRendererComponent
     {
-        std::shared_ptr<Model> m_Model = std::make_shared<Model>();
+        // Shared with every entity using the same file, see AssetManager
+        std::shared_ptr<Model> m_Model         = std::make_shared<Model>();
+        uint32_t               m_MaterialIndex = 0;
+        uint32_t               m_Lod           = 0;  // picked by the camera passes each frame, see SelectLod
 
         MeshRendererComponent() = default;
-        // MeshRendererComponent(const std::shared_ptr<Model> model) : m_Model(model) {}
-        MeshRendererComponent(const Model& model) { m_Model = std::make_shared<Model>(model); }
+        MeshRendererComponent(std::shared_ptr<Model> model, uint32_t materialIndex = 0)
+            : m_Model(std::move(model)), m_MaterialIndex(materialIndex)
+        {
+        }
+    };
+
+    // The MeshRendererComponent draws a placeholder until the model finishes loading, see Scene::UpdatePendingModels.
+    struct PendingModelComponent
+    {
+        std::shared_future<std::shared_ptr<Model>> m_Model;
+        std::string                                m_FilePath;
+    };
+
+    // Plays an Animation on the entity, advanced and evaluated by the Scene's AnimationSystem during play. The entity's final
+    // bone matrices are m_Animation->GetBoneCount() entries of AnimationSystem::GetPalette() from m_PaletteOffset, the
+    // passes hand the offset to the skinning shaders. The animation must come from the entity's model (its bone ids).
+    struct AnimatorComponent
+    {
+        std::shared_ptr<Animation> m_Animation;
+        float                      m_Time          = 0.0f;  // in ticks
+        float                      m_Speed         = 1.0f;
+        bool                       m_Playing       = true;
+        int32_t                    m_PaletteOffset = -1;    // assigned by the AnimationSystem, -1 draws the bind pose
+
+        AnimatorComponent() = default;
+        AnimatorComponent(std::shared_ptr<Animation> animation) : m_Animation(std::move(animation)) {}
+    };
+
+    // World space bounds of a MeshRendererComponent, refreshed by Scene::UpdateTransforms together with the world transform.
+    struct BoundsComponent
+    {
+        AABB           m_WorldBounds;
+        BoundingSphere m_WorldSphere;
+        int32_t        m_ProxyID = -1;  // leaf in Scene's spatial index
     };
 
     struct MaterialComponent
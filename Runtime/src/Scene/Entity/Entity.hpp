@@ -48,6 +48,12 @@ namespace suplex {
             m_Scene->m_Registry.remove<T>();
         }
 
+        // Call after writing to the TransformComponent, the cached world matrix and bounds follow on the next Scene::UpdateTransforms.
+        void MarkTransformDirty() { m_Scene->m_Registry.emplace_or_replace<TransformDirtyComponent>(m_EntityHandle); }
+
+        void   SetParent(Entity parent) { m_Scene->SetParent(*this, parent); }
+        Entity GetParent() { return m_Scene->GetParent(*this); }
+
         auto& GetID() { return m_EntityHandle; }
 
         operator bool() { return m_EntityHandle != entt::null; }
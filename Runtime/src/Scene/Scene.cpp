@@ -1,18 +1,36 @@
 #include "Scene/Component/Component.hpp"
 #include "Scene/Entity/Entity.hpp"
+#include "Thread/ThreadPool.hpp"
 #include "UUID.hpp"
+#include <algorithm>
+#include <chrono>
 #include <Scene/Scene.hpp>
 #include <entt/entity/entity.hpp>
+#include <spdlog/spdlog.h>
 #include <stdint.h>
 #include <vector>
 
 namespace suplex {
+    Scene::Scene()
+    {
+        m_Registry.on_construct<RelationshipComponent>().connect<&Scene::OnRelationshipConstructed>(*this);
+        m_Registry.on_destroy<RelationshipComponent>().connect<&Scene::OnRelationshipDestroyed>(*this);
+        m_Registry.on_construct<MeshRendererComponent>().connect<&Scene::OnMeshRendererConstructed>(*this);
+        m_Registry.on_destroy<MeshRendererComponent>().connect<&Scene::OnMeshRendererDestroyed>(*this);
+        m_Registry.on_destroy<BoundsComponent>().connect<&Scene::OnBoundsDestroyed>(*this);
+        m_Registry.on_construct<AnimatorComponent>().connect<&Scene::OnAnimatorChanged>(*this);
+        m_Registry.on_destroy<AnimatorComponent>().connect<&Scene::OnAnimatorChanged>(*this);
+    }
+
     Entity Scene::CreateEntity(std::string const& name)
     {
         Entity e(m_Registry.create(), this);
         e.AddComponent<IDComponent>();
         e.AddComponent<TagComponent>(name);
         e.AddComponent<TransformComponent>();
+        e.AddComponent<WorldTransformComponent>();
+        e.AddComponent<RelationshipComponent>();
+        e.MarkTransformDirty();
         return e;
     }
 
@@ -32,4 +50,297 @@ namespace suplex {
         return e.empty() ? Entity(entt::null, this) : Entity(*e.begin(), this);
     }
 
+    void Scene::SetParent(Entity child, Entity parent)
+    {
+        auto  childHandle  = child.GetID();
+        auto  parentHandle = parent ? parent.GetID() : entt::entity(entt::null);
+        auto& relationship = m_Registry.get<RelationshipComponent>(childHandle);
+        if (relationship.m_Parent == parentHandle)
+            return;
+
+        for (auto ancestor = parentHandle; ancestor != entt::null; ancestor = m_Registry.get<RelationshipComponent>(ancestor).m_Parent) {
+            if (ancestor == childHandle) {
+                spdlog::warn("Cannot parent an entity to one of its descendants");
+                return;
+            }
+        }
+
+        Unlink(childHandle);
+        if (parentHandle != entt::null) {
+            auto& parentRelationship   = m_Registry.get<RelationshipComponent>(parentHandle);
+            relationship.m_Parent      = parentHandle;
+            relationship.m_NextSibling = parentRelationship.m_FirstChild;
+            if (parentRelationship.m_FirstChild != entt::null)
+                m_Registry.get<RelationshipComponent>(parentRelationship.m_FirstChild).m_PrevSibling = childHandle;
+            parentRelationship.m_FirstChild = childHandle;
+            parentRelationship.m_ChildCount++;
+        }
+
+        m_Registry.emplace_or_replace<TransformDirtyComponent>(childHandle);
+        m_HierarchyChanged = true;
+    }
+
+    Entity Scene::GetParent(Entity child) { return Entity(m_Registry.get<RelationshipComponent>(child.GetID()).m_Parent, this); }
+
+    void Scene::UpdateTransforms()
+    {
+        if (m_HierarchyChanged)
+            RebuildHierarchy();
+
+        // Flag the tagged entities and collect the root subtrees they live in
+        m_DirtySubtrees.clear();
+        for (auto entity : m_Registry.view<TransformDirtyComponent>()) {
+            auto slot = static_cast<size_t>(entt::to_entity(entity));
+            if (slot >= m_HierarchyIndices.size() || m_HierarchyIndices[slot] == InvalidIndex)
+                continue;
+
+            auto index              = m_HierarchyIndices[slot];
+            m_HierarchyDirty[index] = 1;
+            m_DirtySubtrees.push_back(static_cast<uint32_t>(std::upper_bound(m_HierarchyRoots.begin(), m_HierarchyRoots.end(), index) -
+                                                            m_HierarchyRoots.begin() - 1));
+        }
+        std::sort(m_DirtySubtrees.begin(), m_DirtySubtrees.end());
+        m_DirtySubtrees.erase(std::unique(m_DirtySubtrees.begin(), m_DirtySubtrees.end()), m_DirtySubtrees.end());
+
+        // Group consecutive subtrees into tasks of roughly equal node count, most scenes are many small subtrees
+        constexpr uint32_t NodesPerTask = 512;
+        m_DirtyTasks.clear();
+        m_DirtyTasks.push_back(0);
+        for (uint32_t i = 0, nodes = 0; i < m_DirtySubtrees.size(); ++i) {
+            auto root = m_DirtySubtrees[i];
+            nodes += m_HierarchyRoots[root + 1] - m_HierarchyRoots[root];
+            if (nodes >= NodesPerTask || i + 1 == m_DirtySubtrees.size()) {
+                m_DirtyTasks.push_back(i + 1);
+                nodes = 0;
+            }
+        }
+
+        // Parents precede their children, so a single forward pass propagates both the dirty flag and the matrix.
+        // Subtrees only touch their own slots and components, the view is created up front so no pool is looked up concurrently.
+        auto view = m_Registry.view<TransformComponent, WorldTransformComponent>();
+        ThreadPool::ParallelFor(m_DirtyTasks.size() - 1, 1, [&](size_t begin, size_t end) {
+            for (auto i = m_DirtyTasks[begin]; i < m_DirtyTasks[end]; ++i) {
+                auto root = m_DirtySubtrees[i];
+                for (auto node = m_HierarchyRoots[root]; node < m_HierarchyRoots[root + 1]; ++node) {
+                    auto parent = m_HierarchyParents[node];
+                    if (parent >= 0)
+                        m_HierarchyDirty[node] |= m_HierarchyDirty[parent];
+                    if (!m_HierarchyDirty[node])
+                        continue;
+
+                    auto  entity = m_HierarchyOrder[node];
+                    auto  local  = view.get<TransformComponent>(entity).GetTransform();
+                    auto& world  = m_HierarchyWorld[node];
+                    world        = parent >= 0 ? m_HierarchyWorld[parent] * local : local;
+
+                    view.get<WorldTransformComponent>(entity).m_Matrix = world;
+                }
+            }
+        });
+
+        // The spatial index is not thread safe, bounds are refreshed afterwards on this thread. Flags are reset on the way,
+        // so clean subtrees are never touched.
+        for (auto root : m_DirtySubtrees) {
+            for (auto node = m_HierarchyRoots[root]; node < m_HierarchyRoots[root + 1]; ++node) {
+                if (!m_HierarchyDirty[node])
+                    continue;
+                m_HierarchyDirty[node] = 0;
+
+                auto entity       = m_HierarchyOrder[node];
+                auto meshRenderer = m_Registry.try_get<MeshRendererComponent>(entity);
+                if (!meshRenderer)
+                    continue;
+
+                auto& transform      = m_HierarchyWorld[node];
+                auto& bounds         = m_Registry.get_or_emplace<BoundsComponent>(entity);
+                bounds.m_WorldBounds = meshRenderer->m_Model->GetBounds().Transform(transform);
+                bounds.m_WorldSphere = meshRenderer->m_Model->GetBoundingSphere().Transform(transform);
+
+                if (bounds.m_ProxyID == DynamicAABBTree::Null)
+                    bounds.m_ProxyID = m_SpatialIndex.CreateProxy(bounds.m_WorldBounds, static_cast<uint32_t>(entity));
+                else
+                    m_SpatialIndex.MoveProxy(bounds.m_ProxyID, bounds.m_WorldBounds);
+            }
+        }
+
+        m_Registry.clear<TransformDirtyComponent>();
+    }
+
+    void Scene::InstantiateModel(Entity parent, const std::shared_ptr<Model>& model)
+    {
+        auto&               nodes = model->GetNodes();
+        std::vector<Entity> entities;
+        entities.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            auto entity = CreateEntity(nodes[i].name);
+            entity.GetComponent<TransformComponent>().SetTransform(nodes[i].transform);
+            if (nodes[i].meshCount > 0)
+                entity.AddComponent<MeshRendererComponent>(Model::GetNodeModel(model, i));
+            entities.push_back(entity);
+        }
+
+        // Siblings are prepended, linking backwards keeps the order of the file
+        for (size_t i = nodes.size(); i-- > 0;)
+            SetParent(entities[i], nodes[i].parent < 0 ? parent : entities[nodes[i].parent]);
+    }
+
+    void Scene::UpdatePendingModels()
+    {
+        std::vector<entt::entity> loaded;
+        auto                      view = m_Registry.view<PendingModelComponent, MeshRendererComponent>();
+        for (auto entity : view) {
+            auto& pending = view.get<PendingModelComponent>(entity).m_Model;
+            if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            // The bounds change with the model
+            view.get<MeshRendererComponent>(entity).m_Model = pending.get();
+            m_Registry.emplace_or_replace<TransformDirtyComponent>(entity);
+            loaded.push_back(entity);
+        }
+
+        // The nodes of the file become children of the entity, which keeps the placement and drops the placeholder.
+        // A failed import has no nodes and leaves the entity with the empty model.
+        for (auto entity : loaded) {
+            m_Registry.remove<PendingModelComponent>(entity);
+            auto model = m_Registry.get<MeshRendererComponent>(entity).m_Model;
+            if (model->GetNodes().empty())
+                continue;
+
+            m_Registry.remove<MeshRendererComponent>(entity);
+            InstantiateModel(Entity(entity, this), model);
+        }
+    }
+
+    void Scene::RebuildHierarchy()
+    {
+        m_HierarchyOrder.clear();
+        m_HierarchyParents.clear();
+        m_HierarchyRoots.clear();
+        std::fill(m_HierarchyIndices.begin(), m_HierarchyIndices.end(), InvalidIndex);
+
+        // Iterative pre-order walk from every root, which keeps each subtree contiguous
+        auto view = m_Registry.view<RelationshipComponent, TransformComponent>();
+        for (auto root : view) {
+            if (view.get<RelationshipComponent>(root).m_Parent != entt::null)
+                continue;
+
+            m_HierarchyRoots.push_back(static_cast<uint32_t>(m_HierarchyOrder.size()));
+            m_HierarchyStack.clear();
+            m_HierarchyStack.emplace_back(root, -1);
+            while (!m_HierarchyStack.empty()) {
+                auto [entity, parent] = m_HierarchyStack.back();
+                m_HierarchyStack.pop_back();
+
+                auto index = static_cast<int32_t>(m_HierarchyOrder.size());
+                auto slot  = static_cast<size_t>(entt::to_entity(entity));
+                if (slot >= m_HierarchyIndices.size())
+                    m_HierarchyIndices.resize(slot + 1, InvalidIndex);
+                m_HierarchyIndices[slot] = index;
+                m_HierarchyOrder.push_back(entity);
+                m_HierarchyParents.push_back(parent);
+
+                for (auto child = view.get<RelationshipComponent>(entity).m_FirstChild; child != entt::null;
+                     child      = view.get<RelationshipComponent>(child).m_NextSibling)
+                    m_HierarchyStack.emplace_back(child, index);
+            }
+        }
+        m_HierarchyRoots.push_back(static_cast<uint32_t>(m_HierarchyOrder.size()));
+
+        // Untouched nodes keep their last world matrix, parents of dirty subtrees are read from here
+        m_HierarchyWorld.resize(m_HierarchyOrder.size());
+        m_HierarchyDirty.assign(m_HierarchyOrder.size(), 0);
+        for (size_t i = 0; i < m_HierarchyOrder.size(); ++i)
+            m_HierarchyWorld[i] = m_Registry.get_or_emplace<WorldTransformComponent>(m_HierarchyOrder[i]).m_Matrix;
+
+        // Keep the transform pools in the same order, so the propagation pass walks them front to back
+        auto byHierarchy = [this](entt::entity a, entt::entity b) {
+            return m_HierarchyIndices[static_cast<size_t>(entt::to_entity(a))] < m_HierarchyIndices[static_cast<size_t>(entt::to_entity(b))];
+        };
+        m_Registry.sort<TransformComponent>(byHierarchy);
+        m_Registry.sort<WorldTransformComponent>(byHierarchy);
+
+        m_HierarchyChanged = false;
+    }
+
+    void Scene::Unlink(entt::entity entity)
+    {
+        auto& relationship = m_Registry.get<RelationshipComponent>(entity);
+        if (relationship.m_Parent == entt::null)
+            return;
+
+        auto& parentRelationship = m_Registry.get<RelationshipComponent>(relationship.m_Parent);
+        if (parentRelationship.m_FirstChild == entity)
+            parentRelationship.m_FirstChild = relationship.m_NextSibling;
+        if (relationship.m_PrevSibling != entt::null)
+            m_Registry.get<RelationshipComponent>(relationship.m_PrevSibling).m_NextSibling = relationship.m_NextSibling;
+        if (relationship.m_NextSibling != entt::null)
+            m_Registry.get<RelationshipComponent>(relationship.m_NextSibling).m_PrevSibling = relationship.m_PrevSibling;
+        parentRelationship.m_ChildCount--;
+
+        relationship.m_Parent      = entt::null;
+        relationship.m_PrevSibling = entt::null;
+        relationship.m_NextSibling = entt::null;
+    }
+
+    Entity Scene::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* hitDistance)
+    {
+        auto inverseDirection = 1.0f / direction;
+        auto nearest          = entt::entity(entt::null);
+
+        // Leaves are fattened, so hits are confirmed against the tight world bounds
+        m_SpatialIndex.QueryRay(origin, direction, maxDistance, [&](uint32_t userData, float) {
+            auto  entity   = static_cast<entt::entity>(userData);
+            auto& bounds   = m_Registry.get<BoundsComponent>(entity);
+            float distance = 0.0f;
+            if (DynamicAABBTree::IntersectRay(bounds.m_WorldBounds, origin, inverseDirection, maxDistance, distance)) {
+                nearest     = entity;
+                maxDistance = distance;
+            }
+            return maxDistance;
+        });
+
+        if (hitDistance && nearest != entt::null)
+            *hitDistance = maxDistance;
+        return Entity(nearest, this);
+    }
+
+    void Scene::OnRelationshipConstructed(entt::registry& registry, entt::entity entity) { m_HierarchyChanged = true; }
+
+    // Children of a destroyed entity become roots
+    void Scene::OnRelationshipDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        Unlink(entity);
+
+        auto& relationship = registry.get<RelationshipComponent>(entity);
+        for (auto child = relationship.m_FirstChild; child != entt::null;) {
+            auto& childRelationship         = registry.get<RelationshipComponent>(child);
+            auto  next                      = childRelationship.m_NextSibling;
+            childRelationship.m_Parent      = entt::null;
+            childRelationship.m_PrevSibling = entt::null;
+            childRelationship.m_NextSibling = entt::null;
+            registry.emplace_or_replace<TransformDirtyComponent>(child);
+            child = next;
+        }
+        m_HierarchyChanged = true;
+    }
+
+    // The model is usually loaded right after the component is added, so the bounds are picked up on the next update
+    void Scene::OnMeshRendererConstructed(entt::registry& registry, entt::entity entity)
+    {
+        registry.emplace_or_replace<TransformDirtyComponent>(entity);
+    }
+
+    void Scene::OnMeshRendererDestroyed(entt::registry& registry, entt::entity entity) { registry.remove<BoundsComponent>(entity); }
+
+    void Scene::OnBoundsDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        auto& bounds = registry.get<BoundsComponent>(entity);
+        if (bounds.m_ProxyID != DynamicAABBTree::Null)
+            m_SpatialIndex.DestroyProxy(bounds.m_ProxyID);
+    }
+
+    // Palette offsets are reassigned on the next UpdateAnimations
+    void Scene::OnAnimatorChanged(entt::registry& registry, entt::entity entity) { m_AnimationSystem.Invalidate(); }
+
 }  // namespace suplex
\ No newline at end of file
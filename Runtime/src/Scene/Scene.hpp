@@ -1,10 +1,15 @@
 #pragma once
 
+#include "Animation/AnimationSystem/AnimationSystem.hpp"
 #include "Scene/Component/Component.hpp"
+#include "Scene/Spatial/DynamicAABBTree.hpp"
 #include "entt/entt.hpp"
+#include <cfloat>
 #include <glm/fwd.hpp>
+#include <glm/glm.hpp>
 #include <iterator>
 #include <memory>
+#include <utility>
 #include <stdint.h>
 #include <vector>
 
@@ -13,7 +18,7 @@ namespace suplex {
 
     class Scene {
     public:
-        Scene() = default;
+        Scene();
         ~Scene() {}
 
         Entity CreateEntity(std::string const& name = "");
@@ -35,11 +40,70 @@ namespace suplex {
 
         Entity GetActiveEntity();
 
+        // Moves child under parent, a null parent makes it a root. The local transform is kept, so the child follows its new
+        // parent from the next update on. Refuses to create cycles.
+        void   SetParent(Entity child, Entity parent);
+        Entity GetParent(Entity child);
+
+        // Creates one entity per node of an uploaded model under parent, linked like the nodes of the file. Each takes the
+        // local transform of its node and, if the node has meshes, a MeshRendererComponent with Model::GetNodeModel.
+        void InstantiateModel(Entity parent, const std::shared_ptr<Model>& model);
+
+        // Called once per frame before UpdateTransforms. Expands the models of PendingModelComponent entities whose async
+        // load finished into child entities, see InstantiateModel.
+        void UpdatePendingModels();
+
+        // Called once per frame before rendering. Recomputes WorldTransformComponent for the entities tagged dirty and their
+        // descendants and, for those with a MeshRendererComponent, their BoundsComponent and spatial index leaf.
+        // Root subtrees without a dirty entity cost nothing, dirty ones are spread over the thread pool.
+        void UpdateTransforms();
+
+        // Called once per frame while playing. Advances the AnimatorComponents and evaluates their bone palettes.
+        void UpdateAnimations(float dt) { m_AnimationSystem.Update(m_Registry, dt); }
+
+        const AnimationSystem& GetAnimationSystem() const { return m_AnimationSystem; }
+
+        // Nearest renderable entity whose world bounds the ray hits, a null entity if there is none.
+        Entity Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX, float* hitDistance = nullptr);
+
+        const DynamicAABBTree& GetSpatialIndex() const { return m_SpatialIndex; }
+
     public:
         entt::registry m_Registry;
 
     private:
-        uint32_t m_Width = 0, m_Height = 0;
+        // Flattens the parent/child links into depth-first order, see m_HierarchyOrder.
+        void RebuildHierarchy();
+        void Unlink(entt::entity entity);
+
+        void OnRelationshipConstructed(entt::registry& registry, entt::entity entity);
+        void OnRelationshipDestroyed(entt::registry& registry, entt::entity entity);
+        void OnMeshRendererConstructed(entt::registry& registry, entt::entity entity);
+        void OnMeshRendererDestroyed(entt::registry& registry, entt::entity entity);
+        void OnBoundsDestroyed(entt::registry& registry, entt::entity entity);
+        void OnAnimatorChanged(entt::registry& registry, entt::entity entity);
+
+    private:
+        uint32_t        m_Width = 0, m_Height = 0;
+        DynamicAABBTree m_SpatialIndex;
+        AnimationSystem m_AnimationSystem;
+
+        // Every entity in depth-first order: parents come before their children and each root subtree is one contiguous
+        // range, so propagation is a linear pass per subtree. Rebuilt only when the hierarchy changes.
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        bool                      m_HierarchyChanged = true;
+        std::vector<entt::entity> m_HierarchyOrder;
+        std::vector<int32_t>      m_HierarchyParents;  // index of the parent in m_HierarchyOrder, -1 for roots
+        std::vector<uint32_t>     m_HierarchyRoots;    // first index of every root subtree, followed by the total count
+        std::vector<uint32_t>     m_HierarchyIndices;  // position in m_HierarchyOrder by entt::to_entity(entity)
+        std::vector<glm::mat4>    m_HierarchyWorld;    // world matrices in m_HierarchyOrder order
+        std::vector<uint8_t>      m_HierarchyDirty;
+
+        // Scratch of RebuildHierarchy and UpdateTransforms
+        std::vector<std::pair<entt::entity, int32_t>> m_HierarchyStack;
+        std::vector<uint32_t>                         m_DirtySubtrees;
+        std::vector<uint32_t>                         m_DirtyTasks;
 
         friend class Entity;
     };
@@ -1,4 +1,5 @@
 #include "SceneSerilizer.hpp"
+#include "Asset/AssetManager.hpp"
 #include "Scene/Component/Component.hpp"
 #include "Scene/SceneSerilizer.hpp"
 #include "UUID.hpp"
@@ -7,6 +8,7 @@
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <stdint.h>
+#include <unordered_map>
 #include <utility>
 #include <yaml-cpp/emitter.h>
 #include <yaml-cpp/emittermanip.h>
@@ -137,13 +139,22 @@ namespace suplex {
             out << YAML::EndMap;  // TransformComponent
         }
 
+        if (auto parent = entity.GetParent())
+            out << YAML::Key << "Parent" << YAML::Value << parent.GetComponent<IDComponent>().ID;
+
         if (entity.HasComponent<MeshRendererComponent>()) {
             out << YAML::Key << "MeshRendererComponent";
             out << YAML::BeginMap;
 
             auto& mrc = entity.GetComponent<MeshRendererComponent>();
-            out << YAML::Key << "Filepath" << YAML::Value << mrc.m_Model->GetFilePath();
-            out << YAML::Key << "MaterialIndex" << YAML::Value << mrc.m_Model->GetMaterialIndex();
+            // Entities still loading hold the placeholder
+            auto pending = entity.HasComponent<PendingModelComponent>() ? &entity.GetComponent<PendingModelComponent>() : nullptr;
+            out << YAML::Key << "Filepath" << YAML::Value << (pending ? pending->m_FilePath : mrc.m_Model->GetFilePath());
+            out << YAML::Key << "MaterialIndex" << YAML::Value << mrc.m_MaterialIndex;
+            if (pending)
+                out << YAML::Key << "Pending" << YAML::Value << true;
+            else if (mrc.m_Model->GetSourceNode() >= 0)
+                out << YAML::Key << "Node" << YAML::Value << mrc.m_Model->GetSourceNode();
 
             out << YAML::EndMap;
         }
@@ -186,6 +197,9 @@ namespace suplex {
 
         auto entities = data["Entities"];
         if (entities) {
+            // Entities get fresh ids, parents are resolved through the ids stored in the file once all entities exist
+            std::unordered_map<uint64_t, Entity>     entitiesByUUID;
+            std::vector<std::pair<Entity, uint64_t>> parents;
             for (auto entity : entities) {
                 uint64_t uuid = entity["Entity"].as<uint64_t>();
 
@@ -195,6 +209,9 @@ namespace suplex {
                 if (tagComponent) name = tagComponent["Tag"].as<std::string>();
 
                 Entity deserializedEntity = m_Scene->CreateEntity(name);
+                entitiesByUUID[uuid]      = deserializedEntity;
+                if (auto parent = entity["Parent"])
+                    parents.emplace_back(deserializedEntity, parent.as<uint64_t>());
 
                 auto transformComponent = entity["TransformComponent"];
                 if (transformComponent) {
@@ -207,14 +224,31 @@ namespace suplex {
 
                 auto meshRendererComponent = entity["MeshRendererComponent"];
                 if (meshRendererComponent) {
-                    deserializedEntity.AddComponent<MeshRendererComponent>();
-                    auto&       mrc              = deserializedEntity.GetComponent<MeshRendererComponent>();
-                    std::string filepath         = meshRendererComponent["Filepath"].as<std::string>();
-                    mrc.m_Model->m_FilePath      = filepath;
-                    mrc.m_Model->m_MaterialIndex = meshRendererComponent["MaterialIndex"].as<uint32_t>();
-                    mrc.m_Model->LoadModel();
+                    auto filepath      = meshRendererComponent["Filepath"].as<std::string>();
+                    auto materialIndex = meshRendererComponent["MaterialIndex"].as<uint32_t>();
+                    if (meshRendererComponent["Pending"]) {
+                        // Saved before the import finished, expanded into node entities once it does
+                        deserializedEntity.AddComponent<MeshRendererComponent>(AssetManager::GetPlaceholderModel(), materialIndex);
+                        deserializedEntity.AddComponent<PendingModelComponent>(AssetManager::LoadModelAsync(filepath), filepath);
+                    }
+                    else if (auto node = meshRendererComponent["Node"]) {
+                        auto model = Model::GetNodeModel(AssetManager::LoadModel(filepath), node.as<size_t>());
+                        if (!model) {
+                            spdlog::warn("{} has no node {}", filepath, node.as<size_t>());
+                            model = std::make_shared<Model>();
+                        }
+                        deserializedEntity.AddComponent<MeshRendererComponent>(model, materialIndex);
+                    }
+                    else {
+                        deserializedEntity.AddComponent<MeshRendererComponent>(AssetManager::LoadModel(filepath), materialIndex);
+                    }
                 }
             }
+
+            for (auto& [child, parentUUID] : parents) {
+                if (auto parent = entitiesByUUID.find(parentUUID); parent != entitiesByUUID.end())
+                    child.SetParent(parent->second);
+            }
         }
         return true;
     }
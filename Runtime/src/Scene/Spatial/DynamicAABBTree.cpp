@@ -0,0 +1,217 @@
+#include "DynamicAABBTree.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace suplex {
+
+    int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint32_t userData)
+    {
+        auto proxy              = AllocateNode();
+        m_Nodes[proxy].box      = Fatten(box);
+        m_Nodes[proxy].userData = userData;
+        m_Nodes[proxy].height   = 0;
+        InsertLeaf(proxy);
+        ++m_ProxyCount;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int32_t proxy)
+    {
+        assert(m_Nodes[proxy].IsLeaf());
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --m_ProxyCount;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& box)
+    {
+        assert(m_Nodes[proxy].IsLeaf());
+
+        // Still inside the fat box, and the fat box has not become much larger than the new one (e.g. after scaling down)
+        auto& fat    = m_Nodes[proxy].box;
+        auto  margin = glm::vec3(4.0f * m_Margin);
+        if (Contains(fat, box) && Contains({box.min - margin, box.max + margin}, fat))
+            return false;
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].box = Fatten(box);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    int32_t DynamicAABBTree::AllocateNode()
+    {
+        if (m_FreeList == Null) {
+            m_Nodes.emplace_back();
+            return static_cast<int32_t>(m_Nodes.size() - 1);
+        }
+
+        auto nodeID     = m_FreeList;
+        m_FreeList      = m_Nodes[nodeID].parent;
+        m_Nodes[nodeID] = Node();
+        return nodeID;
+    }
+
+    void DynamicAABBTree::FreeNode(int32_t nodeID)
+    {
+        m_Nodes[nodeID]        = Node();
+        m_Nodes[nodeID].parent = m_FreeList;
+        m_FreeList             = nodeID;
+    }
+
+    void DynamicAABBTree::InsertLeaf(int32_t leaf)
+    {
+        if (m_Root == Null) {
+            m_Root               = leaf;
+            m_Nodes[leaf].parent = Null;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest surface area cost
+        auto leafBox = m_Nodes[leaf].box;
+        auto index   = m_Root;
+        while (!m_Nodes[index].IsLeaf()) {
+            auto& node     = m_Nodes[index];
+            float area     = SurfaceArea(node.box);
+            float combined = SurfaceArea(Union(node.box, leafBox));
+
+            // Cost of making a new parent for this node and the leaf, and the minimum cost of pushing the leaf further down
+            float cost        = 2.0f * combined;
+            float inheritance = 2.0f * (combined - area);
+
+            auto childCost = [&](int32_t child) {
+                auto& childBox = m_Nodes[child].box;
+                float newArea  = SurfaceArea(Union(childBox, leafBox));
+                return m_Nodes[child].IsLeaf() ? newArea + inheritance : newArea - SurfaceArea(childBox) + inheritance;
+            };
+
+            float cost1 = childCost(node.child1);
+            float cost2 = childCost(node.child2);
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        // New parent for the sibling and the leaf
+        auto sibling   = index;
+        auto oldParent = m_Nodes[sibling].parent;
+        auto newParent = AllocateNode();
+
+        m_Nodes[newParent].parent = oldParent;
+        m_Nodes[newParent].box    = Union(leafBox, m_Nodes[sibling].box);
+        m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+        m_Nodes[newParent].child1 = sibling;
+        m_Nodes[newParent].child2 = leaf;
+        m_Nodes[sibling].parent   = newParent;
+        m_Nodes[leaf].parent      = newParent;
+
+        if (oldParent == Null)
+            m_Root = newParent;
+        else if (m_Nodes[oldParent].child1 == sibling)
+            m_Nodes[oldParent].child1 = newParent;
+        else
+            m_Nodes[oldParent].child2 = newParent;
+
+        Refit(m_Nodes[leaf].parent);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == m_Root) {
+            m_Root = Null;
+            return;
+        }
+
+        auto parent      = m_Nodes[leaf].parent;
+        auto grandParent = m_Nodes[parent].parent;
+        auto sibling     = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+        // The sibling takes the place of the parent
+        if (grandParent == Null) {
+            m_Root                  = sibling;
+            m_Nodes[sibling].parent = Null;
+            FreeNode(parent);
+            return;
+        }
+
+        if (m_Nodes[grandParent].child1 == parent)
+            m_Nodes[grandParent].child1 = sibling;
+        else
+            m_Nodes[grandParent].child2 = sibling;
+        m_Nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+
+    // Walks up to the root, rebalancing and recomputing boxes and heights.
+    void DynamicAABBTree::Refit(int32_t nodeID)
+    {
+        while (nodeID != Null) {
+            nodeID = Balance(nodeID);
+
+            auto& node   = m_Nodes[nodeID];
+            auto& child1 = m_Nodes[node.child1];
+            auto& child2 = m_Nodes[node.child2];
+            node.height  = 1 + std::max(child1.height, child2.height);
+            node.box     = Union(child1.box, child2.box);
+
+            nodeID = node.parent;
+        }
+    }
+
+    // Rotates the taller grandchild up if the subtree under nodeID is unbalanced, returns the new subtree root.
+    int32_t DynamicAABBTree::Balance(int32_t a)
+    {
+        auto& nodeA = m_Nodes[a];
+        if (nodeA.IsLeaf() || nodeA.height < 2)
+            return a;
+
+        auto b       = nodeA.child1;
+        auto c       = nodeA.child2;
+        auto balance = m_Nodes[c].height - m_Nodes[b].height;
+
+        // rotate(up, down): `up` replaces `a`, `a` takes the place of `up` under its old parent
+        auto rotate = [&](int32_t up, int32_t down) {
+            auto& nodeUp = m_Nodes[up];
+            auto  f      = nodeUp.child1;
+            auto  g      = nodeUp.child2;
+
+            nodeUp.child1     = a;
+            nodeUp.parent     = m_Nodes[a].parent;
+            m_Nodes[a].parent = up;
+
+            if (nodeUp.parent == Null)
+                m_Root = up;
+            else if (m_Nodes[nodeUp.parent].child1 == a)
+                m_Nodes[nodeUp.parent].child1 = up;
+            else
+                m_Nodes[nodeUp.parent].child2 = up;
+
+            // The taller grandchild stays with `up`, the other one replaces `up` under `a`
+            auto keep = m_Nodes[f].height > m_Nodes[g].height ? f : g;
+            auto move = keep == f ? g : f;
+
+            nodeUp.child2        = keep;
+            m_Nodes[move].parent = a;
+            if (m_Nodes[a].child1 == up)
+                m_Nodes[a].child1 = move;
+            else
+                m_Nodes[a].child2 = move;
+
+            m_Nodes[a].box    = Union(m_Nodes[down].box, m_Nodes[move].box);
+            m_Nodes[a].height = 1 + std::max(m_Nodes[down].height, m_Nodes[move].height);
+            nodeUp.box        = Union(m_Nodes[a].box, m_Nodes[keep].box);
+            nodeUp.height     = 1 + std::max(m_Nodes[a].height, m_Nodes[keep].height);
+            return up;
+        };
+
+        if (balance > 1)
+            return rotate(c, b);
+        if (balance < -1)
+            return rotate(b, c);
+        return a;
+    }
+
+}  // namespace suplex
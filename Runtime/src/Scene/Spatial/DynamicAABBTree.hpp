@@ -0,0 +1,215 @@
+#pragma once
+
+#include "Render/Culling/Frustum.hpp"
+#include "Render/Geometry/Bounds.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace suplex {
+
+    // Incrementally maintained bounding volume hierarchy (dynamic AABB tree with fattened leaves and rotations).
+    // Leaves store an enlarged box, so small movements do not touch the tree at all; a leaf is only reinserted
+    // once its tight box leaves the fat one. Every query is O(log n + hits).
+    class DynamicAABBTree {
+    public:
+        static constexpr int32_t Null = -1;
+
+        explicit DynamicAABBTree(float margin = 0.1f) : m_Margin(margin) {}
+
+        int32_t CreateProxy(const AABB& box, uint32_t userData);
+        void    DestroyProxy(int32_t proxy);
+
+        // Returns true if the proxy had to be reinserted.
+        bool MoveProxy(int32_t proxy, const AABB& box);
+
+        uint32_t    GetUserData(int32_t proxy) const { return m_Nodes[proxy].userData; }
+        const AABB& GetFatAABB(int32_t proxy) const { return m_Nodes[proxy].box; }
+
+        int32_t GetHeight() const { return m_Root == Null ? 0 : m_Nodes[m_Root].height; }
+        int32_t GetProxyCount() const { return m_ProxyCount; }
+
+        // callback(uint32_t userData, bool inside) for every leaf whose fat box is inside or crosses the frustum,
+        // inside is true when the leaf was accepted as part of a fully contained subtree.
+        template <class Callback>
+        void QueryFrustum(const Frustum& frustum, Callback&& callback) const
+        {
+            if (m_Root == Null)
+                return;
+
+            auto& stack = m_Stack;
+            stack.clear();
+            stack.push_back({m_Root, false});
+            while (!stack.empty()) {
+                auto [nodeID, inside] = stack.back();
+                stack.pop_back();
+
+                auto& node = m_Nodes[nodeID];
+                if (!inside) {
+                    auto result = frustum.Classify(node.box);
+                    if (result == Frustum::Outside)
+                        continue;
+                    inside = result == Frustum::Inside;
+                }
+
+                // Subtrees fully inside the frustum are reported without further plane tests
+                if (node.IsLeaf())
+                    callback(node.userData, inside);
+                else {
+                    stack.push_back({node.child1, inside});
+                    stack.push_back({node.child2, inside});
+                }
+            }
+        }
+
+        // callback(uint32_t userData) for every leaf whose fat box overlaps the box.
+        template <class Callback>
+        void QueryBox(const AABB& box, Callback&& callback) const
+        {
+            if (m_Root == Null)
+                return;
+
+            auto& stack = m_Stack;
+            stack.clear();
+            stack.push_back({m_Root, false});
+            while (!stack.empty()) {
+                auto nodeID = stack.back().node;
+                stack.pop_back();
+
+                auto& node = m_Nodes[nodeID];
+                if (!Overlaps(node.box, box))
+                    continue;
+
+                if (node.IsLeaf())
+                    callback(node.userData);
+                else {
+                    stack.push_back({node.child1, false});
+                    stack.push_back({node.child2, false});
+                }
+            }
+        }
+
+        // callback(uint32_t userData, float distance) for every leaf hit closer than maxDistance, in no particular order.
+        // The callback returns the new maxDistance, e.g. the exact hit distance to only look for closer leaves afterwards.
+        template <class Callback>
+        void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const
+        {
+            if (m_Root == Null)
+                return;
+
+            auto inverseDirection = 1.0f / direction;
+
+            auto& stack = m_Stack;
+            stack.clear();
+            stack.push_back({m_Root, false});
+            while (!stack.empty()) {
+                auto nodeID = stack.back().node;
+                stack.pop_back();
+
+                auto& node     = m_Nodes[nodeID];
+                float distance = 0.0f;
+                if (!IntersectRay(node.box, origin, inverseDirection, maxDistance, distance))
+                    continue;
+
+                if (node.IsLeaf())
+                    maxDistance = callback(node.userData, distance);
+                else {
+                    stack.push_back({node.child1, false});
+                    stack.push_back({node.child2, false});
+                }
+            }
+        }
+
+        // Slab test, distance is where the ray enters the box (0 if it starts inside). An axis the ray does not move along
+        // (infinite inverse direction) only checks the origin lies between its slabs, 0 * inf would be NaN on a slab plane.
+        static bool IntersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& distance)
+        {
+            float enter = 0.0f;
+            float exit  = maxDistance;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (std::isinf(inverseDirection[axis])) {
+                    if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis])
+                        return false;
+                    continue;
+                }
+
+                float t0 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+                float t1 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+                enter    = std::max(enter, std::min(t0, t1));
+                exit     = std::min(exit, std::max(t0, t1));
+            }
+            distance = enter;
+            return enter <= exit;
+        }
+
+        static bool Overlaps(const AABB& a, const AABB& b)
+        {
+            return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z &&
+                   a.max.z >= b.min.z;
+        }
+
+    private:
+        struct Node
+        {
+            AABB     box;
+            int32_t  parent   = Null;  // next free node while on the free list
+            int32_t  child1   = Null;
+            int32_t  child2   = Null;
+            int32_t  height   = -1;  // leaf = 0, free node = -1
+            uint32_t userData = 0;
+
+            bool IsLeaf() const { return child1 == Null; }
+        };
+
+        struct StackEntry
+        {
+            int32_t node;
+            bool    inside;
+        };
+
+        int32_t AllocateNode();
+        void    FreeNode(int32_t nodeID);
+
+        void    InsertLeaf(int32_t leaf);
+        void    RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t nodeID);
+        void    Refit(int32_t nodeID);
+
+        AABB Fatten(const AABB& box) const
+        {
+            auto margin = glm::vec3(m_Margin);
+            return {box.min - margin, box.max + margin};
+        }
+
+        static float SurfaceArea(const AABB& box)
+        {
+            auto size = box.max - box.min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        static AABB Union(const AABB& a, const AABB& b)
+        {
+            AABB result = a;
+            result.Merge(b);
+            return result;
+        }
+
+        static bool Contains(const AABB& outer, const AABB& inner)
+        {
+            return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && inner.max.x <= outer.max.x &&
+                   inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+        }
+
+    private:
+        std::vector<Node> m_Nodes;
+        int32_t           m_Root       = Null;
+        int32_t           m_FreeList   = Null;
+        int32_t           m_ProxyCount = 0;
+        float             m_Margin     = 0.1f;
+
+        mutable std::vector<StackEntry> m_Stack;
+    };
+
+}  // namespace suplex
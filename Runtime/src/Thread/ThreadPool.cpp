@@ -0,0 +1,143 @@
+#include "Thread/ThreadPool.hpp"
+#include <spdlog/spdlog.h>
+
+namespace suplex {
+
+    std::vector<std::thread>                          ThreadPool::s_Workers;
+    std::deque<std::function<void()>>                 ThreadPool::s_Tasks;
+    std::mutex                                        ThreadPool::s_Mutex;
+    std::condition_variable                           ThreadPool::s_Condition;
+    std::once_flag                                    ThreadPool::s_StartFlag;
+    bool                                              ThreadPool::s_Stopping = false;
+    std::array<ThreadPool::Job*, ThreadPool::MaxJobs> ThreadPool::s_Jobs;
+    size_t                                            ThreadPool::s_JobCount = 0;
+
+    // Defined after the pool state, so it is destroyed first and the workers are joined while the queue still exists
+    struct ThreadPoolShutdown
+    {
+        ~ThreadPoolShutdown()
+        {
+            {
+                std::lock_guard lock(ThreadPool::s_Mutex);
+                ThreadPool::s_Stopping = true;
+            }
+            ThreadPool::s_Condition.notify_all();
+            for (auto& worker : ThreadPool::s_Workers)
+                worker.join();
+        }
+    };
+    static ThreadPoolShutdown s_Shutdown;
+
+    void ThreadPool::Start()
+    {
+        std::call_once(s_StartFlag, []() {
+            auto count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+            for (uint32_t i = 0; i < count; ++i)
+                s_Workers.emplace_back(&ThreadPool::WorkerLoop);
+            spdlog::info("Thread pool started with {} workers", count);
+        });
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task)
+    {
+        Start();
+        {
+            std::lock_guard lock(s_Mutex);
+            s_Tasks.push_back(std::move(task));
+        }
+        s_Condition.notify_one();
+    }
+
+    bool ThreadPool::Publish(Job& job)
+    {
+        Start();
+        {
+            std::lock_guard lock(s_Mutex);
+            if (s_JobCount == MaxJobs)
+                return false;
+            s_Jobs[s_JobCount++] = &job;
+        }
+        s_Condition.notify_all();
+        return true;
+    }
+
+    void ThreadPool::Retract(Job& job)
+    {
+        std::lock_guard lock(s_Mutex);
+        auto            last = s_Jobs.begin() + s_JobCount;
+        auto            iter = std::find(s_Jobs.begin(), last, &job);
+        std::copy(iter + 1, last, iter);
+        --s_JobCount;
+    }
+
+    void ThreadPool::RunChunks(Job& job)
+    {
+        for (size_t chunk; (chunk = job.next.fetch_add(1)) < job.chunkCount;) {
+            size_t begin = chunk * job.chunkSize;
+            job.invoke(job.function, begin, std::min(begin + job.chunkSize, job.count));
+            job.done.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    ThreadPool::Job* ThreadPool::ClaimJob()
+    {
+        // Newest first, nested calls finish before the ones waiting on them
+        for (size_t i = s_JobCount; i-- > 0;) {
+            if (s_Jobs[i]->HasChunks()) {
+                s_Jobs[i]->helpers.fetch_add(1, std::memory_order_relaxed);
+                return s_Jobs[i];
+            }
+        }
+        return nullptr;
+    }
+
+    bool ThreadPool::HasWork()
+    {
+        if (!s_Tasks.empty())
+            return true;
+        for (size_t i = 0; i < s_JobCount; ++i) {
+            if (s_Jobs[i]->HasChunks())
+                return true;
+        }
+        return false;
+    }
+
+    bool ThreadPool::TryRunOne()
+    {
+        std::function<void()> task;
+        Job*                  job = nullptr;
+        {
+            std::lock_guard lock(s_Mutex);
+            job = ClaimJob();
+            if (!job) {
+                if (s_Tasks.empty())
+                    return false;
+                task = std::move(s_Tasks.front());
+                s_Tasks.pop_front();
+            }
+        }
+
+        if (job) {
+            RunChunks(*job);
+            job->helpers.fetch_sub(1, std::memory_order_release);
+        }
+        else {
+            task();
+        }
+        return true;
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true) {
+            {
+                std::unique_lock lock(s_Mutex);
+                s_Condition.wait(lock, []() { return s_Stopping || HasWork(); });
+                if (s_Stopping && !HasWork())
+                    return;
+            }
+            TryRunOne();
+        }
+    }
+
+}  // namespace suplex
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace suplex {
+
+    // Process wide worker threads (hardware concurrency - 1), started on first use and joined at exit.
+    // Submit() is for fire-and-forget jobs, ParallelFor() splits a range and also runs chunks on the calling thread.
+    // ParallelFor does not allocate: its job lives on the caller's stack and is published in a fixed table the
+    // workers claim chunks from, so per-frame systems can use it in steady state.
+    class ThreadPool {
+    public:
+        static uint32_t GetWorkerCount()
+        {
+            Start();
+            return static_cast<uint32_t>(s_Workers.size());
+        }
+
+        template <class Function>
+        static auto Submit(Function&& function) -> std::future<std::invoke_result_t<std::decay_t<Function>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<Function>>;
+
+            auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            auto future = task->get_future();
+            Enqueue([task]() { (*task)(); });
+            return future;
+        }
+
+        // function(size_t begin, size_t end) over [0, count) in chunks of at least grainSize, returns once every chunk ran.
+        // Small ranges run inline. Chunks must not depend on each other, nested calls are fine.
+        template <class Function>
+        static void ParallelFor(size_t count, size_t grainSize, Function&& function)
+        {
+            grainSize = std::max<size_t>(grainSize, 1);
+            if (count == 0)
+                return;
+
+            size_t chunkCount = std::min<size_t>((count + grainSize - 1) / grainSize, GetWorkerCount() + 1);
+            if (chunkCount <= 1) {
+                function(size_t(0), count);
+                return;
+            }
+
+            // Rounding the size up can leave trailing chunks empty (5 items in 4 chunks of 2), so the count follows the size
+            Job job;
+            job.function   = const_cast<void*>(static_cast<const void*>(std::addressof(function)));
+            job.invoke     = [](void* function, size_t begin, size_t end) {
+                (*static_cast<std::remove_reference_t<Function>*>(function))(begin, end);
+            };
+            job.count      = count;
+            job.chunkSize  = (count + chunkCount - 1) / chunkCount;
+            job.chunkCount = (count + job.chunkSize - 1) / job.chunkSize;
+
+            // A full table (deeply nested calls on every thread) leaves the whole range to this thread
+            bool published = Publish(job);
+            RunChunks(job);
+            if (published)
+                Retract(job);
+
+            // Help with queued work instead of blocking, a worker may be waiting on us in a nested call
+            while (job.done.load(std::memory_order_acquire) < job.chunkCount || job.helpers.load(std::memory_order_acquire) > 0) {
+                if (!TryRunOne())
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        // A ParallelFor in flight. Helpers register under the pool mutex while the job is published and the caller waits
+        // for them to leave after retracting it, so the job can live on the caller's stack.
+        struct Job
+        {
+            using Invoke = void (*)(void* function, size_t begin, size_t end);
+
+            Invoke                invoke     = nullptr;
+            void*                 function   = nullptr;
+            size_t                count      = 0;
+            size_t                chunkSize  = 0;
+            size_t                chunkCount = 0;
+            std::atomic<size_t>   next{0};
+            std::atomic<size_t>   done{0};
+            std::atomic<uint32_t> helpers{0};
+
+            bool HasChunks() const { return next.load(std::memory_order_relaxed) < chunkCount; }
+        };
+
+        // Jobs published at once, one per thread and nesting level
+        static constexpr size_t MaxJobs = 64;
+
+        static void Start();
+        static void Enqueue(std::function<void()> task);
+        static bool TryRunOne();
+        static void WorkerLoop();
+
+        static bool Publish(Job& job);
+        static void Retract(Job& job);
+        static void RunChunks(Job& job);
+        static Job* ClaimJob();  // expects s_Mutex held, registers as a helper
+        static bool HasWork();   // expects s_Mutex held
+
+        friend struct ThreadPoolShutdown;
+
+    private:
+        static std::vector<std::thread>          s_Workers;
+        static std::deque<std::function<void()>> s_Tasks;
+        static std::mutex                        s_Mutex;
+        static std::condition_variable           s_Condition;
+        static std::once_flag                    s_StartFlag;
+        static bool                              s_Stopping;
+        static std::array<Job*, MaxJobs>         s_Jobs;
+        static size_t                            s_JobCount;
+    };
+
+}  // namespace suplex
@@ -194,6 +194,532 @@
 // // ----------------------------------------------------------------------
 // // void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) { camera.ProcessMouseScroll(yoffset); }
 
-#include <iostream>
-
-int main() {}
\ No newline at end of file
+#include "Animation/Animator/Animator.hpp"
+#include "Render/Geometry/MeshCache.hpp"
+#include "Render/Geometry/Model.hpp"
+#include "Render/RenderQueue/RenderQueue.hpp"
+#include "Render/Texture/BlockCompression.hpp"
+#include "Scene/Entity/Entity.hpp"
+#include "Scene/Scene.hpp"
+#include "Thread/ThreadPool.hpp"
+#include "Time/Timer.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <memory>
+#include <new>
+#include <random>
+#include <spdlog/spdlog.h>
+
+using namespace suplex;
+
+// Every heap allocation of the process, so benchmarks can check that their steady state frames make none
+static std::atomic<size_t> s_Allocations{0};
+
+void* operator new(size_t size)
+{
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+// The benchmarks that touch GL render into a hidden window, nullptr if no 4.6 context is available.
+static GLFWwindow* CreateHiddenWindow(int width, int height)
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(width, height, "Sandbox", nullptr, nullptr);
+    if (!window) {
+        spdlog::error("Failed to create GLFW window");
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    return window;
+}
+
+// Mesh cache benchmark: Sandbox <model file> [warm loads]
+// Times an Assimp import with the cache entry removed (cold) against loads served from the cache (warm).
+static int RunMeshCacheBenchmark(const std::string& path, int warmLoads)
+{
+    // Meshes upload on construction, so a hidden window provides the context
+    GLFWwindow* window = CreateHiddenWindow(64, 64);
+    if (!window)
+        return -1;
+    spdlog::set_level(spdlog::level::warn);
+
+    std::error_code error;
+    std::filesystem::remove(MeshCache::GetPath(MeshCache::GetKey(path, Model::ImportFlags)), error);
+
+    // Every load gives its textures back to the TextureCache, otherwise warm loads would skip the texture decode
+    // the cold one paid for. The release is not timed
+    auto load = [&]() {
+        Walnut::Timer timer;
+        Model         model(path);
+        glFinish();
+        float elapsed = timer.ElapsedMillis();
+        model.Release();
+        return elapsed;
+    };
+    float cold = load();
+
+    float best = FLT_MAX, total = 0.0f;
+    for (int i = 0; i < warmLoads; ++i) {
+        float elapsed = load();
+        best          = std::min(best, elapsed);
+        total += elapsed;
+    }
+
+    spdlog::set_level(spdlog::level::info);
+    spdlog::info("{}: cold {:.2f} ms, warm {:.2f} ms average / {:.2f} ms best over {} loads ({:.1f}x)", path, cold, total / warmLoads, best,
+                 warmLoads, cold / (total / warmLoads));
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
+
+// Procedural rig of boneCount nodes, each animated by a channel of keyCount keys one tick apart. Node i hangs
+// below node (i - 1) / 2, so the hierarchy is about log2(boneCount) deep. The Assimp destructors free the children.
+static std::shared_ptr<Animation> MakeSkeletonAnimation(int                            boneCount,
+                                                        int                            keyCount,
+                                                        Model&                         model,
+                                                        const ClipCompressionSettings& compression)
+{
+    std::mt19937                          random(boneCount);
+    std::uniform_real_distribution<float> angle(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+
+    std::vector<aiNode*> nodes(boneCount);
+    std::vector<int>     childCounts(boneCount, 0);
+    for (int i = 0; i < boneCount; ++i) {
+        nodes[i]                  = new aiNode("bone" + std::to_string(i));
+        nodes[i]->mTransformation = aiMatrix4x4(aiVector3D(1.0f), aiQuaternion(), aiVector3D(0.0f, 1.0f, 0.0f));
+        if (i > 0)
+            ++childCounts[(i - 1) / 2];
+    }
+    for (int i = 0; i < boneCount; ++i) {
+        if (childCounts[i] > 0)
+            nodes[i]->mChildren = new aiNode*[childCounts[i]];
+    }
+    for (int i = 1; i < boneCount; ++i) {
+        auto parent       = nodes[(i - 1) / 2];
+        nodes[i]->mParent = parent;
+        parent->mChildren[parent->mNumChildren++] = nodes[i];
+    }
+
+    auto clip             = std::make_unique<aiAnimation>();
+    clip->mDuration       = keyCount - 1;
+    clip->mTicksPerSecond = 30.0;
+    clip->mNumChannels    = boneCount;
+    clip->mChannels       = new aiNodeAnim*[boneCount];
+    for (int i = 0; i < boneCount; ++i) {
+        auto channel              = new aiNodeAnim();
+        channel->mNodeName        = nodes[i]->mName;
+        channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = keyCount;
+        channel->mPositionKeys    = new aiVectorKey[keyCount];
+        channel->mRotationKeys    = new aiQuatKey[keyCount];
+        channel->mScalingKeys     = new aiVectorKey[keyCount];
+        // Smooth swings with a random phase and amplitude per bone, like baked motion capture
+        aiVector3D amplitude(angle(random), angle(random), angle(random));
+        aiVector3D offset(phase(random), phase(random), phase(random));
+        for (int k = 0; k < keyCount; ++k) {
+            float      t = 6.2831853f * k / (keyCount - 1);
+            aiVector3D swing(amplitude.x * std::sin(t + offset.x),
+                             amplitude.y * std::sin(t + offset.y),
+                             amplitude.z * std::sin(t + offset.z));
+            channel->mPositionKeys[k] = aiVectorKey(k, aiVector3D(0.0f, 1.0f + 0.1f * swing.x, 0.0f));
+            channel->mRotationKeys[k] = aiQuatKey(k, aiQuaternion(swing.x, swing.y, swing.z));
+            channel->mScalingKeys[k]  = aiVectorKey(k, aiVector3D(1.0f));
+        }
+        clip->mChannels[i] = channel;
+    }
+
+    auto animation = std::make_shared<Animation>(clip.get(), nodes[0], model, compression);
+    delete nodes[0];
+    return animation;
+}
+
+// Skeleton benchmark: Sandbox skeleton [updates]
+// Times Animator::UpdateAnimation, sampling every channel and building the final bone matrices, for rigs of 50, 100 and
+// 250 bones at a 60 Hz step, once from the raw keys and once from the compressed clip.
+static int RunSkeletonBenchmark(int updates)
+{
+    for (int boneCount : {50, 100, 250}) {
+        for (bool compressed : {false, true}) {
+            ClipCompressionSettings compression;
+            compression.enabled = compressed;
+
+            Model    model;
+            auto     animation = MakeSkeletonAnimation(boneCount, 60, model, compression);
+            Animator animator(animation);
+            for (int i = 0; i < 60; ++i)
+                animator.UpdateAnimation(1.0f / 60.0f);
+
+            Walnut::Timer timer;
+            for (int i = 0; i < updates; ++i)
+                animator.UpdateAnimation(1.0f / 60.0f);
+            float elapsed = timer.ElapsedMillis();
+
+            spdlog::info("{} bones, {}: {:.2f} us per skeleton over {} updates", boneCount, compressed ? "compressed" : "raw keys",
+                         elapsed * 1000.0f / updates, updates);
+        }
+    }
+    return 0;
+}
+
+// Crowd benchmark: Sandbox characters [count] [frames]
+// Times Scene::UpdateAnimations for count entities with an AnimatorComponent, four 65 bone clips shared between them,
+// stepped at 60 Hz. Reports the average and worst frame against the 16.67 ms budget, and fails if the timed frames
+// allocated anything.
+static int RunCrowdBenchmark(int characterCount, int frames)
+{
+    constexpr int   ClipCount  = 4;
+    constexpr float FrameTime  = 1.0f / 60.0f;
+    constexpr float BudgetTime = FrameTime * 1000.0f;
+
+    std::vector<std::unique_ptr<Model>>     models;
+    std::vector<std::shared_ptr<Animation>> clips;
+    for (int i = 0; i < ClipCount; ++i) {
+        models.push_back(std::make_unique<Model>());
+        clips.push_back(MakeSkeletonAnimation(65 + i, 60, *models.back(), ClipCompressionSettings()));
+    }
+
+    std::mt19937                          random(characterCount);
+    std::uniform_real_distribution<float> startTime(0.0f, 59.0f);
+
+    Scene scene;
+    for (int i = 0; i < characterCount; ++i) {
+        auto entity = scene.CreateEntity("Character" + std::to_string(i));
+        entity.AddComponent<AnimatorComponent>(clips[i % ClipCount]);
+        entity.GetComponent<AnimatorComponent>().m_Time = startTime(random);
+    }
+
+    for (int i = 0; i < 60; ++i)
+        scene.UpdateAnimations(FrameTime);
+
+    float total = 0.0f, worst = 0.0f;
+
+    auto allocations = s_Allocations.load();
+    for (int i = 0; i < frames; ++i) {
+        Walnut::Timer timer;
+        scene.UpdateAnimations(FrameTime);
+        float elapsed = timer.ElapsedMillis();
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+    }
+    allocations = s_Allocations.load() - allocations;
+
+    auto& system = scene.GetAnimationSystem();
+    spdlog::info("{} characters, {} palette matrices, {} threads: {:.3f} ms average, {:.3f} ms worst per frame over {} frames ({:.1f}% "
+                 "of the 60 Hz budget)",
+                 system.GetInstanceCount(), system.GetPalette().size(), ThreadPool::GetWorkerCount() + 1, total / frames, worst, frames,
+                 total / frames / BudgetTime * 100.0f);
+
+    if (allocations > 0) {
+        spdlog::error("{} heap allocations over {} frames, steady state updates must not allocate", allocations, frames);
+        return 1;
+    }
+    return 0;
+}
+
+// Axis aligned box of 8 vertices around the origin, normals are left zero since only depth is drawn.
+static Mesh MakeBox(const glm::vec3& halfExtent)
+{
+    std::vector<Vertex> vertices(8);
+    for (int i = 0; i < 8; ++i)
+        vertices[i].position = halfExtent * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+
+    std::vector<uint32_t> indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                                     2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+    return Mesh(std::move(vertices), std::move(indices), {});
+}
+
+// Draw submission benchmark: Sandbox draws [meshes] [frames]
+// Fills, sorts and submits a RenderQueue of meshCount distinct boxes through the depth shader, once with a VAO bind and
+// draw per mesh (Submit) and once from the GeometryPool with glMultiDrawElementsIndirect (SubmitIndirect). Reports the
+// CPU time of a frame, the GPU is waited for outside the timer, and the draw calls it took.
+static int RunDrawBenchmark(int meshCount, int frames)
+{
+    constexpr float FarClip = 500.0f;
+
+    GLFWwindow* window = CreateHiddenWindow(1280, 720);
+    if (!window)
+        return -1;
+
+    // Different proportions per box, so no two meshes could share an instanced draw
+    std::mt19937                          random(meshCount);
+    std::uniform_real_distribution<float> extent(0.2f, 0.5f);
+
+    std::vector<Mesh>      meshes;
+    std::vector<glm::mat4> transforms;
+    meshes.reserve(meshCount);
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(meshCount))));
+    for (int i = 0; i < meshCount; ++i) {
+        meshes.push_back(MakeBox(glm::vec3(extent(random), extent(random), extent(random))));
+        auto position = glm::vec3(i % columns - columns * 0.5f, 0.0f, -(i / columns) - 2.0f) * 1.5f;
+        transforms.push_back(glm::translate(glm::mat4(1.0f), position));
+    }
+
+    // Both paths upload up front, so the timed frames only submit
+    for (auto& mesh : meshes) {
+        mesh.GetVAO();
+        mesh.GetPoolAllocation();
+    }
+
+    auto eye     = glm::vec3(0.0f, 40.0f, 20.0f);
+    auto view    = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, -columns * 0.75f), glm::vec3(0.0f, 1.0f, 0.0f));
+    auto proj    = glm::perspective(glm::radians(60.0f), 1280.0f / 720.0f, 0.1f, FarClip);
+    auto shaders = std::vector<std::shared_ptr<Shader>>{std::make_shared<Shader>("depth.vert", "depth.frag")};
+    auto& shader = shaders[0];
+    shader->Bind();
+    shader->Set(shader->GetUniform<glm::mat4>("viewLS"), view);
+    shader->Set(shader->GetUniform<glm::mat4>("projLS"), proj);
+    shader->Set(shader->GetUniform<float>("farClip"), FarClip);
+    shader->Set(shader->GetUniform<float>("nearClip"), 0.1f);
+
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, 1280, 720);
+
+    ObjectUniformBuffer objects;
+    RenderQueue         queue;
+    RenderStats         stats;
+
+    auto drawFrame = [&](bool indirect) {
+        RHI::NewFrame();
+        InstanceBuffer::NewFrame();
+        GeometryPool::NewFrame();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        objects.Begin();
+        auto slot = objects.Push(ObjectUniforms());
+        objects.Upload();
+
+        queue.Clear();
+        for (int i = 0; i < meshCount; ++i) {
+            InstanceData instance;
+            instance.model = transforms[i];
+
+            DrawItem item;
+            item.mesh          = &meshes[i];
+            item.objectSlot    = slot;
+            item.firstInstance = InstanceBuffer::Push(instance);
+            queue.Push(item, glm::length(glm::vec3(transforms[i][3]) - eye) / FarClip);
+        }
+        InstanceBuffer::Upload();
+        queue.Sort();
+
+        if (indirect)
+            queue.SubmitIndirect(shaders, objects, 0, stats, [](RenderQueuePass) {});
+        else
+            queue.Submit(shaders, objects, 0, stats, [](RenderQueuePass) {});
+    };
+
+    for (bool indirect : {false, true}) {
+        for (int i = 0; i < 10; ++i)
+            drawFrame(indirect);
+        glFinish();
+
+        float total = 0.0f, worst = 0.0f;
+        for (int i = 0; i < frames; ++i) {
+            stats.Reset();
+            Walnut::Timer timer;
+            drawFrame(indirect);
+            float elapsed = timer.ElapsedMillis();
+            glFinish();
+            total += elapsed;
+            worst = std::max(worst, elapsed);
+        }
+
+        spdlog::info("{} meshes, {}: {:.3f} ms average, {:.3f} ms worst CPU per frame over {} frames, {} draw calls, {} VAO binds",
+                     meshCount, indirect ? "multi draw indirect" : "per mesh draws", total / frames, worst, frames, stats.drawCalls,
+                     stats.vertexArrayBinds);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
+
+// Reference decoder for the only BC6H mode Compress writes (mode 11: one region, 10 bit endpoints, 4 bit indices),
+// false for any other mode.
+static bool DecodeBC6HBlock(const uint8_t* block, uint16_t texels[16][3])
+{
+    constexpr int Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    int  position = 0;
+    auto read     = [&](int count) {
+        int value = 0;
+        for (int i = 0; i < count; ++i, ++position)
+            value |= (block[position >> 3] >> (position & 7) & 1) << i;
+        return value;
+    };
+    if (read(5) != 0x03)
+        return false;
+
+    int endpoints[2][3];
+    for (auto& endpoint : endpoints) {
+        for (int c = 0; c < 3; ++c) {
+            int value   = read(10);
+            endpoint[c] = value == 0 ? 0 : value == 1023 ? 0xffff : ((value << 16) + 0x8000) >> 10;
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        int weight = Weights[read(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 3; ++c) {
+            int value    = ((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6;
+            texels[i][c] = static_cast<uint16_t>((value * 31) >> 6);
+        }
+    }
+    return true;
+}
+
+// BC6H check: Sandbox bc6h
+// Encodes a fixed HDR sky (a gradient over four stops with a sun disc) with its mips to BC6H twice. Fails unless both
+// results are byte identical and the decoded level 0 stays within the relative error bounds of the source.
+static int RunBC6HCheck()
+{
+    constexpr int   Size             = 256;
+    constexpr float MaxMeanError     = 1.0f / 64.0f;
+    constexpr float MaxTexelError    = 1.0f / 8.0f;
+    constexpr float SmallestRadiance = 1.0f / 64.0f;  // relative errors below it are measured against it
+
+    TextureImage image;
+    image.channels = 3;
+    image.Allocate(Size, Size, PixelFormat::RGB16F);
+    auto source = reinterpret_cast<uint16_t*>(image.GetLevel(0));
+    for (int y = 0; y < Size; ++y) {
+        for (int x = 0; x < Size; ++x) {
+            float height    = static_cast<float>(y) / (Size - 1);
+            float intensity = std::exp2(4.0f * height - 2.0f + 0.5f * std::sin(x * 0.05f));
+            float sunX = x - Size * 0.6f, sunY = y - Size * 0.3f;
+            if (sunX * sunX + sunY * sunY < Size * Size / 256.0f)
+                intensity = 5000.0f;
+
+            float rgb[3] = {0.9f - 0.6f * height, 0.8f - 0.3f * height, 0.7f + 0.3f * height};
+            for (int c = 0; c < 3; ++c)
+                source[(y * Size + x) * 3 + c] = FloatToHalf(rgb[c] * intensity);
+        }
+    }
+    GenerateMips(image, ColorSpace::Linear);
+
+    Walnut::Timer timer;
+    auto          first   = Compress(image, PixelFormat::BC6H);
+    float         elapsed = timer.ElapsedMillis();
+    auto          second  = Compress(image, PixelFormat::BC6H);
+    if (first.format != PixelFormat::BC6H || first.pixels != second.pixels) {
+        spdlog::error("BC6H encoding is not deterministic");
+        return 1;
+    }
+
+    double totalError = 0.0, worstError = 0.0;
+    int    blocksX    = Size / 4;
+    for (int block = 0; block < blocksX * blocksX; ++block) {
+        uint16_t texels[16][3];
+        if (!DecodeBC6HBlock(first.GetLevel(0) + block * 16, texels)) {
+            spdlog::error("BC6H block {} uses an unexpected mode", block);
+            return 1;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int x = block % blocksX * 4 + i % 4, y = block / blocksX * 4 + i / 4;
+            for (int c = 0; c < 3; ++c) {
+                float expected = HalfToFloat(source[(y * Size + x) * 3 + c]);
+                float error    = std::abs(HalfToFloat(texels[i][c]) - expected) / std::max(expected, SmallestRadiance);
+                totalError += error;
+                worstError = std::max<double>(worstError, error);
+            }
+        }
+    }
+
+    double meanError = totalError / (Size * Size * 3);
+    spdlog::info("BC6H {}x{} with mips: {:.2f} ms, {} bytes, relative error {:.4f} mean / {:.4f} worst", Size, Size, elapsed,
+                 first.GetSize(), meanError, worstError);
+    if (meanError > MaxMeanError || worstError > MaxTexelError) {
+        spdlog::error("BC6H error above the bounds ({:.4f} mean / {:.4f} per texel)", MaxMeanError, MaxTexelError);
+        return 1;
+    }
+    return 0;
+}
+
+// Raycast check: Sandbox raycast
+// Axis aligned rays grazing the faces and edges of a box, the ray does not move along the other axes and starts on their
+// slab planes. Fails if Scene::Raycast misses one, reports a wrong distance or hits the box with a ray passing just outside.
+static int RunRaycastCheck()
+{
+    struct Ray
+    {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        float     distance;  // negative for a miss
+    };
+
+    const Ray rays[] = {
+        {{-5.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 4.0f},      // along the top face
+        {{-5.0f, -1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, 4.0f},     // along an edge
+        {{0.0f, 5.0f, 1.0f}, {0.0f, -1.0f, 0.0f}, 4.0f},      // along the front face, downwards
+        {{5.0f, 1.0f, -1.0f}, {-1.0f, -0.0f, 0.0f}, 4.0f},    // negative zero direction components
+        {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 0.0f},      // starting on the top face
+        {{-5.0f, 1.001f, 0.0f}, {1.0f, 0.0f, 0.0f}, -1.0f},   // just above the top face
+        {{-5.0f, 0.0f, -1.001f}, {1.0f, 0.0f, 0.0f}, -1.0f},  // just behind the back face
+    };
+
+    std::vector<Mesh> meshes;
+    meshes.push_back(MakeBox(glm::vec3(1.0f)));
+
+    Scene scene;
+    auto  box = scene.CreateEntity("Box");
+    box.AddComponent<MeshRendererComponent>(std::make_shared<Model>(std::move(meshes)));
+    scene.UpdateTransforms();
+
+    int failures = 0;
+    for (auto& ray : rays) {
+        float distance = -1.0f;
+        auto  hit      = scene.Raycast(ray.origin, ray.direction, FLT_MAX, &distance);
+        bool  expected = ray.distance >= 0.0f;
+        if (static_cast<bool>(hit) != expected || (expected && std::abs(distance - ray.distance) > 1e-4f)) {
+            spdlog::error("Ray from ({}, {}, {}) along ({}, {}, {}): {} at {}, expected {} at {}", ray.origin.x, ray.origin.y,
+                          ray.origin.z, ray.direction.x, ray.direction.y, ray.direction.z, hit ? "hit" : "miss", distance,
+                          expected ? "hit" : "miss", ray.distance);
+            ++failures;
+        }
+    }
+
+    spdlog::info("{} of {} grazing rays correct", std::size(rays) - failures, std::size(rays));
+    return failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        spdlog::info("Usage: Sandbox <model file> [warm loads] | Sandbox skeleton [updates] | Sandbox characters [count] [frames] | "
+                     "Sandbox draws [meshes] [frames] | Sandbox bc6h | Sandbox raycast");
+        return 0;
+    }
+
+    if (std::strcmp(argv[1], "skeleton") == 0)
+        return RunSkeletonBenchmark(argc > 2 ? std::max(1, std::atoi(argv[2])) : 10000);
+    if (std::strcmp(argv[1], "characters") == 0)
+        return RunCrowdBenchmark(argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000, argc > 3 ? std::max(1, std::atoi(argv[3])) : 600);
+    if (std::strcmp(argv[1], "draws") == 0)
+        return RunDrawBenchmark(argc > 2 ? std::max(1, std::atoi(argv[2])) : 10000, argc > 3 ? std::max(1, std::atoi(argv[3])) : 300);
+    if (std::strcmp(argv[1], "bc6h") == 0)
+        return RunBC6HCheck();
+    if (std::strcmp(argv[1], "raycast") == 0)
+        return RunRaycastCheck();
+    return RunMeshCacheBenchmark(argv[1], argc > 2 ? std::max(1, std::atoi(argv[2])) : 10);
+}